@@ -109,6 +109,7 @@ enum
 #define DEFAULT_BLACK_SENSITIVITY 100
 #define DEFAULT_WHITE_SENSITIVITY 100
 #define DEFAULT_PREFER_PASSTHROUGH FALSE
+#define DEFAULT_N_THREADS 1
 
 enum
 {
@@ -122,7 +123,8 @@ enum
   PROP_NOISE_LEVEL,
   PROP_BLACK_SENSITIVITY,
   PROP_WHITE_SENSITIVITY,
-  PROP_PREFER_PASSTHROUGH
+  PROP_PREFER_PASSTHROUGH,
+  PROP_N_THREADS
 };
 
 static GstStaticPadTemplate gst_alpha_src_template =
@@ -267,6 +269,20 @@ gst_alpha_class_init (GstAlphaClass * klass)
           DEFAULT_PREFER_PASSTHROUGH,
           G_PARAM_READWRITE | GST_PARAM_CONTROLLABLE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstAlpha:n-threads:
+   *
+   * Maximum number of threads to use. Frames are split into horizontal
+   * bands that are processed in parallel, with the same result as with a
+   * single thread. 0 uses one thread per CPU.
+   *
+   * Since: 1.18
+   */
+  g_object_class_install_property (G_OBJECT_CLASS (klass),
+      PROP_N_THREADS, g_param_spec_uint ("n-threads", "Threads",
+          "Maximum number of threads to use", 0, G_MAXUINT,
+          DEFAULT_N_THREADS, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gst_element_class_set_static_metadata (gstelement_class, "Alpha filter",
       "Filter/Effect/Video",
       "Adds an alpha channel to video - uniform or via chroma-keying",
@@ -302,6 +318,7 @@ gst_alpha_init (GstAlpha * alpha)
   alpha->noise_level = DEFAULT_NOISE_LEVEL;
   alpha->black_sensitivity = DEFAULT_BLACK_SENSITIVITY;
   alpha->white_sensitivity = DEFAULT_WHITE_SENSITIVITY;
+  alpha->n_threads = DEFAULT_N_THREADS;
 
   g_mutex_init (&alpha->lock);
 }
@@ -311,6 +328,9 @@ gst_alpha_finalize (GObject * object)
 {
   GstAlpha *alpha = GST_ALPHA (object);
 
+  if (alpha->pool)
+    g_thread_pool_free (alpha->pool, FALSE, TRUE);
+  g_free (alpha->chroma_table);
   g_mutex_clear (&alpha->lock);
 
   G_OBJECT_CLASS (parent_class)->finalize (object);
@@ -379,6 +399,9 @@ gst_alpha_set_property (GObject * object, guint prop_id,
       alpha->prefer_passthrough = prefer_passthrough;
       break;
     }
+    case PROP_N_THREADS:
+      alpha->n_threads = g_value_get_uint (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -427,6 +450,9 @@ gst_alpha_get_property (GObject * object, guint prop_id, GValue * value,
     case PROP_PREFER_PASSTHROUGH:
       g_value_set_boolean (value, alpha->prefer_passthrough);
       break;
+    case PROP_N_THREADS:
+      g_value_set_uint (value, alpha->n_threads);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -619,6 +645,61 @@ chroma_keying_yuv (gint a, gint * y, gint * u,
   return b_alpha;
 }
 
+/* Apart from the brightness check, the outcome of chroma_keying_yuv() only
+ * depends on U and V: the alpha is scaled and Y lowered by amounts that
+ * depend on them. This precomputes them for all U/V pairs.
+ * Protected with the alpha lock */
+static void
+gst_alpha_build_chroma_table (GstAlpha * alpha)
+{
+  gint u, v;
+
+  if (alpha->chroma_table == NULL)
+    alpha->chroma_table = g_new (GstAlphaChromaKey, 256 * 256);
+
+  for (v = -128; v < 128; v++) {
+    for (u = -128; u < 128; u++) {
+      GstAlphaChromaKey *key = &alpha->chroma_table[((v + 128) << 8) + u + 128];
+      gint ky = 255, ku = u, kv = v;
+
+      key->alpha = chroma_keying_yuv (256, &ky, &ku, &kv, alpha->cr, alpha->cb,
+          0, 255, alpha->accept_angle_tg, alpha->accept_angle_ctg,
+          alpha->one_over_kc, alpha->kfgy_scale, alpha->kg,
+          alpha->noise_level2);
+      key->y_sub = 255 - ky;
+      key->u = ku;
+      key->v = kv;
+    }
+  }
+
+  alpha->chroma_table_valid = TRUE;
+}
+
+/* Same as chroma_keying_yuv() with the current parameters, using the table */
+static inline gint
+chroma_keying_table (GstAlpha * alpha, gint a, gint * y, gint * u, gint * v,
+    gint smin, gint smax)
+{
+  const GstAlphaChromaKey *key;
+
+  /* too dark or too bright, keep alpha */
+  if (*y < smin || *y > smax)
+    return a;
+
+  /* Colorimetry conversions can leave the table's range */
+  if (G_UNLIKELY ((guint) (*u + 128) > 255 || (guint) (*v + 128) > 255))
+    return chroma_keying_yuv (a, y, u, v, alpha->cr, alpha->cb, smin, smax,
+        alpha->accept_angle_tg, alpha->accept_angle_ctg, alpha->one_over_kc,
+        alpha->kfgy_scale, alpha->kg, alpha->noise_level2);
+
+  key = &alpha->chroma_table[((*v + 128) << 8) + *u + 128];
+  *y = (*y < key->y_sub) ? 0 : *y - key->y_sub;
+  *u = key->u;
+  *v = key->v;
+
+  return (a * key->alpha) >> 8;
+}
+
 #define APPLY_MATRIX(m,o,v1,v2,v3) ((m[o*4] * v1 + m[o*4+1] * v2 + m[o*4+2] * v3 + m[o*4+3]) >> 8)
 
 static void
@@ -679,13 +760,6 @@ gst_alpha_chroma_key_argb_ayuv (const GstVideoFrame * in_frame,
   gint r, g, b;
   gint smin, smax;
   gint pa = CLAMP ((gint) (alpha->alpha * 256), 0, 256);
-  gint8 cb = alpha->cb, cr = alpha->cr;
-  gint8 kg = alpha->kg;
-  guint8 accept_angle_tg = alpha->accept_angle_tg;
-  guint8 accept_angle_ctg = alpha->accept_angle_ctg;
-  guint8 one_over_kc = alpha->one_over_kc;
-  guint8 kfgy_scale = alpha->kfgy_scale;
-  guint noise_level2 = alpha->noise_level2;
   gint matrix[12];
   gint o[4];
 
@@ -718,9 +792,7 @@ gst_alpha_chroma_key_argb_ayuv (const GstVideoFrame * in_frame,
       u = APPLY_MATRIX (matrix, 1, r, g, b) - 128;
       v = APPLY_MATRIX (matrix, 2, r, g, b) - 128;
 
-      a = chroma_keying_yuv (a, &y, &u, &v, cr, cb,
-          smin, smax, accept_angle_tg, accept_angle_ctg,
-          one_over_kc, kfgy_scale, kg, noise_level2);
+      a = chroma_keying_table (alpha, a, &y, &u, &v, smin, smax);
 
       u += 128;
       v += 128;
@@ -789,13 +861,6 @@ gst_alpha_chroma_key_argb_argb (const GstVideoFrame * in_frame,
   gint r, g, b;
   gint smin, smax;
   gint pa = CLAMP ((gint) (alpha->alpha * 256), 0, 256);
-  gint8 cb = alpha->cb, cr = alpha->cr;
-  gint8 kg = alpha->kg;
-  guint8 accept_angle_tg = alpha->accept_angle_tg;
-  guint8 accept_angle_ctg = alpha->accept_angle_ctg;
-  guint8 one_over_kc = alpha->one_over_kc;
-  guint8 kfgy_scale = alpha->kfgy_scale;
-  guint noise_level2 = alpha->noise_level2;
   gint matrix[12], matrix2[12];
   gint p[4], o[4];
 
@@ -832,9 +897,7 @@ gst_alpha_chroma_key_argb_argb (const GstVideoFrame * in_frame,
       u = APPLY_MATRIX (matrix, 1, r, g, b) - 128;
       v = APPLY_MATRIX (matrix, 2, r, g, b) - 128;
 
-      a = chroma_keying_yuv (a, &y, &u, &v, cr, cb,
-          smin, smax, accept_angle_tg, accept_angle_ctg,
-          one_over_kc, kfgy_scale, kg, noise_level2);
+      a = chroma_keying_table (alpha, a, &y, &u, &v, smin, smax);
 
       u += 128;
       v += 128;
@@ -912,13 +975,6 @@ gst_alpha_chroma_key_ayuv_argb (const GstVideoFrame * in_frame,
   gint r, g, b;
   gint smin, smax;
   gint pa = CLAMP ((gint) (alpha->alpha * 256), 0, 256);
-  gint8 cb = alpha->cb, cr = alpha->cr;
-  gint8 kg = alpha->kg;
-  guint8 accept_angle_tg = alpha->accept_angle_tg;
-  guint8 accept_angle_ctg = alpha->accept_angle_ctg;
-  guint8 one_over_kc = alpha->one_over_kc;
-  guint8 kfgy_scale = alpha->kfgy_scale;
-  guint noise_level2 = alpha->noise_level2;
   gint matrix[12];
   gint p[4];
 
@@ -947,9 +1003,7 @@ gst_alpha_chroma_key_ayuv_argb (const GstVideoFrame * in_frame,
       u = src[2] - 128;
       v = src[3] - 128;
 
-      a = chroma_keying_yuv (a, &y, &u, &v, cr, cb,
-          smin, smax, accept_angle_tg, accept_angle_ctg,
-          one_over_kc, kfgy_scale, kg, noise_level2);
+      a = chroma_keying_table (alpha, a, &y, &u, &v, smin, smax);
 
       u += 128;
       v += 128;
@@ -1029,13 +1083,6 @@ gst_alpha_chroma_key_ayuv_ayuv (const GstVideoFrame * in_frame,
   gint a, y, u, v;
   gint smin, smax;
   gint pa = CLAMP ((gint) (alpha->alpha * 256), 0, 256);
-  gint8 cb = alpha->cb, cr = alpha->cr;
-  gint8 kg = alpha->kg;
-  guint8 accept_angle_tg = alpha->accept_angle_tg;
-  guint8 accept_angle_ctg = alpha->accept_angle_ctg;
-  guint8 one_over_kc = alpha->one_over_kc;
-  guint8 kfgy_scale = alpha->kfgy_scale;
-  guint noise_level2 = alpha->noise_level2;
 
   src = GST_VIDEO_FRAME_PLANE_DATA (in_frame, 0);
   dest = GST_VIDEO_FRAME_PLANE_DATA (out_frame, 0);
@@ -1054,9 +1101,7 @@ gst_alpha_chroma_key_ayuv_ayuv (const GstVideoFrame * in_frame,
         u = src[2] - 128;
         v = src[3] - 128;
 
-        a = chroma_keying_yuv (a, &y, &u, &v, cr, cb,
-            smin, smax, accept_angle_tg, accept_angle_ctg,
-            one_over_kc, kfgy_scale, kg, noise_level2);
+        a = chroma_keying_table (alpha, a, &y, &u, &v, smin, smax);
 
         u += 128;
         v += 128;
@@ -1084,9 +1129,7 @@ gst_alpha_chroma_key_ayuv_ayuv (const GstVideoFrame * in_frame,
         u = APPLY_MATRIX (matrix, 1, src[1], src[2], src[3]) - 128;
         v = APPLY_MATRIX (matrix, 2, src[1], src[2], src[3]) - 128;
 
-        a = chroma_keying_yuv (a, &y, &u, &v, cr, cb,
-            smin, smax, accept_angle_tg, accept_angle_ctg,
-            one_over_kc, kfgy_scale, kg, noise_level2);
+        a = chroma_keying_table (alpha, a, &y, &u, &v, smin, smax);
 
         u += 128;
         v += 128;
@@ -1162,13 +1205,6 @@ gst_alpha_chroma_key_rgb_ayuv (const GstVideoFrame * in_frame,
   gint r, g, b;
   gint smin, smax;
   gint pa = CLAMP ((gint) (alpha->alpha * 255), 0, 255);
-  gint8 cb = alpha->cb, cr = alpha->cr;
-  gint8 kg = alpha->kg;
-  guint8 accept_angle_tg = alpha->accept_angle_tg;
-  guint8 accept_angle_ctg = alpha->accept_angle_ctg;
-  guint8 one_over_kc = alpha->one_over_kc;
-  guint8 kfgy_scale = alpha->kfgy_scale;
-  guint noise_level2 = alpha->noise_level2;
   gint matrix[12];
   gint o[3];
   gint bpp;
@@ -1203,9 +1239,7 @@ gst_alpha_chroma_key_rgb_ayuv (const GstVideoFrame * in_frame,
       u = APPLY_MATRIX (matrix, 1, r, g, b) - 128;
       v = APPLY_MATRIX (matrix, 2, r, g, b) - 128;
 
-      a = chroma_keying_yuv (a, &y, &u, &v, cr, cb,
-          smin, smax, accept_angle_tg, accept_angle_ctg,
-          one_over_kc, kfgy_scale, kg, noise_level2);
+      a = chroma_keying_table (alpha, a, &y, &u, &v, smin, smax);
 
       u += 128;
       v += 128;
@@ -1276,13 +1310,6 @@ gst_alpha_chroma_key_rgb_argb (const GstVideoFrame * in_frame,
   gint r, g, b;
   gint smin, smax;
   gint pa = CLAMP ((gint) (alpha->alpha * 255), 0, 255);
-  gint8 cb = alpha->cb, cr = alpha->cr;
-  gint8 kg = alpha->kg;
-  guint8 accept_angle_tg = alpha->accept_angle_tg;
-  guint8 accept_angle_ctg = alpha->accept_angle_ctg;
-  guint8 one_over_kc = alpha->one_over_kc;
-  guint8 kfgy_scale = alpha->kfgy_scale;
-  guint noise_level2 = alpha->noise_level2;
   gint matrix[12], matrix2[12];
   gint p[4], o[3];
   gint bpp;
@@ -1321,9 +1348,7 @@ gst_alpha_chroma_key_rgb_argb (const GstVideoFrame * in_frame,
       u = APPLY_MATRIX (matrix, 1, r, g, b) - 128;
       v = APPLY_MATRIX (matrix, 2, r, g, b) - 128;
 
-      a = chroma_keying_yuv (a, &y, &u, &v, cr, cb,
-          smin, smax, accept_angle_tg, accept_angle_ctg,
-          one_over_kc, kfgy_scale, kg, noise_level2);
+      a = chroma_keying_table (alpha, a, &y, &u, &v, smin, smax);
 
       u += 128;
       v += 128;
@@ -1471,13 +1496,6 @@ gst_alpha_chroma_key_planar_yuv_ayuv (const GstVideoFrame * in_frame,
   gint v_subs, h_subs;
   gint smin = 128 - alpha->black_sensitivity;
   gint smax = 128 + alpha->white_sensitivity;
-  gint8 cb = alpha->cb, cr = alpha->cr;
-  gint8 kg = alpha->kg;
-  guint8 accept_angle_tg = alpha->accept_angle_tg;
-  guint8 accept_angle_ctg = alpha->accept_angle_ctg;
-  guint8 one_over_kc = alpha->one_over_kc;
-  guint8 kfgy_scale = alpha->kfgy_scale;
-  guint noise_level2 = alpha->noise_level2;
 
   dest = GST_VIDEO_FRAME_PLANE_DATA (out_frame, 0);
 
@@ -1520,9 +1538,7 @@ gst_alpha_chroma_key_planar_yuv_ayuv (const GstVideoFrame * in_frame,
         u = srcU[0] - 128;
         v = srcV[0] - 128;
 
-        a = chroma_keying_yuv (a, &y, &u, &v, cr, cb, smin,
-            smax, accept_angle_tg, accept_angle_ctg,
-            one_over_kc, kfgy_scale, kg, noise_level2);
+        a = chroma_keying_table (alpha, a, &y, &u, &v, smin, smax);
 
         u += 128;
         v += 128;
@@ -1563,9 +1579,7 @@ gst_alpha_chroma_key_planar_yuv_ayuv (const GstVideoFrame * in_frame,
         u = APPLY_MATRIX (matrix, 1, srcY[0], srcU[0], srcV[0]) - 128;
         v = APPLY_MATRIX (matrix, 2, srcY[0], srcU[0], srcV[0]) - 128;
 
-        a = chroma_keying_yuv (a, &y, &u, &v, cr, cb, smin,
-            smax, accept_angle_tg, accept_angle_ctg,
-            one_over_kc, kfgy_scale, kg, noise_level2);
+        a = chroma_keying_table (alpha, a, &y, &u, &v, smin, smax);
 
         dest[0] = a;
         dest[1] = y;
@@ -1703,13 +1717,6 @@ gst_alpha_chroma_key_planar_yuv_argb (const GstVideoFrame * in_frame,
   gint v_subs, h_subs;
   gint smin = 128 - alpha->black_sensitivity;
   gint smax = 128 + alpha->white_sensitivity;
-  gint8 cb = alpha->cb, cr = alpha->cr;
-  gint8 kg = alpha->kg;
-  guint8 accept_angle_tg = alpha->accept_angle_tg;
-  guint8 accept_angle_ctg = alpha->accept_angle_ctg;
-  guint8 one_over_kc = alpha->one_over_kc;
-  guint8 kfgy_scale = alpha->kfgy_scale;
-  guint noise_level2 = alpha->noise_level2;
   gint matrix[12];
   gint p[4];
 
@@ -1762,9 +1769,7 @@ gst_alpha_chroma_key_planar_yuv_argb (const GstVideoFrame * in_frame,
       u = srcU[0] - 128;
       v = srcV[0] - 128;
 
-      a = chroma_keying_yuv (a, &y, &u, &v, cr, cb, smin,
-          smax, accept_angle_tg, accept_angle_ctg,
-          one_over_kc, kfgy_scale, kg, noise_level2);
+      a = chroma_keying_table (alpha, a, &y, &u, &v, smin, smax);
 
       u += 128;
       v += 128;
@@ -1929,13 +1934,6 @@ gst_alpha_chroma_key_packed_422_ayuv (const GstVideoFrame * in_frame,
   gint a, y, u, v;
   gint smin, smax;
   gint pa = CLAMP ((gint) (alpha->alpha * 255), 0, 255);
-  gint8 cb = alpha->cb, cr = alpha->cr;
-  gint8 kg = alpha->kg;
-  guint8 accept_angle_tg = alpha->accept_angle_tg;
-  guint8 accept_angle_ctg = alpha->accept_angle_ctg;
-  guint8 one_over_kc = alpha->one_over_kc;
-  guint8 kfgy_scale = alpha->kfgy_scale;
-  guint noise_level2 = alpha->noise_level2;
   gint p[4];                    /* Y U Y V */
   gint src_stride;
   const guint8 *src_tmp;
@@ -1971,9 +1969,7 @@ gst_alpha_chroma_key_packed_422_ayuv (const GstVideoFrame * in_frame,
         u = APPLY_MATRIX (matrix, 1, src[p[0]], src[p[1]], src[p[3]]) - 128;
         v = APPLY_MATRIX (matrix, 2, src[p[0]], src[p[1]], src[p[3]]) - 128;
 
-        a = chroma_keying_yuv (pa, &y, &u, &v, cr, cb,
-            smin, smax, accept_angle_tg, accept_angle_ctg,
-            one_over_kc, kfgy_scale, kg, noise_level2);
+        a = chroma_keying_table (alpha, pa, &y, &u, &v, smin, smax);
 
         dest[0] = a;
         dest[1] = y;
@@ -1984,9 +1980,7 @@ gst_alpha_chroma_key_packed_422_ayuv (const GstVideoFrame * in_frame,
         u = APPLY_MATRIX (matrix, 1, src[p[2]], src[p[1]], src[p[3]]) - 128;
         v = APPLY_MATRIX (matrix, 2, src[p[2]], src[p[1]], src[p[3]]) - 128;
 
-        a = chroma_keying_yuv (pa, &y, &u, &v, cr, cb,
-            smin, smax, accept_angle_tg, accept_angle_ctg,
-            one_over_kc, kfgy_scale, kg, noise_level2);
+        a = chroma_keying_table (alpha, pa, &y, &u, &v, smin, smax);
 
         dest[4] = a;
         dest[5] = y;
@@ -2002,9 +1996,7 @@ gst_alpha_chroma_key_packed_422_ayuv (const GstVideoFrame * in_frame,
         u = APPLY_MATRIX (matrix, 1, src[p[0]], src[p[1]], src[p[3]]) - 128;
         v = APPLY_MATRIX (matrix, 2, src[p[0]], src[p[1]], src[p[3]]) - 128;
 
-        a = chroma_keying_yuv (pa, &y, &u, &v, cr, cb,
-            smin, smax, accept_angle_tg, accept_angle_ctg,
-            one_over_kc, kfgy_scale, kg, noise_level2);
+        a = chroma_keying_table (alpha, pa, &y, &u, &v, smin, smax);
 
         dest[0] = a;
         dest[1] = y;
@@ -2025,9 +2017,7 @@ gst_alpha_chroma_key_packed_422_ayuv (const GstVideoFrame * in_frame,
         u = src[p[1]] - 128;
         v = src[p[3]] - 128;
 
-        a = chroma_keying_yuv (pa, &y, &u, &v, cr, cb,
-            smin, smax, accept_angle_tg, accept_angle_ctg,
-            one_over_kc, kfgy_scale, kg, noise_level2);
+        a = chroma_keying_table (alpha, pa, &y, &u, &v, smin, smax);
 
         dest[0] = a;
         dest[1] = y;
@@ -2038,9 +2028,7 @@ gst_alpha_chroma_key_packed_422_ayuv (const GstVideoFrame * in_frame,
         u = src[p[1]] - 128;
         v = src[p[3]] - 128;
 
-        a = chroma_keying_yuv (pa, &y, &u, &v, cr, cb,
-            smin, smax, accept_angle_tg, accept_angle_ctg,
-            one_over_kc, kfgy_scale, kg, noise_level2);
+        a = chroma_keying_table (alpha, pa, &y, &u, &v, smin, smax);
 
         dest[4] = a;
         dest[5] = y;
@@ -2056,9 +2044,7 @@ gst_alpha_chroma_key_packed_422_ayuv (const GstVideoFrame * in_frame,
         u = src[p[1]] - 128;
         v = src[p[3]] - 128;
 
-        a = chroma_keying_yuv (pa, &y, &u, &v, cr, cb,
-            smin, smax, accept_angle_tg, accept_angle_ctg,
-            one_over_kc, kfgy_scale, kg, noise_level2);
+        a = chroma_keying_table (alpha, pa, &y, &u, &v, smin, smax);
 
         dest[0] = a;
         dest[1] = y;
@@ -2165,13 +2151,6 @@ gst_alpha_chroma_key_packed_422_argb (const GstVideoFrame * in_frame,
   gint r, g, b;
   gint smin, smax;
   gint pa = CLAMP ((gint) (alpha->alpha * 255), 0, 255);
-  gint8 cb = alpha->cb, cr = alpha->cr;
-  gint8 kg = alpha->kg;
-  guint8 accept_angle_tg = alpha->accept_angle_tg;
-  guint8 accept_angle_ctg = alpha->accept_angle_ctg;
-  guint8 one_over_kc = alpha->one_over_kc;
-  guint8 kfgy_scale = alpha->kfgy_scale;
-  guint noise_level2 = alpha->noise_level2;
   gint p[4], o[4];
   gint src_stride;
   const guint8 *src_tmp;
@@ -2210,9 +2189,7 @@ gst_alpha_chroma_key_packed_422_argb (const GstVideoFrame * in_frame,
       u = src[o[1]] - 128;
       v = src[o[3]] - 128;
 
-      a = chroma_keying_yuv (pa, &y, &u, &v, cr, cb,
-          smin, smax, accept_angle_tg, accept_angle_ctg,
-          one_over_kc, kfgy_scale, kg, noise_level2);
+      a = chroma_keying_table (alpha, pa, &y, &u, &v, smin, smax);
       u += 128;
       v += 128;
 
@@ -2229,9 +2206,7 @@ gst_alpha_chroma_key_packed_422_argb (const GstVideoFrame * in_frame,
       u = src[o[1]] - 128;
       v = src[o[3]] - 128;
 
-      a = chroma_keying_yuv (pa, &y, &u, &v, cr, cb,
-          smin, smax, accept_angle_tg, accept_angle_ctg,
-          one_over_kc, kfgy_scale, kg, noise_level2);
+      a = chroma_keying_table (alpha, pa, &y, &u, &v, smin, smax);
       u += 128;
       v += 128;
 
@@ -2253,9 +2228,7 @@ gst_alpha_chroma_key_packed_422_argb (const GstVideoFrame * in_frame,
       u = src[o[1]] - 128;
       v = src[o[3]] - 128;
 
-      a = chroma_keying_yuv (pa, &y, &u, &v, cr, cb,
-          smin, smax, accept_angle_tg, accept_angle_ctg,
-          one_over_kc, kfgy_scale, kg, noise_level2);
+      a = chroma_keying_table (alpha, pa, &y, &u, &v, smin, smax);
       u += 128;
       v += 128;
 
@@ -2358,6 +2331,8 @@ gst_alpha_init_params_full (GstAlpha * alpha,
   alpha->kg = MIN (kgl, 127);
 
   alpha->noise_level2 = alpha->noise_level * alpha->noise_level;
+
+  alpha->chroma_table_valid = FALSE;
 }
 
 static void
@@ -2577,6 +2552,118 @@ gst_alpha_before_transform (GstBaseTransform * btrans, GstBuffer * buf)
     gst_object_sync_values (GST_OBJECT (alpha), timestamp);
 }
 
+/* Don't split frames into bands of fewer lines than this */
+#define MIN_BAND_HEIGHT 16
+
+typedef struct
+{
+  GstAlpha *alpha;
+  GstVideoFrame *in_frame, *out_frame;
+  guint n_bands;
+  gint next_band;
+
+  GMutex lock;
+  GCond cond;
+  guint n_pending;
+} GstAlphaJob;
+
+/* Makes @view a frame of the lines y0 to y1 of @frame */
+static void
+gst_alpha_band_view (GstVideoFrame * frame, gint y0, gint y1,
+    GstVideoFrame * view)
+{
+  const GstVideoFormatInfo *finfo = frame->info.finfo;
+  guint i;
+
+  *view = *frame;
+  view->info.height = y1 - y0;
+  for (i = 0; i < GST_VIDEO_FORMAT_INFO_N_COMPONENTS (finfo); i++) {
+    guint plane = GST_VIDEO_FORMAT_INFO_PLANE (finfo, i);
+
+    view->data[plane] = (guint8 *) frame->data[plane] +
+        GST_VIDEO_FORMAT_INFO_SCALE_HEIGHT (finfo, i, y0) *
+        GST_VIDEO_FRAME_PLANE_STRIDE (frame, plane);
+  }
+}
+
+static void
+gst_alpha_process_bands (GstAlphaJob * job)
+{
+  gint height = GST_VIDEO_FRAME_HEIGHT (job->in_frame);
+  guint i;
+
+  while ((i = g_atomic_int_add (&job->next_band, 1)) < job->n_bands) {
+    GstVideoFrame in_band, out_band;
+    /* Bands start on even lines for the vertically subsampled formats */
+    gint y0 = (height * i / job->n_bands) & ~1;
+    gint y1 = i + 1 == job->n_bands ? height :
+        (height * (i + 1) / job->n_bands) & ~1;
+
+    gst_alpha_band_view (job->in_frame, y0, y1, &in_band);
+    gst_alpha_band_view (job->out_frame, y0, y1, &out_band);
+    job->alpha->process (&in_band, &out_band, job->alpha);
+  }
+}
+
+static void
+gst_alpha_worker_func (GstAlphaJob * job, gpointer user_data)
+{
+  gst_alpha_process_bands (job);
+
+  g_mutex_lock (&job->lock);
+  if (--job->n_pending == 0)
+    g_cond_signal (&job->cond);
+  g_mutex_unlock (&job->lock);
+}
+
+/* Protected with the alpha lock */
+static void
+gst_alpha_process (GstAlpha * alpha, GstVideoFrame * in_frame,
+    GstVideoFrame * out_frame)
+{
+  GstAlphaJob job;
+  guint n_threads, i;
+
+  n_threads = alpha->n_threads ? alpha->n_threads : g_get_num_processors ();
+  n_threads = MIN (n_threads,
+      GST_VIDEO_FRAME_HEIGHT (in_frame) / MIN_BAND_HEIGHT);
+
+  if (n_threads <= 1) {
+    alpha->process (in_frame, out_frame, alpha);
+    return;
+  }
+
+  if (alpha->pool == NULL) {
+    alpha->pool = g_thread_pool_new ((GFunc) gst_alpha_worker_func, NULL,
+        n_threads - 1, TRUE, NULL);
+  } else if (g_thread_pool_get_max_threads (alpha->pool) <
+      (gint) n_threads - 1) {
+    g_thread_pool_set_max_threads (alpha->pool, n_threads - 1, NULL);
+  }
+
+  job.alpha = alpha;
+  job.in_frame = in_frame;
+  job.out_frame = out_frame;
+  job.n_bands = n_threads;
+  job.next_band = 0;
+  g_mutex_init (&job.lock);
+  g_cond_init (&job.cond);
+  job.n_pending = n_threads - 1;
+
+  for (i = 1; i < n_threads; i++)
+    g_thread_pool_push (alpha->pool, &job, NULL);
+
+  gst_alpha_process_bands (&job);
+
+  g_mutex_lock (&job.lock);
+  while (job.n_pending > 0)
+    g_cond_wait (&job.cond, &job.lock);
+  g_mutex_unlock (&job.lock);
+
+  g_mutex_clear (&job.lock);
+  g_cond_clear (&job.cond);
+}
+
 static GstFlowReturn
 gst_alpha_transform_frame (GstVideoFilter * filter, GstVideoFrame * in_frame,
     GstVideoFrame * out_frame)
@@ -2588,7 +2675,10 @@ gst_alpha_transform_frame (GstVideoFilter * filter, GstVideoFrame * in_frame,
   if (G_UNLIKELY (!alpha->process))
     goto not_negotiated;
 
-  alpha->process (in_frame, out_frame, alpha);
+  if (alpha->method != ALPHA_METHOD_SET && !alpha->chroma_table_valid)
+    gst_alpha_build_chroma_table (alpha);
+
+  gst_alpha_process (alpha, in_frame, out_frame);
 
   GST_ALPHA_UNLOCK (alpha);
 
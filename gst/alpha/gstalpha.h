@@ -49,6 +49,14 @@ typedef enum
 }
 GstAlphaMethod;
 
+/* Result of the chroma keying for one U/V pair */
+typedef struct
+{
+  guint16 alpha;                /* scale of the alpha, 256 keeps it */
+  guint8 y_sub;                 /* amount Y is lowered by */
+  gint8 u, v;
+} GstAlphaChromaKey;
+
 GST_DEBUG_CATEGORY_STATIC (gst_alpha_debug);
 #define GST_CAT_DEFAULT gst_alpha_debug
 
@@ -78,6 +86,7 @@ struct _GstAlpha
   guint white_sensitivity;
 
   gboolean prefer_passthrough;
+  guint n_threads;
 
   /* processing function */
   void (*process) (const GstVideoFrame *in_frame, GstVideoFrame *out_frame, GstAlpha *alpha);
@@ -90,6 +99,13 @@ struct _GstAlpha
   guint8 one_over_kc;
   guint8 kfgy_scale;
   guint noise_level2;
+
+  /* chroma keying results for all 256x256 U/V pairs, rebuilt when the
+   * parameters above change */
+  GstAlphaChromaKey *chroma_table;
+  gboolean chroma_table_valid;
+
+  GThreadPool *pool;
 };
 
 G_END_DECLS
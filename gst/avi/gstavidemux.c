@@ -55,11 +55,6 @@
 
 #define DIV_ROUND_UP(s,v) (((s) + ((v)-1)) / (v))
 
-#define GST_AVI_KEYFRAME (1 << 0)
-#define ENTRY_IS_KEYFRAME(e) ((e)->flags == GST_AVI_KEYFRAME)
-#define ENTRY_SET_KEYFRAME(e) ((e)->flags = GST_AVI_KEYFRAME)
-#define ENTRY_UNSET_KEYFRAME(e) ((e)->flags = 0)
-
 
 GST_DEBUG_CATEGORY_STATIC (avidemux_debug);
 #define GST_CAT_DEFAULT avidemux_debug
@@ -679,9 +674,11 @@ static gint
 gst_avi_demux_index_entry_offset_search (GstAviIndexEntry * entry,
     guint64 * offset)
 {
-  if (entry->offset < *offset)
+  guint64 entry_offset = ENTRY_OFFSET (entry);
+
+  if (entry_offset < *offset)
     return -1;
-  else if (entry->offset > *offset)
+  else if (entry_offset > *offset)
     return 1;
   return 0;
 }
@@ -713,7 +710,7 @@ gst_avi_demux_seek_streams_index (GstAviDemux * avi, guint64 offset,
 
     if (before) {
       if (entry) {
-        val = stream->index[index].offset;
+        val = ENTRY_OFFSET (&stream->index[index]);
         GST_DEBUG_OBJECT (avi,
             "stream %d, previous entry at %" G_GUINT64_FORMAT, i, val);
         if (val < min)
@@ -729,11 +726,11 @@ gst_avi_demux_seek_streams_index (GstAviDemux * avi, guint64 offset,
       continue;
     }
 
-    val = stream->index[index].offset - 8;
+    val = ENTRY_OFFSET (&stream->index[index]) - 8;
     GST_DEBUG_OBJECT (avi, "stream %d, next entry at %" G_GUINT64_FORMAT, i,
         val);
 
-    stream->current_total = stream->index[index].total;
+    stream->current_total = ENTRY_TOTAL (&stream->index[index]);
     stream->current_entry = index;
   }
 
@@ -798,12 +795,12 @@ gst_avi_demux_handle_sink_event (GstPad * pad, GstObject * parent,
           index = entry - stream->index;
 
           /* we are on the stream with a chunk start offset closest to start */
-          if (!offset || stream->index[index].offset < offset) {
-            offset = stream->index[index].offset;
+          if (!offset || ENTRY_OFFSET (&stream->index[index]) < offset) {
+            offset = ENTRY_OFFSET (&stream->index[index]);
             k = i;
           }
           /* exact match needs no further searching */
-          if (stream->index[index].offset == boffset)
+          if (ENTRY_OFFSET (&stream->index[index]) == boffset)
             break;
         } while (++i < avi->num_streams);
         boffset -= 8;
@@ -1317,11 +1314,19 @@ invalid_params:
 
 /* add an entry to the index of a stream. @num should be an estimate of the
  * total amount of index entries for all streams and is used to dynamically
- * allocate memory for the index entries. */
+ * allocate memory for the index entries. Posts an error and returns FALSE
+ * if there is no memory for the entry or it doesn't fit in the packed
+ * representation. */
 static inline gboolean
 gst_avi_demux_add_index (GstAviDemux * avi, GstAviStream * stream,
-    guint num, GstAviIndexEntry * entry)
+    guint num, guint64 offset, guint32 size, gboolean keyframe)
 {
+  GstAviIndexEntry *entry;
+  guint64 total;
+
+  if (G_UNLIKELY (offset > ENTRY_MAX_OFFSET))
+    goto too_large;
+
   /* ensure index memory */
   if (G_UNLIKELY (stream->idx_n >= stream->idx_max)) {
     guint idx_max = stream->idx_max;
@@ -1333,14 +1338,17 @@ gst_avi_demux_add_index (GstAviDemux * avi, GstAviStream * stream,
        * overshoot with at least 8K */
       idx_max = (num / avi->num_streams) + (8192 / sizeof (GstAviIndexEntry));
     } else {
-      idx_max += 8192 / sizeof (GstAviIndexEntry);
+      /* grow geometrically, OpenDML files can have millions of entries spread
+       * over many subindexes and growing by a fixed amount makes building the
+       * index quadratic */
+      idx_max += MAX (idx_max / 2, 8192 / sizeof (GstAviIndexEntry));
       GST_DEBUG_OBJECT (avi, "expanded index from %u to %u",
           stream->idx_max, idx_max);
     }
     new_idx = g_try_renew (GstAviIndexEntry, stream->index, idx_max);
     /* out of memory, if this fails stream->index is untouched. */
     if (G_UNLIKELY (!new_idx))
-      return FALSE;
+      goto out_of_mem;
     /* use new index */
     stream->index = new_idx;
     stream->idx_max = idx_max;
@@ -1348,39 +1356,53 @@ gst_avi_demux_add_index (GstAviDemux * avi, GstAviStream * stream,
 
   /* update entry total and stream stats. The entry total can be converted to
    * the timestamp of the entry easily. */
+  if (stream->strh->type == GST_RIFF_FCC_auds && stream->is_vbr) {
+    total = stream->total_blocks;
+  } else if (stream->is_vbr) {
+    total = stream->idx_n;
+  } else {
+    total = stream->total_bytes;
+  }
+  if (G_UNLIKELY (total > ENTRY_MAX_TOTAL))
+    goto too_large;
   if (stream->strh->type == GST_RIFF_FCC_auds) {
-    gint blockalign;
+    gint blockalign = stream->strf.auds->blockalign;
 
-    if (stream->is_vbr) {
-      entry->total = stream->total_blocks;
-    } else {
-      entry->total = stream->total_bytes;
-    }
-    blockalign = stream->strf.auds->blockalign;
     if (blockalign > 0)
-      stream->total_blocks += DIV_ROUND_UP (entry->size, blockalign);
+      stream->total_blocks += DIV_ROUND_UP (size, blockalign);
     else
       stream->total_blocks++;
-  } else {
-    if (stream->is_vbr) {
-      entry->total = stream->idx_n;
-    } else {
-      entry->total = stream->total_bytes;
-    }
   }
-  stream->total_bytes += entry->size;
-  if (ENTRY_IS_KEYFRAME (entry))
+  stream->total_bytes += size;
+  if (keyframe)
     stream->n_keyframes++;
 
   /* and add */
   GST_LOG_OBJECT (avi,
       "Adding stream %u, index entry %d, kf %d, size %u "
       ", offset %" G_GUINT64_FORMAT ", total %" G_GUINT64_FORMAT, stream->num,
-      stream->idx_n, ENTRY_IS_KEYFRAME (entry), entry->size, entry->offset,
-      entry->total);
-  stream->index[stream->idx_n++] = *entry;
+      stream->idx_n, keyframe, size, offset, total);
+  entry = &stream->index[stream->idx_n++];
+  gst_avi_index_entry_set (entry, offset, size, total, keyframe);
 
   return TRUE;
+
+  /* ERRORS */
+out_of_mem:
+  {
+    GST_ELEMENT_ERROR (avi, RESOURCE, NO_SPACE_LEFT, (NULL),
+        ("Cannot allocate memory for %u*%u=%u bytes",
+            (guint) sizeof (GstAviIndexEntry), num,
+            (guint) sizeof (GstAviIndexEntry) * num));
+    return FALSE;
+  }
+too_large:
+  {
+    GST_ELEMENT_ERROR (avi, STREAM, DEMUX, (NULL),
+        ("Index entry at offset %" G_GUINT64_FORMAT " of stream %u is out "
+            "of the supported range", offset, stream->num));
+    return FALSE;
+  }
 }
 
 /* given @entry_n in @stream, calculate info such as timestamps and
@@ -1399,13 +1421,15 @@ gst_avi_demux_get_buffer_info (GstAviDemux * avi, GstAviStream * stream,
     if (stream->strh->type == GST_RIFF_FCC_auds) {
       if (timestamp)
         *timestamp =
-            avi_stream_convert_frames_to_time_unchecked (stream, entry->total);
+            avi_stream_convert_frames_to_time_unchecked (stream,
+            ENTRY_TOTAL (entry));
       if (ts_end) {
         gint size = 1;
         if (G_LIKELY (entry_n + 1 < stream->idx_n))
-          size = stream->index[entry_n + 1].total - entry->total;
+          size =
+              ENTRY_TOTAL (&stream->index[entry_n + 1]) - ENTRY_TOTAL (entry);
         *ts_end = avi_stream_convert_frames_to_time_unchecked (stream,
-            entry->total + size);
+            ENTRY_TOTAL (entry) + size);
       }
     } else {
       if (timestamp)
@@ -1419,10 +1443,11 @@ gst_avi_demux_get_buffer_info (GstAviDemux * avi, GstAviStream * stream,
     /* constant rate stream */
     if (timestamp)
       *timestamp =
-          avi_stream_convert_bytes_to_time_unchecked (stream, entry->total);
+          avi_stream_convert_bytes_to_time_unchecked (stream,
+          ENTRY_TOTAL (entry));
     if (ts_end)
       *ts_end = avi_stream_convert_bytes_to_time_unchecked (stream,
-          entry->total + entry->size);
+          ENTRY_TOTAL (entry) + ENTRY_SIZE (entry));
   }
   if (stream->strh->type == GST_RIFF_FCC_vids) {
     /* video offsets are the frame number */
@@ -1480,6 +1505,17 @@ gst_avi_demux_do_index_stats (GstAviDemux * avi)
         (guint) (stream->idx_n * sizeof (GstAviIndexEntry)),
         (guint) (stream->idx_max * sizeof (GstAviIndexEntry)));
 
+    /* the index is complete now, give back what was overallocated */
+    if (stream->idx_max > stream->idx_n) {
+      GstAviIndexEntry *new_idx;
+
+      new_idx = g_try_renew (GstAviIndexEntry, stream->index, stream->idx_n);
+      if (G_LIKELY (new_idx)) {
+        stream->index = new_idx;
+        stream->idx_max = stream->idx_n;
+      }
+    }
+
     /* knowing all that we do, that also includes avg bitrate */
     if (!stream->taglist) {
       stream->taglist = gst_tag_list_new_empty ();
@@ -1567,28 +1603,31 @@ gst_avi_demux_parse_subindex (GstAviDemux * avi, GstAviStream * stream,
   GST_INFO_OBJECT (avi, "Parsing subindex, nr_entries = %6d", num);
 
   for (i = 0; i < num; i++) {
-    GstAviIndexEntry entry;
+    guint64 offset;
+    guint32 size;
+    gboolean keyframe;
 
     if (map.size < 24 + bpe * (i + 1))
       break;
 
-    /* fill in offset and size. offset contains the keyframe flag in the
+    /* fill in offset and size. size contains the keyframe flag in the
      * upper bit*/
-    entry.offset = baseoff + GST_READ_UINT32_LE (&data[24 + bpe * i]);
-    entry.size = GST_READ_UINT32_LE (&data[24 + bpe * i + 4]);
+    offset = baseoff + GST_READ_UINT32_LE (&data[24 + bpe * i]);
+    size = GST_READ_UINT32_LE (&data[24 + bpe * i + 4]);
     /* handle flags */
     if (stream->strh->type == GST_RIFF_FCC_auds) {
       /* all audio frames are keyframes */
-      ENTRY_SET_KEYFRAME (&entry);
+      keyframe = TRUE;
     } else {
       /* else read flags */
-      entry.flags = (entry.size & 0x80000000) ? 0 : GST_AVI_KEYFRAME;
+      keyframe = (size & 0x80000000) == 0;
     }
-    entry.size &= ~0x80000000;
+    size &= ~0x80000000;
 
     /* and add */
-    if (G_UNLIKELY (!gst_avi_demux_add_index (avi, stream, num, &entry)))
-      goto out_of_mem;
+    if (G_UNLIKELY (!gst_avi_demux_add_index (avi, stream, num, offset, size,
+                keyframe)))
+      goto add_failed;
   }
 done:
   gst_buffer_unmap (buf, &map);
@@ -1617,12 +1656,9 @@ empty_index:
     GST_DEBUG_OBJECT (avi, "the index is empty");
     goto done;                  /* continue */
   }
-out_of_mem:
+add_failed:
   {
-    GST_ELEMENT_ERROR (avi, RESOURCE, NO_SPACE_LEFT, (NULL),
-        ("Cannot allocate memory for %u*%u=%u bytes",
-            (guint) sizeof (GstAviIndexEntry), num,
-            (guint) sizeof (GstAviIndexEntry) * num));
+    /* gst_avi_demux_add_index() posted an error */
     gst_buffer_unmap (buf, &map);
     gst_buffer_unref (buf);
     return FALSE;
@@ -2616,9 +2652,11 @@ gst_avi_demux_index_next (GstAviDemux * avi, GstAviStream * stream,
 static guint
 gst_avi_demux_index_entry_search (GstAviIndexEntry * entry, guint64 * total)
 {
-  if (entry->total < *total)
+  guint64 entry_total = ENTRY_TOTAL (entry);
+
+  if (entry_total < *total)
     return -1;
-  else if (entry->total > *total)
+  else if (entry_total > *total)
     return 1;
   return 0;
 }
@@ -2738,7 +2776,8 @@ gst_avi_demux_parse_index (GstAviDemux * avi, GstBuffer * buf)
   gst_riff_index_entry *index;
   GstClockTime stamp;
   GstAviStream *stream;
-  GstAviIndexEntry entry;
+  guint64 offset;
+  gboolean keyframe;
   guint32 id;
 
   if (!buf)
@@ -2758,8 +2797,8 @@ gst_avi_demux_parse_index (GstAviDemux * avi, GstBuffer * buf)
   index = (gst_riff_index_entry *) map.data;
 
   /* figure out if the index is 0 based or relative to the MOVI start */
-  entry.offset = GST_READ_UINT32_LE (&index[0].offset);
-  if (entry.offset < avi->offset) {
+  offset = GST_READ_UINT32_LE (&index[0].offset);
+  if (offset < avi->offset) {
     avi->index_offset = avi->offset + 8;
     GST_DEBUG ("index_offset = %" G_GUINT64_FORMAT, avi->index_offset);
   } else {
@@ -2769,11 +2808,11 @@ gst_avi_demux_parse_index (GstAviDemux * avi, GstBuffer * buf)
 
   for (i = 0, n = 0; i < num; i++) {
     id = GST_READ_UINT32_LE (&index[i].id);
-    entry.offset = GST_READ_UINT32_LE (&index[i].offset);
+    offset = GST_READ_UINT32_LE (&index[i].offset);
 
     /* some sanity checks */
     if (G_UNLIKELY (id == GST_RIFF_rec || id == 0 ||
-            (entry.offset == 0 && n > 0)))
+            (offset == 0 && n > 0)))
       continue;
 
     /* get the stream for this entry */
@@ -2782,31 +2821,27 @@ gst_avi_demux_parse_index (GstAviDemux * avi, GstBuffer * buf)
       continue;
 
     /* handle offset and size */
-    entry.offset += avi->index_offset + 8;
-    entry.size = GST_READ_UINT32_LE (&index[i].size);
+    offset += avi->index_offset + 8;
 
     /* handle flags */
     if (stream->strh->type == GST_RIFF_FCC_auds) {
       /* all audio frames are keyframes */
-      ENTRY_SET_KEYFRAME (&entry);
+      keyframe = TRUE;
     } else if (stream->strh->type == GST_RIFF_FCC_vids &&
         stream->strf.vids->compression == GST_RIFF_DXSB) {
       /* all xsub frames are keyframes */
-      ENTRY_SET_KEYFRAME (&entry);
+      keyframe = TRUE;
     } else {
       guint32 flags;
       /* else read flags */
       flags = GST_READ_UINT32_LE (&index[i].flags);
-      if (flags & GST_RIFF_IF_KEYFRAME) {
-        ENTRY_SET_KEYFRAME (&entry);
-      } else {
-        ENTRY_UNSET_KEYFRAME (&entry);
-      }
+      keyframe = (flags & GST_RIFF_IF_KEYFRAME) != 0;
     }
 
     /* and add */
-    if (G_UNLIKELY (!gst_avi_demux_add_index (avi, stream, num, &entry)))
-      goto out_of_mem;
+    if (G_UNLIKELY (!gst_avi_demux_add_index (avi, stream, num, offset,
+                GST_READ_UINT32_LE (&index[i].size), keyframe)))
+      goto add_failed;
 
     n++;
   }
@@ -2830,12 +2865,9 @@ empty_list:
     gst_buffer_unref (buf);
     return FALSE;
   }
-out_of_mem:
+add_failed:
   {
-    GST_ELEMENT_ERROR (avi, RESOURCE, NO_SPACE_LEFT, (NULL),
-        ("Cannot allocate memory for %u*%u=%u bytes",
-            (guint) sizeof (GstAviIndexEntry), num,
-            (guint) sizeof (GstAviIndexEntry) * num));
+    /* gst_avi_demux_add_index() posted an error */
     gst_buffer_unmap (buf, &map);
     gst_buffer_unref (buf);
     return FALSE;
@@ -3149,7 +3181,6 @@ gst_avi_demux_stream_scan (GstAviDemux * avi)
   num = 16000;
 
   while (TRUE) {
-    GstAviIndexEntry entry;
     guint size = 0;
 
     /* start reading data buffers to find the id and offset */
@@ -3162,14 +3193,11 @@ gst_avi_demux_stream_scan (GstAviDemux * avi)
     if (G_UNLIKELY (!stream))
       goto next;
 
-    /* we can't figure out the keyframes, assume they all are */
-    entry.flags = GST_AVI_KEYFRAME;
-    entry.offset = pos;
-    entry.size = size;
-
-    /* and add to the index of this stream */
-    if (G_UNLIKELY (!gst_avi_demux_add_index (avi, stream, num, &entry)))
-      goto out_of_mem;
+    /* we can't figure out the keyframes, assume they all are, and add to the
+     * index of this stream */
+    if (G_UNLIKELY (!gst_avi_demux_add_index (avi, stream, num, pos, size,
+                TRUE)))
+      goto add_failed;
 
   next:
     /* update position */
@@ -3187,12 +3215,9 @@ gst_avi_demux_stream_scan (GstAviDemux * avi)
   return TRUE;
 
   /* ERRORS */
-out_of_mem:
+add_failed:
   {
-    GST_ELEMENT_ERROR (avi, RESOURCE, NO_SPACE_LEFT, (NULL),
-        ("Cannot allocate memory for %u*%u=%u bytes",
-            (guint) sizeof (GstAviIndexEntry), num,
-            (guint) sizeof (GstAviIndexEntry) * num));
+    /* gst_avi_demux_add_index() posted an error */
     return FALSE;
   }
 }
@@ -4469,7 +4494,7 @@ gst_avi_demux_move_stream (GstAviDemux * avi, GstAviStream * stream,
       stream->current_offset_end);
 
   GST_DEBUG_OBJECT (avi, "Seeking to offset %" G_GUINT64_FORMAT,
-      stream->index[index].offset);
+      ENTRY_OFFSET (&stream->index[index]));
 }
 
 /*
@@ -4816,7 +4841,7 @@ avi_demux_handle_seek_push (GstAviDemux * avi, GstPad * pad, GstEvent * event)
   /* re-use cur to be the timestamp of the seek as it _will_ be */
   cur = stream->current_timestamp;
 
-  min_offset = stream->index[index].offset;
+  min_offset = ENTRY_OFFSET (&stream->index[index]);
   avi->seek_kf_offset = min_offset - 8;
 
   GST_DEBUG_OBJECT (avi,
@@ -4859,8 +4884,8 @@ avi_demux_handle_seek_push (GstAviDemux * avi, GstPad * pad, GstEvent * event)
         &str->current_timestamp, &str->current_ts_end,
         &str->current_offset, &str->current_offset_end);
 
-    if (str->index[idx].offset < min_offset) {
-      min_offset = str->index[idx].offset;
+    if (ENTRY_OFFSET (&str->index[idx]) < min_offset) {
+      min_offset = ENTRY_OFFSET (&str->index[idx]);
       GST_DEBUG_OBJECT (avi,
           "Found an earlier offset at %" G_GUINT64_FORMAT ", str %u",
           min_offset, n);
@@ -5105,7 +5130,7 @@ gst_avi_demux_advance (GstAviDemux * avi, GstAviStream * stream,
 
   if (new_entry != old_entry) {
     stream->current_entry = new_entry;
-    stream->current_total = stream->index[new_entry].total;
+    stream->current_total = ENTRY_TOTAL (&stream->index[new_entry]);
 
     if (new_entry == old_entry + 1) {
       GST_DEBUG_OBJECT (avi, "moved forwards from %u to %u",
@@ -5260,8 +5285,8 @@ gst_avi_demux_loop_data (GstAviDemux * avi)
 
     /* get the entry data info */
     entry = &stream->index[stream->current_entry];
-    offset = entry->offset;
-    size = entry->size;
+    offset = ENTRY_OFFSET (entry);
+    size = ENTRY_SIZE (entry);
     keyframe = ENTRY_IS_KEYFRAME (entry);
 
     /* skip empty entries */
@@ -49,14 +49,41 @@ G_BEGIN_DECLS
    (((chunkid) >> 8) & 0xff) - '0')
 
 
-/* new index entries 24 bytes */
+/* packed index entries, 16 bytes. Offset and total are split in a low and a
+ * high part, offset is 48 bits wide and total 47 bits as the upper bit of
+ * total_hi holds the keyframe flag. Use the ENTRY_* accessors below. */
 typedef struct {
-  guint32        flags;
-  guint32        size;    /* bytes of the data */
-  guint64        offset;  /* data offset in file */
-  guint64        total;   /* total bytes before */
+  guint32        size;       /* bytes of the data */
+  guint32        offset_lo;  /* data offset in file */
+  guint32        total_lo;   /* total bytes before */
+  guint16        offset_hi;
+  guint16        total_hi;   /* upper bit is the keyframe flag */
 } GstAviIndexEntry;
 
+#define ENTRY_KEYFRAME_FLAG 0x8000
+#define ENTRY_MAX_OFFSET ((G_GUINT64_CONSTANT (1) << 48) - 1)
+#define ENTRY_MAX_TOTAL ((G_GUINT64_CONSTANT (1) << 47) - 1)
+
+#define ENTRY_IS_KEYFRAME(e) (((e)->total_hi & ENTRY_KEYFRAME_FLAG) != 0)
+#define ENTRY_SIZE(e) ((e)->size)
+#define ENTRY_OFFSET(e) (((guint64) (e)->offset_hi << 32) | (e)->offset_lo)
+#define ENTRY_TOTAL(e) \
+  (((guint64) ((e)->total_hi & ~ENTRY_KEYFRAME_FLAG) << 32) | (e)->total_lo)
+
+/* @offset must not be larger than ENTRY_MAX_OFFSET and @total not larger
+ * than ENTRY_MAX_TOTAL */
+static inline void
+gst_avi_index_entry_set (GstAviIndexEntry * entry, guint64 offset,
+    guint32 size, guint64 total, gboolean keyframe)
+{
+  entry->size = size;
+  entry->offset_lo = (guint32) offset;
+  entry->offset_hi = (guint16) (offset >> 32);
+  entry->total_lo = (guint32) total;
+  entry->total_hi = (guint16) (total >> 32) |
+      (keyframe ? ENTRY_KEYFRAME_FLAG : 0);
+}
+
 typedef struct {
   /* index of this streamcontext */
   guint          num;
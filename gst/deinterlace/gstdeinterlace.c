@@ -60,6 +60,7 @@ GST_DEBUG_CATEGORY_STATIC (deinterlace_debug);
 #define DEFAULT_LOCKING         GST_DEINTERLACE_LOCKING_NONE
 #define DEFAULT_IGNORE_OBSCURE  TRUE
 #define DEFAULT_DROP_ORPHANS    TRUE
+#define DEFAULT_N_THREADS       1
 
 enum
 {
@@ -70,7 +71,8 @@ enum
   PROP_FIELD_LAYOUT,
   PROP_LOCKING,
   PROP_IGNORE_OBSCURE,
-  PROP_DROP_ORPHANS
+  PROP_DROP_ORPHANS,
+  PROP_N_THREADS
 };
 
 #define GST_DEINTERLACE_BUFFER_STATE_P    (1<<0)
@@ -271,7 +273,9 @@ gst_deinterlace_locking_get_type (void)
 
 #define DEINTERLACE_VIDEO_FORMATS \
     "{ AYUV, ARGB, ABGR, RGBA, BGRA, Y444, xRGB, xBGR, RGBx, BGRx, RGB, " \
-    "BGR, YUY2, YVYU, UYVY, Y42B, I420, YV12, Y41B, NV12, NV21 }"
+    "BGR, YUY2, YVYU, UYVY, Y42B, I420, YV12, Y41B, NV12, NV21, " \
+    "Y444_10LE, I422_10LE, I420_10LE, Y444_12LE, I422_12LE, I420_12LE, " \
+    "P010_10LE }"
 
 #define DEINTERLACE_CAPS GST_VIDEO_CAPS_MAKE(DEINTERLACE_VIDEO_FORMATS)
 
@@ -433,6 +437,7 @@ gst_deinterlace_set_method (GstDeinterlace * self, GstDeinterlaceMethods method)
   self->method_id = method;
 
   gst_object_set_parent (GST_OBJECT (self->method), GST_OBJECT (self));
+  gst_deinterlace_method_set_n_threads (self->method, self->n_threads);
 #if 0
   gst_child_proxy_child_added (GST_OBJECT (self), GST_OBJECT (self->method));
 #endif
@@ -615,6 +620,21 @@ gst_deinterlace_class_init (GstDeinterlaceClass * klass)
           "active locking mode.", DEFAULT_DROP_ORPHANS,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstDeinterlace:n-threads:
+   *
+   * Maximum number of threads to use. Methods working line by line (e.g.
+   * linear, greedyl, vfir and yadif) split each output frame into
+   * horizontal bands that are processed in parallel. Other methods always
+   * use a single thread. 0 uses one thread per CPU.
+   *
+   * Since: 1.18
+   */
+  g_object_class_install_property (gobject_class, PROP_N_THREADS,
+      g_param_spec_uint ("n-threads", "Threads",
+          "Maximum number of threads to use", 0, G_MAXUINT,
+          DEFAULT_N_THREADS, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   element_class->change_state =
       GST_DEBUG_FUNCPTR (gst_deinterlace_change_state);
 
@@ -677,6 +697,7 @@ gst_deinterlace_init (GstDeinterlace * self)
 
   self->mode = DEFAULT_MODE;
   self->user_set_method_id = DEFAULT_METHOD;
+  self->n_threads = DEFAULT_N_THREADS;
   gst_video_info_init (&self->vinfo);
   gst_video_info_init (&self->vinfo_out);
   gst_deinterlace_set_method (self, self->user_set_method_id);
@@ -700,24 +721,47 @@ gst_deinterlace_init (GstDeinterlace * self)
   gst_deinterlace_reset (self);
 }
 
+/* Both fields of an input buffer share one mapping, which is only unmapped
+ * once the last field referencing it leaves the history */
+typedef struct
+{
+  GstVideoFrame frame;
+  gint ref_count;
+} GstDeinterlaceMappedFrame;
+
 static GstVideoFrame *
 gst_video_frame_new_and_map (GstVideoInfo * vinfo, GstBuffer * buffer,
     GstMapFlags flags)
 {
-  GstVideoFrame *frame = g_malloc0 (sizeof (GstVideoFrame));
-  if (!gst_video_frame_map (frame, vinfo, buffer, flags)) {
-    g_free (frame);
+  GstDeinterlaceMappedFrame *mapped = g_new0 (GstDeinterlaceMappedFrame, 1);
+  if (!gst_video_frame_map (&mapped->frame, vinfo, buffer, flags)) {
+    g_free (mapped);
     g_return_val_if_reached (NULL);
     return NULL;
   }
+  mapped->ref_count = 1;
+  return &mapped->frame;
+}
+
+static GstVideoFrame *
+gst_video_frame_ref_mapped (GstVideoFrame * frame)
+{
+  GstDeinterlaceMappedFrame *mapped = (GstDeinterlaceMappedFrame *) frame;
+
+  mapped->ref_count++;
   return frame;
 }
 
 static void
 gst_video_frame_unmap_and_free (GstVideoFrame * frame)
 {
-  gst_video_frame_unmap (frame);
-  g_free (frame);
+  GstDeinterlaceMappedFrame *mapped = (GstDeinterlaceMappedFrame *) frame;
+
+  if (--mapped->ref_count > 0)
+    return;
+
+  gst_video_frame_unmap (&mapped->frame);
+  g_free (mapped);
 }
 
 static GstVideoFrame *
@@ -869,6 +913,9 @@ gst_deinterlace_reset (GstDeinterlace * self)
   self->discont = TRUE;
   self->telecine_tc_warned = FALSE;
 
+  self->frames_mapped = 0;
+  self->bytes_written = 0;
+
   gst_deinterlace_set_allocation (self, NULL, NULL, NULL);
 }
 
@@ -926,6 +973,11 @@ gst_deinterlace_set_property (GObject * object, guint prop_id,
     case PROP_DROP_ORPHANS:
       self->drop_orphans = g_value_get_boolean (value);
       break;
+    case PROP_N_THREADS:
+      self->n_threads = g_value_get_uint (value);
+      if (self->method)
+        gst_deinterlace_method_set_n_threads (self->method, self->n_threads);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (self, prop_id, pspec);
   }
@@ -962,6 +1014,9 @@ gst_deinterlace_get_property (GObject * object, guint prop_id,
     case PROP_DROP_ORPHANS:
       g_value_set_boolean (value, self->drop_orphans);
       break;
+    case PROP_N_THREADS:
+      g_value_set_uint (value, self->n_threads);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (self, prop_id, pspec);
   }
@@ -1087,6 +1142,7 @@ gst_deinterlace_push_history (GstDeinterlace * self, GstBuffer * buffer)
    * if this is not the case, change the map flags as appropriate
    */
   frame = gst_video_frame_new_and_map (&self->vinfo, buffer, GST_MAP_READ);
+  self->frames_mapped++;
 
   tff = GST_VIDEO_FRAME_IS_TFF (frame);
   onefield = GST_VIDEO_FRAME_IS_ONEFIELD (frame);
@@ -1146,7 +1202,7 @@ gst_deinterlace_push_history (GstDeinterlace * self, GstBuffer * buffer)
   }
 
   field1 = frame;
-  field2 = gst_video_frame_new_and_map (&self->vinfo, buffer, GST_MAP_READ);
+  field2 = gst_video_frame_ref_mapped (frame);
   if (field_layout == GST_DEINTERLACE_LAYOUT_TFF) {
     GST_DEBUG_OBJECT (self, "Top field first");
     field1_flags = PICTURE_INTERLACED_TOP;
@@ -1529,6 +1585,24 @@ gst_deinterlace_get_pattern_lock (GstDeinterlace * self, gboolean * flush_one)
   }
 }
 
+static void
+gst_deinterlace_deinterlace_frame (GstDeinterlace * self,
+    GstVideoFrame * outframe)
+{
+  gint64 start = g_get_monotonic_time ();
+
+  gst_deinterlace_method_deinterlace_frame (self->method,
+      self->field_history, self->history_count, outframe,
+      self->cur_field_idx);
+
+  self->bytes_written += GST_VIDEO_FRAME_SIZE (outframe);
+
+  GST_LOG_OBJECT (self, "deinterlaced frame in %" G_GINT64_FORMAT " us, "
+      "%" G_GUINT64_FORMAT " input frames mapped, %" G_GUINT64_FORMAT
+      " bytes written so far", g_get_monotonic_time () - start,
+      self->frames_mapped, self->bytes_written);
+}
+
 static GstFlowReturn
 gst_deinterlace_output_frame (GstDeinterlace * self, gboolean flushing)
 {
@@ -1686,6 +1760,9 @@ restart:
 
     GST_DEBUG_OBJECT (self,
         "Frame type: Progressive; pushing buffer as a frame");
+    GST_LOG_OBJECT (self, "pushing input buffer without copying, %"
+        G_GUINT64_FORMAT " input frames mapped, %" G_GUINT64_FORMAT
+        " bytes written so far", self->frames_mapped, self->bytes_written);
     /* pop and push */
     gst_deinterlace_delete_meta_at (self, self->history_count - 1);
     self->cur_field_idx--;
@@ -1887,9 +1964,7 @@ restart:
           gst_video_frame_new_and_map (&self->vinfo_out, outbuf, GST_MAP_WRITE);
 
       /* do magic calculus */
-      gst_deinterlace_method_deinterlace_frame (self->method,
-          self->field_history, self->history_count, outframe,
-          self->cur_field_idx);
+      gst_deinterlace_deinterlace_frame (self, outframe);
 
       gst_video_frame_unmap_and_free (outframe);
 
@@ -2048,9 +2123,7 @@ restart:
           gst_video_frame_new_and_map (&self->vinfo_out, outbuf, GST_MAP_WRITE);
 
       /* do magic calculus */
-      gst_deinterlace_method_deinterlace_frame (self->method,
-          self->field_history, self->history_count, outframe,
-          self->cur_field_idx);
+      gst_deinterlace_deinterlace_frame (self, outframe);
 
       gst_video_frame_unmap_and_free (outframe);
 
@@ -135,6 +135,7 @@ struct _GstDeinterlace
   /* property value */
   GstDeinterlaceMethods user_set_method_id;
   GstDeinterlaceMethod *method;
+  guint n_threads;
 
   GstVideoInfo vinfo;
   GstVideoInfo vinfo_out;
@@ -156,6 +157,10 @@ struct _GstDeinterlace
   guint history_count;
   int cur_field_idx;
 
+  /* Input frames mapped and output bytes written since the last reset */
+  guint64 frames_mapped;
+  guint64 bytes_written;
+
   /* Set to TRUE if we're in still frame mode,
      i.e. just forward all buffers
    */
@@ -89,6 +89,15 @@ gst_deinterlace_method_supported_impl (GstDeinterlaceMethodClass * klass,
       return (klass->deinterlace_frame_rgb != NULL);
     case GST_VIDEO_FORMAT_BGR:
       return (klass->deinterlace_frame_bgr != NULL);
+    case GST_VIDEO_FORMAT_I420_10LE:
+    case GST_VIDEO_FORMAT_I420_12LE:
+    case GST_VIDEO_FORMAT_I422_10LE:
+    case GST_VIDEO_FORMAT_I422_12LE:
+    case GST_VIDEO_FORMAT_Y444_10LE:
+    case GST_VIDEO_FORMAT_Y444_12LE:
+      return (klass->deinterlace_frame_planar_16 != NULL);
+    case GST_VIDEO_FORMAT_P010_10LE:
+      return (klass->deinterlace_frame_p010 != NULL);
     default:
       return FALSE;
   }
@@ -171,15 +180,41 @@ gst_deinterlace_method_setup_impl (GstDeinterlaceMethod * self,
     case GST_VIDEO_FORMAT_BGR:
       self->deinterlace_frame = klass->deinterlace_frame_bgr;
       break;
+    case GST_VIDEO_FORMAT_I420_10LE:
+    case GST_VIDEO_FORMAT_I420_12LE:
+    case GST_VIDEO_FORMAT_I422_10LE:
+    case GST_VIDEO_FORMAT_I422_12LE:
+    case GST_VIDEO_FORMAT_Y444_10LE:
+    case GST_VIDEO_FORMAT_Y444_12LE:
+      self->deinterlace_frame = klass->deinterlace_frame_planar_16;
+      break;
+    case GST_VIDEO_FORMAT_P010_10LE:
+      self->deinterlace_frame = klass->deinterlace_frame_p010;
+      break;
     default:
       self->deinterlace_frame = NULL;
       break;
   }
 }
 
+static void
+gst_deinterlace_method_finalize (GObject * object)
+{
+  GstDeinterlaceMethod *self = GST_DEINTERLACE_METHOD (object);
+
+  if (self->slice_pool)
+    g_thread_pool_free (self->slice_pool, FALSE, TRUE);
+
+  G_OBJECT_CLASS (gst_deinterlace_method_parent_class)->finalize (object);
+}
+
 static void
 gst_deinterlace_method_class_init (GstDeinterlaceMethodClass * klass)
 {
+  GObjectClass *gobject_class = (GObjectClass *) klass;
+
+  gobject_class->finalize = gst_deinterlace_method_finalize;
+
   klass->setup = gst_deinterlace_method_setup_impl;
   klass->supported = gst_deinterlace_method_supported_impl;
 }
@@ -188,6 +223,7 @@ static void
 gst_deinterlace_method_init (GstDeinterlaceMethod * self)
 {
   self->vinfo = NULL;
+  self->n_threads = 1;
 }
 
 void
@@ -216,6 +252,120 @@ gst_deinterlace_method_get_latency (GstDeinterlaceMethod * self)
   return klass->latency;
 }
 
+/* Can be called from any thread, takes effect with the next frame */
+void
+gst_deinterlace_method_set_n_threads (GstDeinterlaceMethod * self,
+    guint n_threads)
+{
+  g_atomic_int_set (&self->n_threads, MIN (n_threads, G_MAXINT));
+}
+
+/* Don't bother splitting frames into bands of fewer lines than this */
+#define MIN_SLICE_HEIGHT 16
+
+typedef struct
+{
+  GstDeinterlaceMethod *self;
+  GstDeinterlaceMethodDeinterlaceSliceFunction func;
+  const GstDeinterlaceField *history;
+  guint history_count;
+  GstVideoFrame *outframe;
+  gint cur_field_idx;
+  guint n_slices;
+
+  GMutex lock;
+  GCond cond;
+  guint n_pending;
+} SliceJob;
+
+typedef struct
+{
+  SliceJob *job;
+  guint slice;
+} SliceTask;
+
+static void
+gst_deinterlace_method_slice_thread_func (SliceTask * task, gpointer user_data)
+{
+  SliceJob *job = task->job;
+
+  job->func (job->self, job->history, job->history_count, job->outframe,
+      job->cur_field_idx, task->slice, job->n_slices);
+
+  g_mutex_lock (&job->lock);
+  if (--job->n_pending == 0)
+    g_cond_signal (&job->cond);
+  g_mutex_unlock (&job->lock);
+}
+
+/* Splits the output frame into horizontal bands and runs @func on them in
+ * parallel, with the calling thread handling the first band. Bands only
+ * write their own output lines and only read from the field history, so
+ * they don't depend on each other. Must only be called from the streaming
+ * thread. */
+void
+gst_deinterlace_method_deinterlace_slices (GstDeinterlaceMethod * self,
+    GstDeinterlaceMethodDeinterlaceSliceFunction func,
+    const GstDeinterlaceField * history, guint history_count,
+    GstVideoFrame * outframe, int cur_field_idx)
+{
+  SliceJob job;
+  SliceTask *tasks;
+  guint n_threads, n_slices, i;
+
+  n_threads = g_atomic_int_get (&self->n_threads);
+  if (n_threads == 0)
+    n_threads = g_get_num_processors ();
+
+  n_slices = MIN (n_threads,
+      MAX (GST_VIDEO_FRAME_HEIGHT (outframe) / MIN_SLICE_HEIGHT, 1));
+
+  if (n_slices > 1) {
+    if (self->slice_pool == NULL) {
+      self->slice_pool =
+          g_thread_pool_new ((GFunc) gst_deinterlace_method_slice_thread_func,
+          NULL, n_slices - 1, TRUE, NULL);
+    } else if (g_thread_pool_get_max_threads (self->slice_pool) <
+        (gint) n_slices - 1) {
+      g_thread_pool_set_max_threads (self->slice_pool, n_slices - 1, NULL);
+    }
+  }
+
+  if (n_slices <= 1 || self->slice_pool == NULL) {
+    func (self, history, history_count, outframe, cur_field_idx, 0, 1);
+    return;
+  }
+
+  job.self = self;
+  job.func = func;
+  job.history = history;
+  job.history_count = history_count;
+  job.outframe = outframe;
+  job.cur_field_idx = cur_field_idx;
+  job.n_slices = n_slices;
+  g_mutex_init (&job.lock);
+  g_cond_init (&job.cond);
+  job.n_pending = n_slices - 1;
+
+  tasks = g_new (SliceTask, n_slices - 1);
+  for (i = 1; i < n_slices; i++) {
+    tasks[i - 1].job = &job;
+    tasks[i - 1].slice = i;
+    g_thread_pool_push (self->slice_pool, &tasks[i - 1], NULL);
+  }
+
+  func (self, history, history_count, outframe, cur_field_idx, 0, n_slices);
+
+  g_mutex_lock (&job.lock);
+  while (job.n_pending > 0)
+    g_cond_wait (&job.cond, &job.lock);
+  g_mutex_unlock (&job.lock);
+
+  g_free (tasks);
+  g_mutex_clear (&job.lock);
+  g_cond_clear (&job.cond);
+}
+
 G_DEFINE_ABSTRACT_TYPE (GstDeinterlaceSimpleMethod,
     gst_deinterlace_simple_method, GST_TYPE_DEINTERLACE_METHOD);
 
@@ -287,6 +437,23 @@ gst_deinterlace_simple_method_supported (GstDeinterlaceMethodClass * mklass,
           && klass->copy_scanline_planar_u != NULL &&
           klass->interpolate_scanline_planar_v != NULL
           && klass->copy_scanline_planar_v != NULL);
+    case GST_VIDEO_FORMAT_P010_10LE:
+      return (klass->interpolate_scanline_p010 != NULL
+          && klass->copy_scanline_p010 != NULL
+          && klass->interpolate_scanline_planar_y_16 != NULL
+          && klass->copy_scanline_planar_y_16 != NULL);
+    case GST_VIDEO_FORMAT_I420_10LE:
+    case GST_VIDEO_FORMAT_I420_12LE:
+    case GST_VIDEO_FORMAT_I422_10LE:
+    case GST_VIDEO_FORMAT_I422_12LE:
+    case GST_VIDEO_FORMAT_Y444_10LE:
+    case GST_VIDEO_FORMAT_Y444_12LE:
+      return (klass->interpolate_scanline_planar_y_16 != NULL
+          && klass->copy_scanline_planar_y_16 != NULL &&
+          klass->interpolate_scanline_planar_u_16 != NULL
+          && klass->copy_scanline_planar_u_16 != NULL &&
+          klass->interpolate_scanline_planar_v_16 != NULL
+          && klass->copy_scanline_planar_v_16 != NULL);
     default:
       return FALSE;
   }
@@ -352,9 +519,9 @@ get_line (LinesGetter * lg, gint field_offset, guint plane, gint line,
 }
 
 static void
-gst_deinterlace_simple_method_deinterlace_frame_packed (GstDeinterlaceMethod *
+gst_deinterlace_simple_method_deinterlace_slice_packed (GstDeinterlaceMethod *
     method, const GstDeinterlaceField * history, guint history_count,
-    GstVideoFrame * outframe, gint cur_field_idx)
+    GstVideoFrame * outframe, gint cur_field_idx, guint slice, guint n_slices)
 {
   GstDeinterlaceSimpleMethod *self = GST_DEINTERLACE_SIMPLE_METHOD (method);
 #ifndef G_DISABLE_ASSERT
@@ -362,7 +529,7 @@ gst_deinterlace_simple_method_deinterlace_frame_packed (GstDeinterlaceMethod *
 #endif
   GstDeinterlaceScanlineData scanlines;
   guint cur_field_flags;
-  gint i;
+  gint i, start, end;
   gint frame_height, frame_width;
   LinesGetter lg = { history, history_count, cur_field_idx };
   GstVideoFrame *framep, *frame0, *frame1, *frame2;
@@ -398,7 +565,10 @@ gst_deinterlace_simple_method_deinterlace_frame_packed (GstDeinterlaceMethod *
 #define LINE(x,i) (((guint8*)GST_VIDEO_FRAME_PLANE_DATA((x),0)) + i * \
     GST_VIDEO_FRAME_PLANE_STRIDE((x),0))
 
-  for (i = 0; i < frame_height; i++) {
+  start = frame_height * slice / n_slices;
+  end = frame_height * (slice + 1) / n_slices;
+
+  for (i = start; i < end; i++) {
     memset (&scanlines, 0, sizeof (scanlines));
     scanlines.bottom_field = (cur_field_flags == PICTURE_INTERLACED_BOTTOM);
 
@@ -446,6 +616,16 @@ gst_deinterlace_simple_method_deinterlace_frame_packed (GstDeinterlaceMethod *
   }
 }
 
+static void
+gst_deinterlace_simple_method_deinterlace_frame_packed (GstDeinterlaceMethod *
+    method, const GstDeinterlaceField * history, guint history_count,
+    GstVideoFrame * outframe, gint cur_field_idx)
+{
+  gst_deinterlace_method_deinterlace_slices (method,
+      gst_deinterlace_simple_method_deinterlace_slice_packed, history,
+      history_count, outframe, cur_field_idx);
+}
+
 static void
     gst_deinterlace_simple_method_interpolate_scanline_planar_y
     (GstDeinterlaceSimpleMethod * self, guint8 * out,
@@ -500,10 +680,11 @@ static void
     LinesGetter * lg,
     guint cur_field_flags, gint plane,
     GstDeinterlaceSimpleMethodFunction copy_scanline,
-    GstDeinterlaceSimpleMethodFunction interpolate_scanline)
+    GstDeinterlaceSimpleMethodFunction interpolate_scanline,
+    guint slice, guint n_slices)
 {
   GstDeinterlaceScanlineData scanlines;
-  gint i;
+  gint i, start, end;
   gint frame_height, frame_width;
 
   frame_height = GST_VIDEO_FRAME_COMP_HEIGHT (dest, plane);
@@ -516,7 +697,10 @@ static void
 #define LINE(x,i) (((guint8*)GST_VIDEO_FRAME_PLANE_DATA((x),plane)) + i * \
     GST_VIDEO_FRAME_PLANE_STRIDE((x),plane))
 
-  for (i = 0; i < frame_height; i++) {
+  start = frame_height * slice / n_slices;
+  end = frame_height * (slice + 1) / n_slices;
+
+  for (i = start; i < end; i++) {
     memset (&scanlines, 0, sizeof (scanlines));
     scanlines.bottom_field = (cur_field_flags == PICTURE_INTERLACED_BOTTOM);
 
@@ -563,9 +747,9 @@ static void
 }
 
 static void
-gst_deinterlace_simple_method_deinterlace_frame_planar (GstDeinterlaceMethod *
+gst_deinterlace_simple_method_deinterlace_slice_planar (GstDeinterlaceMethod *
     method, const GstDeinterlaceField * history, guint history_count,
-    GstVideoFrame * outframe, gint cur_field_idx)
+    GstVideoFrame * outframe, gint cur_field_idx, guint slice, guint n_slices)
 {
   GstDeinterlaceSimpleMethod *self = GST_DEINTERLACE_SIMPLE_METHOD (method);
 #ifndef G_DISABLE_ASSERT
@@ -590,14 +774,25 @@ gst_deinterlace_simple_method_deinterlace_frame_planar (GstDeinterlaceMethod *
     interpolate_scanline = self->interpolate_scanline_planar[i];
 
     gst_deinterlace_simple_method_deinterlace_frame_planar_plane (self,
-        outframe, &lg, cur_field_flags, i, copy_scanline, interpolate_scanline);
+        outframe, &lg, cur_field_flags, i, copy_scanline, interpolate_scanline,
+        slice, n_slices);
   }
 }
 
 static void
-gst_deinterlace_simple_method_deinterlace_frame_nv12 (GstDeinterlaceMethod *
+gst_deinterlace_simple_method_deinterlace_frame_planar (GstDeinterlaceMethod *
     method, const GstDeinterlaceField * history, guint history_count,
     GstVideoFrame * outframe, gint cur_field_idx)
+{
+  gst_deinterlace_method_deinterlace_slices (method,
+      gst_deinterlace_simple_method_deinterlace_slice_planar, history,
+      history_count, outframe, cur_field_idx);
+}
+
+static void
+gst_deinterlace_simple_method_deinterlace_slice_nv12 (GstDeinterlaceMethod *
+    method, const GstDeinterlaceField * history, guint history_count,
+    GstVideoFrame * outframe, gint cur_field_idx, guint slice, guint n_slices)
 {
   GstDeinterlaceSimpleMethod *self = GST_DEINTERLACE_SIMPLE_METHOD (method);
 #ifndef G_DISABLE_ASSERT
@@ -616,10 +811,22 @@ gst_deinterlace_simple_method_deinterlace_frame_nv12 (GstDeinterlaceMethod *
   /* Y plane first, then UV/VU plane */
   gst_deinterlace_simple_method_deinterlace_frame_planar_plane (self,
       outframe, &lg, cur_field_flags, 0,
-      self->copy_scanline_planar[0], self->interpolate_scanline_planar[0]);
+      self->copy_scanline_planar[0], self->interpolate_scanline_planar[0],
+      slice, n_slices);
   gst_deinterlace_simple_method_deinterlace_frame_planar_plane (self,
       outframe, &lg, cur_field_flags, 1,
-      self->copy_scanline_packed, self->interpolate_scanline_packed);
+      self->copy_scanline_packed, self->interpolate_scanline_packed,
+      slice, n_slices);
+}
+
+static void
+gst_deinterlace_simple_method_deinterlace_frame_nv12 (GstDeinterlaceMethod *
+    method, const GstDeinterlaceField * history, guint history_count,
+    GstVideoFrame * outframe, gint cur_field_idx)
+{
+  gst_deinterlace_method_deinterlace_slices (method,
+      gst_deinterlace_simple_method_deinterlace_slice_nv12, history,
+      history_count, outframe, cur_field_idx);
 }
 
 static void
@@ -720,6 +927,29 @@ gst_deinterlace_simple_method_setup (GstDeinterlaceMethod * method,
           klass->interpolate_scanline_planar_v;
       self->copy_scanline_planar[2] = klass->copy_scanline_planar_v;
       break;
+    case GST_VIDEO_FORMAT_P010_10LE:
+      self->interpolate_scanline_packed = klass->interpolate_scanline_p010;
+      self->copy_scanline_packed = klass->copy_scanline_p010;
+      self->interpolate_scanline_planar[0] =
+          klass->interpolate_scanline_planar_y_16;
+      self->copy_scanline_planar[0] = klass->copy_scanline_planar_y_16;
+      break;
+    case GST_VIDEO_FORMAT_I420_10LE:
+    case GST_VIDEO_FORMAT_I420_12LE:
+    case GST_VIDEO_FORMAT_I422_10LE:
+    case GST_VIDEO_FORMAT_I422_12LE:
+    case GST_VIDEO_FORMAT_Y444_10LE:
+    case GST_VIDEO_FORMAT_Y444_12LE:
+      self->interpolate_scanline_planar[0] =
+          klass->interpolate_scanline_planar_y_16;
+      self->copy_scanline_planar[0] = klass->copy_scanline_planar_y_16;
+      self->interpolate_scanline_planar[1] =
+          klass->interpolate_scanline_planar_u_16;
+      self->copy_scanline_planar[1] = klass->copy_scanline_planar_u_16;
+      self->interpolate_scanline_planar[2] =
+          klass->interpolate_scanline_planar_v_16;
+      self->copy_scanline_planar[2] = klass->copy_scanline_planar_v_16;
+      break;
     default:
       break;
   }
@@ -765,6 +995,10 @@ gst_deinterlace_simple_method_class_init (GstDeinterlaceSimpleMethodClass
       gst_deinterlace_simple_method_deinterlace_frame_nv12;
   dm_class->deinterlace_frame_nv21 =
       gst_deinterlace_simple_method_deinterlace_frame_nv12;
+  dm_class->deinterlace_frame_planar_16 =
+      gst_deinterlace_simple_method_deinterlace_frame_planar;
+  dm_class->deinterlace_frame_p010 =
+      gst_deinterlace_simple_method_deinterlace_frame_nv12;
   dm_class->fields_required = 2;
   dm_class->setup = gst_deinterlace_simple_method_setup;
   dm_class->supported = gst_deinterlace_simple_method_supported;
@@ -826,6 +1060,15 @@ gst_deinterlace_simple_method_class_init (GstDeinterlaceSimpleMethodClass
       gst_deinterlace_simple_method_interpolate_scanline_planar_v;
   klass->copy_scanline_planar_v =
       gst_deinterlace_simple_method_copy_scanline_planar_v;
+
+  klass->copy_scanline_p010 =
+      gst_deinterlace_simple_method_copy_scanline_packed;
+  klass->copy_scanline_planar_y_16 =
+      gst_deinterlace_simple_method_copy_scanline_planar_y;
+  klass->copy_scanline_planar_u_16 =
+      gst_deinterlace_simple_method_copy_scanline_planar_u;
+  klass->copy_scanline_planar_v_16 =
+      gst_deinterlace_simple_method_copy_scanline_planar_v;
 }
 
 static void
@@ -66,12 +66,23 @@ typedef void (*GstDeinterlaceMethodDeinterlaceFunction) (
     GstDeinterlaceMethod *self, const GstDeinterlaceField *history,
     guint history_count, GstVideoFrame *outframe, int cur_field_idx);
 
+/* Processes horizontal band @slice out of @n_slices of the output frame */
+typedef void (*GstDeinterlaceMethodDeinterlaceSliceFunction) (
+    GstDeinterlaceMethod *self, const GstDeinterlaceField *history,
+    guint history_count, GstVideoFrame *outframe, int cur_field_idx,
+    guint slice, guint n_slices);
+
 struct _GstDeinterlaceMethod {
   GstObject parent;
 
   GstVideoInfo *vinfo;
 
   GstDeinterlaceMethodDeinterlaceFunction deinterlace_frame;
+
+  /* Maximum number of threads to use, 0 for one per CPU. Atomic access */
+  gint n_threads;
+  /* Threads processing slices next to the streaming thread */
+  GThreadPool *slice_pool;
 };
 
 struct _GstDeinterlaceMethodClass {
@@ -101,6 +112,11 @@ struct _GstDeinterlaceMethodClass {
   GstDeinterlaceMethodDeinterlaceFunction deinterlace_frame_rgb;
   GstDeinterlaceMethodDeinterlaceFunction deinterlace_frame_bgr;
 
+  /* 10/12 bit little endian formats in 16 bit containers. planar_16 covers
+   * I420, I422 and Y444 */
+  GstDeinterlaceMethodDeinterlaceFunction deinterlace_frame_planar_16;
+  GstDeinterlaceMethodDeinterlaceFunction deinterlace_frame_p010;
+
   const gchar *name;
   const gchar *nick;
 };
@@ -113,6 +129,11 @@ void gst_deinterlace_method_deinterlace_frame (GstDeinterlaceMethod * self, cons
     int cur_field_idx);
 gint gst_deinterlace_method_get_fields_required (GstDeinterlaceMethod * self);
 gint gst_deinterlace_method_get_latency (GstDeinterlaceMethod * self);
+void gst_deinterlace_method_set_n_threads (GstDeinterlaceMethod * self, guint n_threads);
+void gst_deinterlace_method_deinterlace_slices (GstDeinterlaceMethod * self,
+    GstDeinterlaceMethodDeinterlaceSliceFunction func,
+    const GstDeinterlaceField * history, guint history_count,
+    GstVideoFrame * outframe, int cur_field_idx);
 
 #define GST_TYPE_DEINTERLACE_SIMPLE_METHOD		(gst_deinterlace_simple_method_get_type ())
 #define GST_IS_DEINTERLACE_SIMPLE_METHOD(obj)		(G_TYPE_CHECK_INSTANCE_TYPE ((obj), GST_TYPE_DEINTERLACE_SIMPLE_METHOD))
@@ -213,6 +234,18 @@ struct _GstDeinterlaceSimpleMethodClass {
   GstDeinterlaceSimpleMethodFunction interpolate_scanline_planar_u;
   GstDeinterlaceSimpleMethodFunction copy_scanline_planar_v;
   GstDeinterlaceSimpleMethodFunction interpolate_scanline_planar_v;
+
+  /* 10/12 bit formats in 16 bit containers, size is in bytes. Copying
+   * defaults to memcpy(), but there is no default interpolation: only methods
+   * that handle 16 bit samples set these */
+  GstDeinterlaceSimpleMethodFunction interpolate_scanline_p010;
+  GstDeinterlaceSimpleMethodFunction copy_scanline_p010;
+  GstDeinterlaceSimpleMethodFunction copy_scanline_planar_y_16;
+  GstDeinterlaceSimpleMethodFunction interpolate_scanline_planar_y_16;
+  GstDeinterlaceSimpleMethodFunction copy_scanline_planar_u_16;
+  GstDeinterlaceSimpleMethodFunction interpolate_scanline_planar_u_16;
+  GstDeinterlaceSimpleMethodFunction copy_scanline_planar_v_16;
+  GstDeinterlaceSimpleMethodFunction interpolate_scanline_planar_v_16;
 };
 
 GType gst_deinterlace_simple_method_get_type (void);
@@ -82,6 +82,19 @@ deinterlace_scanline_linear_planar_v_c (GstDeinterlaceSimpleMethod * self,
   deinterlace_scanline_linear_c (self, out, scanlines->t0, scanlines->b0, size);
 }
 
+static void
+deinterlace_scanline_linear_16_c (GstDeinterlaceSimpleMethod * self,
+    guint8 * out, const GstDeinterlaceScanlineData * scanlines, guint size)
+{
+  guint16 *o = (guint16 *) out;
+  const guint16 *s1 = (const guint16 *) scanlines->t0;
+  const guint16 *s2 = (const guint16 *) scanlines->b0;
+  guint i;
+
+  for (i = 0; i < size / 2; i++)
+    o[i] = (s1[i] + s2[i] + 1) >> 1;
+}
+
 G_DEFINE_TYPE (GstDeinterlaceMethodLinear, gst_deinterlace_method_linear,
     GST_TYPE_DEINTERLACE_SIMPLE_METHOD);
 
@@ -116,6 +129,13 @@ gst_deinterlace_method_linear_class_init (GstDeinterlaceMethodLinearClass *
       deinterlace_scanline_linear_planar_u_c;
   dism_class->interpolate_scanline_planar_v =
       deinterlace_scanline_linear_planar_v_c;
+  dism_class->interpolate_scanline_p010 = deinterlace_scanline_linear_16_c;
+  dism_class->interpolate_scanline_planar_y_16 =
+      deinterlace_scanline_linear_16_c;
+  dism_class->interpolate_scanline_planar_u_16 =
+      deinterlace_scanline_linear_16_c;
+  dism_class->interpolate_scanline_planar_v_16 =
+      deinterlace_scanline_linear_16_c;
 
 }
 
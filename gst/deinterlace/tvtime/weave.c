@@ -165,6 +165,15 @@ gst_deinterlace_method_weave_class_init (GstDeinterlaceMethodWeaveClass * klass)
   dism_class->copy_scanline_planar_y = copy_scanline_planar_y;
   dism_class->copy_scanline_planar_u = copy_scanline_planar_u;
   dism_class->copy_scanline_planar_v = copy_scanline_planar_v;
+
+  /* Weaving only copies lines, so the sample size doesn't matter */
+  dism_class->interpolate_scanline_p010 = deinterlace_scanline_weave_packed;
+  dism_class->interpolate_scanline_planar_y_16 =
+      deinterlace_scanline_weave_planar_y;
+  dism_class->interpolate_scanline_planar_u_16 =
+      deinterlace_scanline_weave_planar_u;
+  dism_class->interpolate_scanline_planar_v_16 =
+      deinterlace_scanline_weave_planar_v;
 }
 
 static void
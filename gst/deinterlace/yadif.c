@@ -80,6 +80,14 @@ static void
 filter_scanline_yadif_semiplanar (GstDeinterlaceSimpleMethod * self,
     guint8 * out, const GstDeinterlaceScanlineData * scanlines, guint size);
 
+static void
+filter_scanline_yadif_planar_16 (GstDeinterlaceSimpleMethod * self,
+    guint8 * out, const GstDeinterlaceScanlineData * scanlines, guint size);
+
+static void
+filter_scanline_yadif_semiplanar_16 (GstDeinterlaceSimpleMethod * self,
+    guint8 * out, const GstDeinterlaceScanlineData * scanlines, guint size);
+
 static void
 filter_scanline_yadif_packed_4 (GstDeinterlaceSimpleMethod * self,
     guint8 * out, const GstDeinterlaceScanlineData * scanlines, guint size);
@@ -166,6 +174,10 @@ static void
   dism_class->copy_scanline_bgr = copy_scanline;
   dism_class->copy_scanline_nv12 = copy_scanline;
   dism_class->copy_scanline_nv21 = copy_scanline;
+  dism_class->copy_scanline_p010 = copy_scanline;
+  dism_class->copy_scanline_planar_y_16 = copy_scanline;
+  dism_class->copy_scanline_planar_u_16 = copy_scanline;
+  dism_class->copy_scanline_planar_v_16 = copy_scanline;
 
   dism_class->interpolate_scanline_planar_y = filter_scanline_yadif_planar;
   dism_class->interpolate_scanline_planar_u = filter_scanline_yadif_planar;
@@ -182,6 +194,13 @@ static void
   dism_class->interpolate_scanline_bgr = filter_scanline_yadif_packed_3;
   dism_class->interpolate_scanline_nv12 = filter_scanline_yadif_semiplanar;
   dism_class->interpolate_scanline_nv21 = filter_scanline_yadif_semiplanar;
+  dism_class->interpolate_scanline_p010 = filter_scanline_yadif_semiplanar_16;
+  dism_class->interpolate_scanline_planar_y_16 =
+      filter_scanline_yadif_planar_16;
+  dism_class->interpolate_scanline_planar_u_16 =
+      filter_scanline_yadif_planar_16;
+  dism_class->interpolate_scanline_planar_v_16 =
+      filter_scanline_yadif_planar_16;
 }
 
 #define FFABS(a) ABS(a)
@@ -455,6 +474,92 @@ filter_scanline_yadif_planar (GstDeinterlaceSimpleMethod * self,
         (void *) s.bbp, w - edge);
 }
 
+/* 10/12 bit samples in 16 bit containers. There's no assembly for these,
+ * the plain C loops below are left to the compiler to vectorize. */
+ALWAYS_INLINE static void
+filter_line_c_16 (guint16 * sdst, const guint16 * stzero,
+    const guint16 * sbzero, const guint16 * smone, const guint16 * smp,
+    const guint16 * sttwo, const guint16 * sbtwo, const guint16 * stptwo,
+    const guint16 * sbptwo, const guint16 * sttone, const guint16 * sttp,
+    const guint16 * sbbone, const guint16 * sbbp, int w, int colors,
+    int start, int end, int mode)
+{
+  int x;
+  const int y_alternates_every = 0;
+
+  FILTER (start, end, 1)
+}
+
+ALWAYS_INLINE static void
+filter_edges_16 (guint16 * sdst, const guint16 * stzero,
+    const guint16 * sbzero, const guint16 * smone, const guint16 * smp,
+    const guint16 * sttwo, const guint16 * sbtwo, const guint16 * stptwo,
+    const guint16 * sbptwo, const guint16 * sttone, const guint16 * sttp,
+    const guint16 * sbbone, const guint16 * sbbp, int w, int colors, int mode)
+{
+  int x;
+  const int y_alternates_every = 0;
+  const int edge = colors * (MAX_ALIGN / 2);
+  const int border = 3 * colors;
+
+  FILTER (0, border, 0)
+      FILTER (w - edge, w - border, 1)
+      FILTER (w - border, w, 0)
+}
+
+ALWAYS_INLINE static void
+filter_scanline_yadif_16 (GstDeinterlaceSimpleMethod * self,
+    guint8 * out, const GstDeinterlaceScanlineData * s_orig, guint size,
+    int colors)
+{
+  guint16 *dst = (guint16 *) out;
+  int w = size / 2;
+  int edge = colors * MAX_ALIGN / 2;
+  GstDeinterlaceScanlineData s = *s_orig;
+
+  int mode = (s.tt1 == NULL || s.bb1 == NULL || s.ttp == NULL
+      || s.bbp == NULL) ? 2 : 0;
+
+  /* When starting up, some data might not yet be available, so use the current frame */
+  if (s.m1 == NULL)
+    s.m1 = s.mp;
+  if (s.tt1 == NULL)
+    s.tt1 = s.ttp;
+  if (s.bb1 == NULL)
+    s.bb1 = s.bbp;
+  if (s.t2 == NULL)
+    s.t2 = s.tp2;
+  if (s.b2 == NULL)
+    s.b2 = s.bp2;
+
+  filter_edges_16 (dst, (const guint16 *) s.t0, (const guint16 *) s.b0,
+      (const guint16 *) s.m1, (const guint16 *) s.mp, (const guint16 *) s.t2,
+      (const guint16 *) s.b2, (const guint16 *) s.tp2,
+      (const guint16 *) s.bp2, (const guint16 *) s.tt1,
+      (const guint16 *) s.ttp, (const guint16 *) s.bb1,
+      (const guint16 *) s.bbp, w, colors, mode);
+  filter_line_c_16 (dst, (const guint16 *) s.t0, (const guint16 *) s.b0,
+      (const guint16 *) s.m1, (const guint16 *) s.mp, (const guint16 *) s.t2,
+      (const guint16 *) s.b2, (const guint16 *) s.tp2,
+      (const guint16 *) s.bp2, (const guint16 *) s.tt1,
+      (const guint16 *) s.ttp, (const guint16 *) s.bb1,
+      (const guint16 *) s.bbp, w, colors, colors * 3, w - edge, mode);
+}
+
+static void
+filter_scanline_yadif_planar_16 (GstDeinterlaceSimpleMethod * self,
+    guint8 * out, const GstDeinterlaceScanlineData * s_orig, guint size)
+{
+  filter_scanline_yadif_16 (self, out, s_orig, size, 1);
+}
+
+static void
+filter_scanline_yadif_semiplanar_16 (GstDeinterlaceSimpleMethod * self,
+    guint8 * out, const GstDeinterlaceScanlineData * s_orig, guint size)
+{
+  filter_scanline_yadif_16 (self, out, s_orig, size, 2);
+}
+
 static void
 gst_deinterlace_method_yadif_init (GstDeinterlaceMethodYadif * self)
 {
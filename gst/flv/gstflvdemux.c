@@ -91,9 +91,18 @@ GST_DEBUG_CATEGORY_STATIC (flvdemux_debug);
 enum
 {
   PROP_00, /* PROP_0 already used by included gstindex.c */
-  PROP_NO_MORE_PADS_THRESHOLD
+  PROP_NO_MORE_PADS_THRESHOLD,
+  PROP_SEEK_INDEX
 };
 
+/* serialised seek index: magic, version, then per entry the time, the byte
+ * position and flags, all big endian */
+#define SEEK_INDEX_MAGIC          GST_MAKE_FOURCC ('F', 'L', 'V', 'I')
+#define SEEK_INDEX_VERSION        1
+#define SEEK_INDEX_HEADER_SIZE    8
+#define SEEK_INDEX_ENTRY_SIZE     20
+#define SEEK_INDEX_FLAG_KEYFRAME  (1 << 0)
+
 #define gst_flv_demux_parent_class parent_class
 G_DEFINE_TYPE (GstFlvDemux, gst_flv_demux, GST_TYPE_ELEMENT);
 
@@ -125,21 +134,13 @@ static GstIndex *gst_flv_demux_get_index (GstElement * element);
 static void gst_flv_demux_push_tags (GstFlvDemux * demux);
 
 static void
-gst_flv_demux_parse_and_add_index_entry (GstFlvDemux * demux, GstClockTime ts,
+gst_flv_demux_add_index_entry (GstFlvDemux * demux, GstClockTime ts,
     guint64 pos, gboolean keyframe)
 {
   GstIndexAssociation associations[2];
   GstIndex *index;
   GstIndexEntry *entry;
 
-  GST_LOG_OBJECT (demux,
-      "adding key=%d association %" GST_TIME_FORMAT "-> %" G_GUINT64_FORMAT,
-      keyframe, GST_TIME_ARGS (ts), pos);
-
-  /* if upstream is not seekable there is no point in building an index */
-  if (!demux->upstream_seekable)
-    return;
-
   index = gst_flv_demux_get_index (GST_ELEMENT (demux));
 
   if (!index)
@@ -171,6 +172,9 @@ gst_flv_demux_parse_and_add_index_entry (GstFlvDemux * demux, GstClockTime ts,
   associations[1].format = GST_FORMAT_BYTES;
   associations[1].value = pos;
 
+  /* entries are only added from the streaming thread, or before it is
+   * started, but the index is also read by the seek-index property */
+  GST_OBJECT_LOCK (demux);
   gst_index_add_associationv (index, demux->index_id,
       (keyframe) ? GST_ASSOCIATION_FLAG_KEY_UNIT :
       GST_ASSOCIATION_FLAG_DELTA_UNIT, 2,
@@ -180,10 +184,129 @@ gst_flv_demux_parse_and_add_index_entry (GstFlvDemux * demux, GstClockTime ts,
     demux->index_max_pos = pos;
   if (ts > demux->index_max_time)
     demux->index_max_time = ts;
+  GST_OBJECT_UNLOCK (demux);
 
   gst_object_unref (index);
 }
 
+static void
+gst_flv_demux_parse_and_add_index_entry (GstFlvDemux * demux, GstClockTime ts,
+    guint64 pos, gboolean keyframe)
+{
+  GST_LOG_OBJECT (demux,
+      "adding key=%d association %" GST_TIME_FORMAT "-> %" G_GUINT64_FORMAT,
+      keyframe, GST_TIME_ARGS (ts), pos);
+
+  /* if upstream is not seekable there is no point in building an index */
+  if (!demux->upstream_seekable)
+    return;
+
+  gst_flv_demux_add_index_entry (demux, ts, pos, keyframe);
+}
+
+static GBytes *
+gst_flv_demux_export_index (GstFlvDemux * demux)
+{
+  GstByteWriter bw;
+  GList *l;
+
+  gst_byte_writer_init (&bw);
+  gst_byte_writer_put_uint32_le (&bw, SEEK_INDEX_MAGIC);
+  gst_byte_writer_put_uint32_be (&bw, SEEK_INDEX_VERSION);
+
+  GST_OBJECT_LOCK (demux);
+  /* only our own index can be walked */
+  if (demux->index && demux->own_index) {
+    GstMemIndex *memindex = GST_MEM_INDEX (demux->index);
+
+    for (l = memindex->associations; l; l = l->next) {
+      GstIndexEntry *entry = l->data;
+      gint64 time, bytes;
+
+      if (entry->type != GST_INDEX_ENTRY_ASSOCIATION ||
+          entry->id != demux->index_id)
+        continue;
+      if (!gst_index_entry_assoc_map (entry, GST_FORMAT_TIME, &time) ||
+          !gst_index_entry_assoc_map (entry, GST_FORMAT_BYTES, &bytes))
+        continue;
+
+      gst_byte_writer_put_uint64_be (&bw, time);
+      gst_byte_writer_put_uint64_be (&bw, bytes);
+      gst_byte_writer_put_uint32_be (&bw, (GST_INDEX_ASSOC_FLAGS (entry) &
+              GST_ASSOCIATION_FLAG_KEY_UNIT) ? SEEK_INDEX_FLAG_KEYFRAME : 0);
+    }
+  }
+  GST_OBJECT_UNLOCK (demux);
+
+  return gst_byte_writer_reset_and_get_bytes (&bw);
+}
+
+static void
+gst_flv_demux_import_index (GstFlvDemux * demux, GBytes * bytes)
+{
+  const guint8 *data;
+  gsize size;
+
+  data = g_bytes_get_data (bytes, &size);
+  if (size < SEEK_INDEX_HEADER_SIZE
+      || GST_READ_UINT32_LE (data) != SEEK_INDEX_MAGIC
+      || GST_READ_UINT32_BE (data + 4) != SEEK_INDEX_VERSION) {
+    GST_WARNING_OBJECT (demux, "Ignoring invalid seek index");
+    return;
+  }
+
+  data += SEEK_INDEX_HEADER_SIZE;
+  size -= SEEK_INDEX_HEADER_SIZE;
+
+  GST_DEBUG_OBJECT (demux, "importing %" G_GSIZE_FORMAT " index entries",
+      size / SEEK_INDEX_ENTRY_SIZE);
+
+  while (size >= SEEK_INDEX_ENTRY_SIZE) {
+    gst_flv_demux_add_index_entry (demux, GST_READ_UINT64_BE (data),
+        GST_READ_UINT64_BE (data + 8),
+        GST_READ_UINT32_BE (data + 16) & SEEK_INDEX_FLAG_KEYFRAME);
+    data += SEEK_INDEX_ENTRY_SIZE;
+    size -= SEEK_INDEX_ENTRY_SIZE;
+  }
+}
+
+/* import a seek index that was set while running, from the streaming
+ * thread so that it is the only one adding entries */
+static void
+gst_flv_demux_import_pending_index (GstFlvDemux * demux)
+{
+  GBytes *bytes = NULL;
+
+  GST_OBJECT_LOCK (demux);
+  if (G_UNLIKELY (demux->import_pending)) {
+    if (demux->imported_index)
+      bytes = g_bytes_ref (demux->imported_index);
+    demux->import_pending = FALSE;
+  }
+  GST_OBJECT_UNLOCK (demux);
+
+  if (bytes) {
+    gst_flv_demux_import_index (demux, bytes);
+    g_bytes_unref (bytes);
+  }
+}
+
+/* whether the index entries imported or read so far already reach the
+ * start of @seek, so that a push mode seek doesn't need to scan the file.
+ * Must be called with the object lock */
+static gboolean
+gst_flv_demux_index_covers_seek (GstFlvDemux * demux, GstEvent * seek)
+{
+  GstSeekType start_type;
+  gint64 start;
+
+  gst_event_parse_seek (seek, NULL, NULL, NULL, &start_type, &start, NULL,
+      NULL);
+
+  return demux->index_max_pos > 0 && start_type == GST_SEEK_TYPE_SET &&
+      start >= 0 && start <= demux->index_max_time;
+}
+
 static gchar *
 FLV_GET_STRING (GstByteReader * reader)
 {
@@ -2157,6 +2280,8 @@ gst_flv_demux_chain (GstPad * pad, GstObject * parent, GstBuffer * buffer)
 
   demux = GST_FLV_DEMUX (parent);
 
+  gst_flv_demux_import_pending_index (demux);
+
   GST_LOG_OBJECT (demux,
       "received buffer of %" G_GSIZE_FORMAT " bytes at offset %"
       G_GUINT64_FORMAT, gst_buffer_get_size (buffer),
@@ -2310,10 +2435,20 @@ parse:
     case FLV_STATE_SEEK:
     {
       GstEvent *event;
+      gboolean covered;
 
       ret = GST_FLOW_OK;
 
-      if (!demux->indexed) {
+      /* a seek index set meanwhile was imported at the start of chain() and
+       * might make scanning for the index unnecessary */
+      GST_OBJECT_LOCK (demux);
+      covered = demux->seek_event
+          && gst_flv_demux_index_covers_seek (demux, demux->seek_event);
+      if (covered)
+        demux->building_index = FALSE;
+      GST_OBJECT_UNLOCK (demux);
+
+      if (!demux->indexed && !covered) {
         if (demux->offset == demux->file_size - sizeof (guint32)) {
           guint64 seek_offset;
           guint8 *data;
@@ -2710,6 +2845,8 @@ gst_flv_demux_loop (GstPad * pad)
 
   demux = GST_FLV_DEMUX (gst_pad_get_parent (pad));
 
+  gst_flv_demux_import_pending_index (demux);
+
   /* pull in data */
   switch (demux->state) {
     case FLV_STATE_TAG_TYPE:
@@ -2980,6 +3117,7 @@ static gboolean
 gst_flv_demux_handle_seek_push (GstFlvDemux * demux, GstEvent * event)
 {
   GstFormat format;
+  gboolean covered;
 
   gst_event_parse_seek (event, NULL, &format, NULL, NULL, NULL, NULL, NULL);
 
@@ -2996,7 +3134,11 @@ gst_flv_demux_handle_seek_push (GstFlvDemux * demux, GstEvent * event)
     return TRUE;
   }
 
-  if (!demux->indexed) {
+  GST_OBJECT_LOCK (demux);
+  covered = gst_flv_demux_index_covers_seek (demux, event);
+  GST_OBJECT_UNLOCK (demux);
+
+  if (!demux->indexed && !covered) {
     guint64 seek_offset = 0;
     gboolean building_index;
 
@@ -3086,6 +3228,10 @@ gst_flv_demux_handle_seek_pull (GstFlvDemux * demux, GstEvent * event,
   /* Take the stream lock */
   GST_PAD_STREAM_LOCK (demux->sinkpad);
 
+  /* the streaming thread is stopped, so a seek index that was set meanwhile
+   * can be used for this seek already */
+  gst_flv_demux_import_pending_index (demux);
+
   if (flush) {
     /* Stop flushing upstream we need to pull */
     gst_pad_push_event (demux->sinkpad, gst_event_new_flush_stop (TRUE));
@@ -3565,27 +3711,42 @@ gst_flv_demux_change_state (GstElement * element, GstStateChange transition)
   demux = GST_FLV_DEMUX (element);
 
   switch (transition) {
-    case GST_STATE_CHANGE_READY_TO_PAUSED:
+    case GST_STATE_CHANGE_READY_TO_PAUSED:{
+      GstIndex *index = NULL;
+
       /* If this is our own index destroy it as the
        * old entries might be wrong for the new stream */
+      GST_OBJECT_LOCK (demux);
       if (demux->own_index) {
-        gst_object_unref (demux->index);
+        index = demux->index;
         demux->index = NULL;
         demux->own_index = FALSE;
       }
+      GST_OBJECT_UNLOCK (demux);
+      if (index)
+        gst_object_unref (index);
 
       /* If no index was created, generate one */
       if (G_UNLIKELY (!demux->index)) {
         GST_DEBUG_OBJECT (demux, "no index provided creating our own");
 
-        demux->index = g_object_new (gst_mem_index_get_type (), NULL);
+        index = g_object_new (gst_mem_index_get_type (), NULL);
+        gst_index_get_writer_id (index, GST_OBJECT (demux), &demux->index_id);
 
-        gst_index_get_writer_id (demux->index, GST_OBJECT (demux),
-            &demux->index_id);
+        GST_OBJECT_LOCK (demux);
+        demux->index = index;
         demux->own_index = TRUE;
+        GST_OBJECT_UNLOCK (demux);
       }
       gst_flv_demux_cleanup (demux);
+
+      /* the streaming thread isn't running yet, import right away */
+      GST_OBJECT_LOCK (demux);
+      demux->import_pending = demux->imported_index != NULL;
+      GST_OBJECT_UNLOCK (demux);
+      gst_flv_demux_import_pending_index (demux);
       break;
+    }
     default:
       break;
   }
@@ -3664,6 +3825,9 @@ gst_flv_demux_get_property (GObject * object,
     case PROP_NO_MORE_PADS_THRESHOLD:
       g_value_set_int64 (value, demux->no_more_pads_threshold);
       break;
+    case PROP_SEEK_INDEX:
+      g_value_take_boxed (value, gst_flv_demux_export_index (demux));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -3680,6 +3844,19 @@ gst_flv_demux_set_property (GObject * object,
     case PROP_NO_MORE_PADS_THRESHOLD:
       demux->no_more_pads_threshold = g_value_get_int64 (value);
       break;
+    case PROP_SEEK_INDEX:{
+      GBytes *bytes = g_value_dup_boxed (value);
+
+      /* imported when the index is created, or by the streaming thread
+       * when it is already running */
+      GST_OBJECT_LOCK (demux);
+      if (demux->imported_index)
+        g_bytes_unref (demux->imported_index);
+      demux->imported_index = bytes;
+      demux->import_pending = bytes != NULL && demux->index != NULL;
+      GST_OBJECT_UNLOCK (demux);
+      break;
+    }
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -3749,6 +3926,11 @@ gst_flv_demux_dispose (GObject * object)
     demux->index = NULL;
   }
 
+  if (demux->imported_index) {
+    g_bytes_unref (demux->imported_index);
+    demux->imported_index = NULL;
+  }
+
   if (demux->times) {
     g_array_free (demux->times, TRUE);
     demux->times = NULL;
@@ -3796,6 +3978,21 @@ gst_flv_demux_class_init (GstFlvDemuxClass * klass)
           "have video, or vice versa (-1 waits forever)",
           -1, G_MAXINT64, DEFAULT_NO_MORE_PADS_THRESHOLD,
           G_PARAM_CONSTRUCT | G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstFlvDemux:seek-index:
+   *
+   * Seek index built so far from the file metadata and the tags that were
+   * read. An application can store it and set it again when the same file
+   * is opened later, so that seeking doesn't need to scan the file again.
+   *
+   * Since: 1.18
+   */
+  g_object_class_install_property (gobject_class, PROP_SEEK_INDEX,
+      g_param_spec_boxed ("seek-index", "Seek index",
+          "Serialised seek index, can be set again for the same file to "
+          "avoid scanning it when seeking", G_TYPE_BYTES,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 }
 
 static void
@@ -69,6 +69,8 @@ struct _GstFlvDemux
   GstIndex *index;
   gint index_id;
   gboolean own_index;
+  GBytes *imported_index;
+  gboolean import_pending;
   
   GArray * times;
   GArray * filepositions;
@@ -1163,10 +1163,10 @@ gst_flv_mux_buffer_to_tag_internal (GstFlvMux * mux, GstBuffer * buffer,
     GstFlvMuxPad * pad, gboolean is_codec_data)
 {
   GstBuffer *tag;
-  GstMapInfo map;
-  guint size;
+  GstMemory *mem;
+  guint size, hsize;
   guint64 pts, dts, cts;
-  guint8 *data, *bdata = NULL;
+  guint8 *data;
   gsize bsize = 0;
 
   if (GST_CLOCK_STIME_IS_VALID (pad->dts)) {
@@ -1212,30 +1212,26 @@ gst_flv_mux_buffer_to_tag_internal (GstFlvMux * mux, GstBuffer * buffer,
         G_GUINT64_FORMAT ", new:%u)", dts, (guint32) dts);
   }
 
-  if (buffer != NULL) {
-    gst_buffer_map (buffer, &map, GST_MAP_READ);
-    bdata = map.data;
-    bsize = map.size;
-  }
+  if (buffer != NULL)
+    bsize = gst_buffer_get_size (buffer);
 
-  size = 11;
+  /* tag header and audio/video specific header, the payload is appended to
+   * the tag as is, followed by the previous tag size. Header and previous
+   * tag size share one allocation */
+  hsize = 11;
   if (mux->video_pad == pad) {
-    size += 1;
+    hsize += 1;
     if (pad->codec == 7)
-      size += 4 + bsize;
-    else
-      size += bsize;
+      hsize += 4;
   } else {
-    size += 1;
+    hsize += 1;
     if (pad->codec == 10)
-      size += 1 + bsize;
-    else
-      size += bsize;
+      hsize += 1;
   }
-  size += 4;
+  size = hsize + bsize + 4;
 
-  _gst_buffer_new_and_alloc (size, &tag, &data);
-  memset (data, 0, size);
+  data = g_malloc0 (hsize + 4);
+  mem = gst_memory_new_wrapped (0, data, hsize + 4, 0, hsize + 4, data, g_free);
 
   data[0] = (mux->video_pad == pad) ? 9 : 8;
 
@@ -1269,9 +1265,6 @@ gst_flv_mux_buffer_to_tag_internal (GstFlvMux * mux, GstBuffer * buffer,
         data[12] = 1;
         GST_WRITE_UINT24_BE (data + 13, cts);
       }
-      memcpy (data + 11 + 1 + 4, bdata, bsize);
-    } else {
-      memcpy (data + 11 + 1, bdata, bsize);
     }
   } else {
     data[11] |= (pad->codec << 4) & 0xf0;
@@ -1283,19 +1276,22 @@ gst_flv_mux_buffer_to_tag_internal (GstFlvMux * mux, GstBuffer * buffer,
         "codec:%d, rate:%d, width:%d, channels:%d",
         data[11], pad->codec, pad->rate, pad->width, pad->channels);
 
-    if (pad->codec == 10) {
+    if (pad->codec == 10)
       data[12] = is_codec_data ? 0 : 1;
-
-      memcpy (data + 11 + 1 + 1, bdata, bsize);
-    } else {
-      memcpy (data + 11 + 1, bdata, bsize);
-    }
   }
 
-  if (buffer)
-    gst_buffer_unmap (buffer, &map);
+  GST_WRITE_UINT32_BE (data + hsize, size - 4);
 
-  GST_WRITE_UINT32_BE (data + size - 4, size - 4);
+  /* share the payload memory instead of copying it */
+  tag = gst_buffer_new ();
+  if (bsize > 0) {
+    gst_buffer_append_memory (tag, gst_memory_share (mem, 0, hsize));
+    gst_buffer_copy_into (tag, buffer, GST_BUFFER_COPY_MEMORY, 0, -1);
+    gst_buffer_append_memory (tag, gst_memory_share (mem, hsize, 4));
+    gst_memory_unref (mem);
+  } else {
+    gst_buffer_append_memory (tag, mem);
+  }
 
   GST_BUFFER_PTS (tag) = GST_CLOCK_TIME_NONE;
   GST_BUFFER_DTS (tag) = GST_CLOCK_TIME_NONE;
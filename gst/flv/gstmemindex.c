@@ -56,6 +56,8 @@
  *
  * The MemIndexFormatIndex keeps all the values of the particular
  * format in a GTree, The values of the GTree point back to the entry.
+ * Key unit entries are additionally kept in a second GTree so that
+ * looking up the nearest keyframe doesn't need a linear search.
  *
  * Finding a value for an id/format requires locating the correct GTree,
  * then do a lookup in the Tree to get the required value.
@@ -66,6 +68,7 @@ typedef struct
   GstFormat format;
   gint offset;
   GTree *tree;
+  GTree *key_tree;
 }
 GstMemIndexFormatIndex;
 
@@ -141,6 +144,9 @@ gst_mem_index_free_format (gpointer key, gpointer value, gpointer user_data)
   if (index->tree) {
     g_tree_destroy (index->tree);
   }
+  if (index->key_tree) {
+    g_tree_destroy (index->key_tree);
+  }
 
   g_slice_free (GstMemIndexFormatIndex, index);
 }
@@ -231,11 +237,14 @@ gst_mem_index_index_format (GstMemIndexId * id_index, GstIndexEntry * entry,
     index->format = *format;
     index->offset = assoc;
     index->tree = g_tree_new_with_data (mem_index_compare, index);
+    index->key_tree = g_tree_new_with_data (mem_index_compare, index);
 
     g_hash_table_insert (id_index->format_index, &index->format, index);
   }
 
   g_tree_insert (index->tree, entry, entry);
+  if (GST_INDEX_ASSOC_FLAGS (entry) & GST_INDEX_ASSOCIATION_FLAG_KEY_UNIT)
+    g_tree_insert (index->key_tree, entry, entry);
 }
 
 static void
@@ -348,6 +357,7 @@ gst_mem_index_get_assoc_entry (GstIndex * index, gint id,
   GstMemIndexFormatIndex *format_index;
   GstIndexEntry *entry;
   GstMemIndexSearchData data;
+  GTree *tree;
 
   id_index = g_hash_table_lookup (memindex->id_index, &id);
   if (!id_index)
@@ -370,7 +380,13 @@ gst_mem_index_get_assoc_entry (GstIndex * index, gint id,
     data.higher = NULL;
   }
 
-  entry = g_tree_search (format_index->tree, mem_index_search, &data);
+  /* all entries of the key unit tree match, no need to look further */
+  if (flags == GST_INDEX_ASSOCIATION_FLAG_KEY_UNIT)
+    tree = format_index->key_tree;
+  else
+    tree = format_index->tree;
+
+  entry = g_tree_search (tree, mem_index_search, &data);
 
   /* get the low/high values if we're not exact */
   if (entry == NULL && !data.exact) {
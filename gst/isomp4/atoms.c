@@ -2297,7 +2297,6 @@ atom_stsz_copy_data (AtomSTSZ * stsz, guint8 ** buffer, guint64 * size,
     guint64 * offset)
 {
   guint64 original_offset = *offset;
-  guint i;
 
   if (!atom_full_copy_data (&stsz->header, buffer, size, offset)) {
     return 0;
@@ -2306,14 +2305,10 @@ atom_stsz_copy_data (AtomSTSZ * stsz, guint8 ** buffer, guint64 * size,
   prop_copy_uint32 (stsz->sample_size, buffer, size, offset);
   prop_copy_uint32 (stsz->table_size, buffer, size, offset);
   if (stsz->sample_size == 0) {
-    /* minimize realloc */
-    prop_copy_ensure_buffer (buffer, size, offset, 4 * stsz->table_size);
     /* entry count must match sample count */
     g_assert (atom_array_get_len (&stsz->entries) == stsz->table_size);
-    for (i = 0; i < atom_array_get_len (&stsz->entries); i++) {
-      prop_copy_uint32 (atom_array_index (&stsz->entries, i), buffer, size,
-          offset);
-    }
+    prop_copy_uint32_array (stsz->entries.data,
+        atom_array_get_len (&stsz->entries), buffer, size, offset);
   }
 
   atom_write_size (buffer, size, offset, original_offset);
@@ -2450,7 +2445,6 @@ atom_stss_copy_data (AtomSTSS * stss, guint8 ** buffer, guint64 * size,
     guint64 * offset)
 {
   guint64 original_offset = *offset;
-  guint i;
 
   if (atom_array_get_len (&stss->entries) == 0) {
     /* FIXME not needing this atom might be confused with error while copying */
@@ -2462,13 +2456,8 @@ atom_stss_copy_data (AtomSTSS * stss, guint8 ** buffer, guint64 * size,
   }
 
   prop_copy_uint32 (atom_array_get_len (&stss->entries), buffer, size, offset);
-  /* minimize realloc */
-  prop_copy_ensure_buffer (buffer, size, offset,
-      4 * atom_array_get_len (&stss->entries));
-  for (i = 0; i < atom_array_get_len (&stss->entries); i++) {
-    prop_copy_uint32 (atom_array_index (&stss->entries, i), buffer, size,
-        offset);
-  }
+  prop_copy_uint32_array (stss->entries.data,
+      atom_array_get_len (&stss->entries), buffer, size, offset);
 
   atom_write_size (buffer, size, offset, original_offset);
   return *offset - original_offset;
@@ -4610,6 +4599,9 @@ atom_trun_copy_data (AtomTRUN * trun, guint8 ** buffer, guint64 * size,
   if (flags & TR_FIRST_SAMPLE_FLAGS)
     prop_copy_uint32 (trun->first_sample_flags, buffer, size, offset);
 
+  /* minimize realloc */
+  prop_copy_ensure_buffer (buffer, size, offset,
+      16 * atom_array_get_len (&trun->entries));
   for (i = 0; i < atom_array_get_len (&trun->entries); i++) {
     TRUNSampleEntry *entry = &atom_array_index (&trun->entries, i);
 
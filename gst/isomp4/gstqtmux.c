@@ -82,7 +82,11 @@
  * data can be spread out into fragments of #GstQTMux:fragment-duration.
  * If such fragmented layout is intended for streaming purposes, then
  * #GstQTMux:streamable allows foregoing to add index metadata (at the end of
- * file).
+ * file). For low-latency streaming (e.g. CMAF chunks for LL-HLS or LL-DASH),
+ * #GstQTMux:chunk-duration additionally splits each fragment into several
+ * moof/mdat pairs that are pushed downstream as soon as each one is
+ * complete. The last buffer of each chunk has the %GST_BUFFER_FLAG_MARKER
+ * flag set, so that downstream can send it out right away.
  *
  * When the maximum duration to be recorded can be known in advance, #GstQTMux
  * also supports a 'Robust Muxing' mode. In robust muxing mode,  space for the
@@ -110,6 +114,15 @@
  * a fixed sample size (such as raw audio and Prores Video) and that don't
  * have reordered samples.
  *
+ * When #GstQTMux:faststart is combined with #GstQTMux:reserved-max-duration
+ * and the output is seekable, the header space is reserved at the start of
+ * the file in the same way, and the media data is written directly to the
+ * output instead of to the #GstQTMux:faststart-file. The header is then
+ * written into the reserved space at the end, avoiding the copy of all the
+ * media data. If the reserved space turns out to be too small, the header is
+ * written at the end of the file and a warning is posted. Applications can
+ * monitor #GstQTMux:reserved-duration-remaining in this mode too.
+ *
  * ## Example pipelines
  * |[
  * gst-launch-1.0 v4l2src num-buffers=500 ! video/x-raw,width=320,height=240 ! videoconvert ! qtmux ! filesink location=video.mov
@@ -370,6 +383,7 @@ enum
   PROP_MAX_RAW_AUDIO_DRIFT,
   PROP_START_GAP_THRESHOLD,
   PROP_FORCE_CREATE_TIMECODE_TRAK,
+  PROP_CHUNK_DURATION,
 };
 
 /* some spare for header size as well */
@@ -396,6 +410,7 @@ enum
 #define DEFAULT_MAX_RAW_AUDIO_DRIFT 40 * GST_MSECOND
 #define DEFAULT_START_GAP_THRESHOLD 0
 #define DEFAULT_FORCE_CREATE_TIMECODE_TRAK FALSE
+#define DEFAULT_CHUNK_DURATION 0
 
 static void gst_qt_mux_finalize (GObject * object);
 
@@ -650,6 +665,13 @@ gst_qt_mux_class_init (GstQTMuxClass * klass)
           "Create a timecode trak even in unsupported flavors",
           DEFAULT_FORCE_CREATE_TIMECODE_TRAK,
           G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_STRINGS));
+  g_object_class_install_property (gobject_class, PROP_CHUNK_DURATION,
+      g_param_spec_uint ("chunk-duration", "Chunk duration",
+          "Split fragments into chunks (moof/mdat pairs) of this duration in "
+          "ms, each pushed as soon as it is complete (0 = disabled, "
+          "only used if fragment-duration > 0)",
+          0, G_MAXUINT32, DEFAULT_CHUNK_DURATION,
+          G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_STRINGS));
 
   gstelement_class->request_new_pad =
       GST_DEBUG_FUNCPTR (gst_qt_mux_request_new_pad);
@@ -875,6 +897,7 @@ gst_qt_mux_init (GstQTMux * qtmux, GstQTMuxClass * qtmux_klass)
   qtmux->max_raw_audio_drift = DEFAULT_MAX_RAW_AUDIO_DRIFT;
   qtmux->start_gap_threshold = DEFAULT_START_GAP_THRESHOLD;
   qtmux->force_create_timecode_trak = DEFAULT_FORCE_CREATE_TIMECODE_TRAK;
+  qtmux->chunk_duration = DEFAULT_CHUNK_DURATION;
 
   /* always need this */
   qtmux->context =
@@ -2329,9 +2352,11 @@ gst_qt_mux_send_moov (GstQTMux * qtmux, guint64 * _offset,
   }
   GST_OBJECT_UNLOCK (qtmux);
 
-  /* serialize moov */
-  offset = size = 0;
-  data = NULL;
+  /* serialize moov, starting out with room for the previous one (if any)
+   * so that periodic rewrites don't need to grow the buffer repeatedly */
+  offset = 0;
+  size = qtmux->last_moov_size;
+  data = size > 0 ? g_malloc (size) : NULL;
   GST_LOG_OBJECT (qtmux, "Copying movie header into buffer");
   if (!atom_moov_copy_data (qtmux->moov, &data, &size, &offset))
     goto serialize_error;
@@ -3046,7 +3071,15 @@ gst_qt_mux_start_file (GstQTMux * qtmux)
     else
       qtmux->mux_mode = GST_QT_MUX_MODE_FRAGMENTED;
   } else if (qtmux->fast_start) {
-    qtmux->mux_mode = GST_QT_MUX_MODE_FAST_START;
+    /* With a reserved-max-duration, faststart can be done in a single pass
+     * by reserving the moov space up front, like robust muxing does, and
+     * writing the media straight downstream instead of into a temp file */
+    if (reserved_max_duration != GST_CLOCK_TIME_NONE
+        && reserved_max_duration != 0 && !qtmux->reserved_prefill
+        && gst_qt_mux_downstream_is_seekable (qtmux))
+      qtmux->mux_mode = GST_QT_MUX_MODE_FAST_START_RESERVED;
+    else
+      qtmux->mux_mode = GST_QT_MUX_MODE_FAST_START;
   } else if (reserved_max_duration != GST_CLOCK_TIME_NONE) {
     if (reserved_max_duration == 0) {
       GST_ELEMENT_ERROR (qtmux, STREAM, MUX,
@@ -3080,6 +3113,8 @@ gst_qt_mux_start_file (GstQTMux * qtmux)
     case GST_QT_MUX_MODE_FAST_START:
     case GST_QT_MUX_MODE_FRAGMENTED_STREAMABLE:
       break;                    /* Don't need seekability, ignore */
+    case GST_QT_MUX_MODE_FAST_START_RESERVED:
+      break;                    /* Seekability already checked above */
     case GST_QT_MUX_MODE_FRAGMENTED:
       if (!gst_qt_mux_downstream_is_seekable (qtmux)) {
         GST_WARNING_OBJECT (qtmux, "downstream is not seekable, but "
@@ -3398,6 +3433,74 @@ gst_qt_mux_start_file (GstQTMux * qtmux)
 
       break;
     }
+    case GST_QT_MUX_MODE_FAST_START_RESERVED:
+    {
+      guint64 size = 0, offset = 0;
+
+      ret = gst_qt_mux_prepare_and_send_ftyp (qtmux);
+      if (ret != GST_FLOW_OK)
+        break;
+
+      /* The reserved area starts right after the ftyp. At EOS the final
+       * moov is written here, followed by a free atom for any slack */
+      qtmux->moov_pos = qtmux->header_size;
+
+      gst_qt_mux_configure_moov (qtmux);
+      gst_qt_mux_setup_metadata (qtmux);
+
+      /* Measure the 'base' size of the moov, before any per-trak sample
+       * tables, and reserve enough extra on top of it for the expected
+       * duration. Only a single moov is needed, no ping-pong */
+      if (!atom_moov_copy_data (qtmux->moov, NULL, &size, &offset)) {
+        GST_ELEMENT_ERROR (qtmux, STREAM, MUX, (NULL),
+            ("Failed to serialize moov"));
+        return GST_FLOW_ERROR;
+      }
+      qtmux->base_moov_size = offset;
+      qtmux->reserved_moov_size = qtmux->base_moov_size +
+          gst_util_uint64_scale (reserved_max_duration,
+          reserved_bytes_per_sec_per_trak *
+          atom_moov_get_trak_count (qtmux->moov), GST_SECOND);
+
+      if (qtmux->reserved_moov_size < 4 * 8)
+        goto reserved_moov_too_small;
+
+      GST_DEBUG_OBJECT (qtmux, "reserving faststart header area of size %u "
+          "(base moov size %u)", qtmux->reserved_moov_size,
+          qtmux->base_moov_size);
+
+      GST_OBJECT_LOCK (qtmux);
+      if (reserved_bytes_per_sec_per_trak > 0) {
+        qtmux->reserved_duration_remaining =
+            gst_util_uint64_scale (qtmux->reserved_moov_size -
+            qtmux->base_moov_size, GST_SECOND,
+            reserved_bytes_per_sec_per_trak *
+            atom_moov_get_trak_count (qtmux->moov));
+      } else {
+        qtmux->reserved_duration_remaining = 0;
+      }
+      GST_OBJECT_UNLOCK (qtmux);
+
+      /* Fill the whole reserved area with a single free atom for now */
+      ret = gst_qt_mux_send_free_atom (qtmux, &qtmux->header_size,
+          qtmux->reserved_moov_size, FALSE);
+      if (ret != GST_FLOW_OK)
+        return ret;
+
+      /* extra atoms go after the reserved moov area, before the mdat */
+      ret =
+          gst_qt_mux_send_extra_atoms (qtmux, TRUE, &qtmux->header_size, FALSE);
+      if (ret != GST_FLOW_OK)
+        return ret;
+
+      qtmux->mdat_pos = qtmux->header_size;
+      /* extended atom in case we go over 4GB while writing and need
+       * the full 64-bit atom */
+      ret =
+          gst_qt_mux_send_mdat_header (qtmux, &qtmux->header_size, 0, TRUE,
+          FALSE);
+      break;
+    }
     case GST_QT_MUX_MODE_FAST_START:
       GST_OBJECT_LOCK (qtmux);
       qtmux->fast_start_file = g_fopen (qtmux->fast_start_file_path, "wb+");
@@ -3704,6 +3807,72 @@ gst_qt_mux_update_timecode (GstQTMux * qtmux, GstQTMuxPad * qtpad)
   return gst_qt_mux_send_buffer (qtmux, buf, &offset, FALSE);
 }
 
+/*
+ * Finalise a single-pass faststart file. The media was written straight
+ * into the mdat following the reserved header area, so all that is left is
+ * to write the final moov into that area and pad the rest with a free atom.
+ *
+ * If the moov turned out bigger than the reserved area, there is no way to
+ * make room for it in front of the mdat without reading back everything
+ * written downstream. In that case the moov is appended after the mdat
+ * instead, leaving the reserved area as a free atom, so the file is still
+ * complete and playable, just not faststart.
+ */
+static GstFlowReturn
+gst_qt_mux_fast_start_reserved_finish (GstQTMux * qtmux)
+{
+  GstFlowReturn ret;
+  guint64 offset = 0, size = 0;
+
+  gst_qt_mux_configure_moov (qtmux);
+  gst_qt_mux_update_edit_lists (qtmux);
+  gst_qt_mux_setup_metadata (qtmux);
+
+  /* chunks position is set relative to the first byte of the
+   * MDAT atom payload. Set the overall offset into the file */
+  atom_moov_chunks_set_offset (qtmux->moov, qtmux->header_size);
+
+  /* copy into NULL to obtain size */
+  if (!atom_moov_copy_data (qtmux->moov, NULL, &size, &offset)) {
+    GST_ELEMENT_ERROR (qtmux, STREAM, MUX, (NULL),
+        ("Failed to serialize moov"));
+    return GST_FLOW_ERROR;
+  }
+
+  GST_DEBUG_OBJECT (qtmux, "final moov size %" G_GUINT64_FORMAT
+      ", reserved %u", offset, qtmux->reserved_moov_size);
+
+  if (offset == qtmux->reserved_moov_size
+      || offset + 8 <= qtmux->reserved_moov_size) {
+    GstSegment segment;
+
+    gst_segment_init (&segment, GST_FORMAT_BYTES);
+    segment.start = qtmux->moov_pos;
+    gst_aggregator_update_segment (GST_AGGREGATOR (qtmux), &segment);
+
+    ret = gst_qt_mux_send_moov (qtmux, NULL,
+        offset == qtmux->reserved_moov_size ? 0 : qtmux->reserved_moov_size,
+        FALSE, FALSE);
+  } else {
+    GST_ELEMENT_WARNING (qtmux, STREAM, MUX,
+        ("Not enough reserved space for a faststart header, "
+            "writing it at the end of the file instead"),
+        ("Needed %" G_GUINT64_FORMAT " bytes, reserved %u. Consider "
+            "increasing reserved-max-duration or reserved-bytes-per-sec",
+            offset, qtmux->reserved_moov_size));
+
+    /* Downstream is still positioned right after the last media data */
+    ret = gst_qt_mux_send_moov (qtmux, NULL, 0, FALSE, FALSE);
+  }
+  if (ret != GST_FLOW_OK)
+    return ret;
+
+  /* Finalise by writing the final size into the mdat. Up until now
+   * it's been 0, which means 'rest of the file' */
+  return gst_qt_mux_update_mdat_size (qtmux, qtmux->mdat_pos,
+      qtmux->mdat_size, NULL, FALSE);
+}
+
 static GstFlowReturn
 gst_qt_mux_stop_file (GstQTMux * qtmux)
 {
@@ -3971,6 +4140,8 @@ gst_qt_mux_stop_file (GstQTMux * qtmux)
           qtmux->mdat_size, NULL, FALSE);
       return ret;
     }
+    case GST_QT_MUX_MODE_FAST_START_RESERVED:
+      return gst_qt_mux_fast_start_reserved_finish (qtmux);
     default:
       break;
   }
@@ -4081,6 +4252,7 @@ gst_qt_mux_pad_fragment_add_buffer (GstQTMux * qtmux, GstQTMuxPad * pad,
 {
   GstFlowReturn ret = GST_FLOW_OK;
   guint index = 0;
+  gboolean new_fragment = TRUE;
 
   /* setup if needed */
   if (G_UNLIKELY (!pad->traf || force))
@@ -4089,8 +4261,12 @@ gst_qt_mux_pad_fragment_add_buffer (GstQTMux * qtmux, GstQTMuxPad * pad,
 flush:
   /* flush pad fragment if threshold reached,
    * or at new keyframe if we should be minding those in the first place */
-  if (G_UNLIKELY (force || (sync && pad->sync) ||
-          pad->fragment_duration < (gint64) delta)) {
+  new_fragment = force || (sync && pad->sync) ||
+      pad->fragment_duration < (gint64) delta;
+  /* in chunked mode, also flush what we have so far as a chunk of the
+   * current fragment once the chunk duration is reached */
+  if (G_UNLIKELY (new_fragment || (qtmux->chunk_duration > 0
+              && pad->chunk_duration < (gint64) delta))) {
     AtomMOOF *moof;
     guint64 size = 0, offset = 0;
     guint8 *data = NULL;
@@ -4132,12 +4308,16 @@ flush:
 
     for (index = 0; index < atom_array_get_len (&pad->fragment_buffers);
         index++) {
-      GST_DEBUG_OBJECT (qtmux, "sending fragment %p",
-          atom_array_index (&pad->fragment_buffers, index));
-      ret =
-          gst_qt_mux_send_buffer (qtmux,
-          atom_array_index (&pad->fragment_buffers, index), &qtmux->header_size,
-          FALSE);
+      GstBuffer *fbuf = atom_array_index (&pad->fragment_buffers, index);
+
+      GST_DEBUG_OBJECT (qtmux, "sending fragment %p", fbuf);
+      /* mark the end of the chunk so downstream can flush it out */
+      if (qtmux->chunk_duration > 0
+          && index + 1 == atom_array_get_len (&pad->fragment_buffers)) {
+        fbuf = gst_buffer_make_writable (fbuf);
+        GST_BUFFER_FLAG_SET (fbuf, GST_BUFFER_FLAG_MARKER);
+      }
+      ret = gst_qt_mux_send_buffer (qtmux, fbuf, &qtmux->header_size, FALSE);
       if (ret != GST_FLOW_OK)
         goto fragment_buf_send_error;
     }
@@ -4149,10 +4329,16 @@ flush:
 
 init:
   if (G_UNLIKELY (!pad->traf)) {
-    GST_LOG_OBJECT (qtmux, "setting up new fragment");
+    GST_LOG_OBJECT (qtmux, "setting up new %s",
+        new_fragment ? "fragment" : "chunk");
     pad->traf = atom_traf_new (qtmux->context, atom_trak_get_id (pad->trak));
     atom_array_init (&pad->fragment_buffers, 512);
-    pad->fragment_duration = gst_util_uint64_scale (qtmux->fragment_duration,
+    if (new_fragment) {
+      pad->fragment_duration =
+          gst_util_uint64_scale (qtmux->fragment_duration,
+          atom_trak_get_timescale (pad->trak), 1000);
+    }
+    pad->chunk_duration = gst_util_uint64_scale (qtmux->chunk_duration,
         atom_trak_get_timescale (pad->trak), 1000);
 
     if (G_UNLIKELY (qtmux->mfra && !pad->tfra)) {
@@ -4168,6 +4354,7 @@ init:
   GST_LOG_OBJECT (qtmux, "adding buffer %p to fragments", buf);
   atom_array_append (&pad->fragment_buffers, g_steal_pointer (&buf), 256);
   pad->fragment_duration -= delta;
+  pad->chunk_duration -= delta;
 
   if (pad->tfra) {
     guint32 sn = atom_traf_get_sample_num (pad->traf);
@@ -4339,6 +4526,18 @@ gst_qt_mux_robust_recording_rewrite_moov (GstQTMux * qtmux)
   return ret;
 }
 
+/* The moov is only written at EOS in reserved faststart mode, so everything
+ * muxed so far counts against the reserved space */
+static void
+gst_qt_mux_fast_start_reserved_update (GstQTMux * qtmux, GstClockTime position)
+{
+  GST_OBJECT_LOCK (qtmux);
+  if (GST_CLOCK_TIME_IS_VALID (position)
+      && position > qtmux->muxed_since_last_update)
+    qtmux->muxed_since_last_update = position;
+  GST_OBJECT_UNLOCK (qtmux);
+}
+
 static GstFlowReturn
 gst_qt_mux_robust_recording_update (GstQTMux * qtmux, GstClockTime position)
 {
@@ -4466,6 +4665,7 @@ gst_qt_mux_register_and_push_sample (GstQTMux * qtmux, GstQTMuxPad * pad,
     }
     case GST_QT_MUX_MODE_MOOV_AT_END:
     case GST_QT_MUX_MODE_FAST_START:
+    case GST_QT_MUX_MODE_FAST_START_RESERVED:
     case GST_QT_MUX_MODE_ROBUST_RECORDING:
       atom_trak_add_samples (pad->trak, nsamples, (gint32) scaled_duration,
           sample_size, chunk_offset, sync, pts_offset);
@@ -4474,6 +4674,9 @@ gst_qt_mux_register_and_push_sample (GstQTMux * qtmux, GstQTMuxPad * pad,
       if (ret == GST_FLOW_OK
           && qtmux->mux_mode == GST_QT_MUX_MODE_ROBUST_RECORDING)
         ret = gst_qt_mux_robust_recording_update (qtmux, pad->total_duration);
+      else if (ret == GST_FLOW_OK
+          && qtmux->mux_mode == GST_QT_MUX_MODE_FAST_START_RESERVED)
+        gst_qt_mux_fast_start_reserved_update (qtmux, pad->total_duration);
       break;
     case GST_QT_MUX_MODE_FRAGMENTED:
     case GST_QT_MUX_MODE_FRAGMENTED_STREAMABLE:
@@ -6686,6 +6889,9 @@ gst_qt_mux_get_property (GObject * object,
     case PROP_FORCE_CREATE_TIMECODE_TRAK:
       g_value_set_boolean (value, qtmux->force_create_timecode_trak);
       break;
+    case PROP_CHUNK_DURATION:
+      g_value_set_uint (value, qtmux->chunk_duration);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -6788,6 +6994,9 @@ gst_qt_mux_set_property (GObject * object,
       qtmux->context->force_create_timecode_trak =
           qtmux->force_create_timecode_trak;
       break;
+    case PROP_CHUNK_DURATION:
+      qtmux->chunk_duration = g_value_get_uint (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -49,7 +49,9 @@ prop_copy_ensure_buffer (guint8 ** buffer, guint64 * bsize, guint64 * offset,
     guint64 size)
 {
   if (buffer && *bsize - *offset < size) {
-    *bsize += size + 10 * 1024;
+    /* grow geometrically, so that serialising a large moov with many
+     * sample table entries doesn't keep reallocating (and copying) it */
+    *bsize = MAX (*bsize + *bsize / 2, *offset + size + 10 * 1024);
     *buffer = g_realloc (*buffer, *bsize);
   }
 }
@@ -72,14 +74,27 @@ guint64 prop_copy_ ## name ## _array (datatype *prop, guint size,	\
   return copy_func (prop, sizeof (datatype) * size, buffer, bsize, offset);\
 }
 
-#define INT_ARRAY_COPY_FUNC(name, datatype) 				\
+/* ensures space for the whole array once and then converts the entries
+ * straight into the destination, as this is used for sample tables */
+#define INT_ARRAY_COPY_FUNC(name, datatype, to_be) 			\
 guint64 prop_copy_ ## name ## _array (datatype *prop, guint size,	\
     guint8 ** buffer, guint64 * bsize, guint64 * offset) { 		\
   guint i;								\
 									\
-  for (i = 0; i < size; i++) {						\
-    prop_copy_ ## name (prop[i], buffer, bsize, offset);		\
+  if (buffer) {								\
+    guint8 *dest;							\
+									\
+    prop_copy_ensure_buffer (buffer, bsize, offset,			\
+        sizeof (datatype) * size);					\
+    dest = *buffer + *offset;						\
+    for (i = 0; i < size; i++) {					\
+      datatype value = to_be (prop[i]);					\
+									\
+      memcpy (dest, &value, sizeof (datatype));				\
+      dest += sizeof (datatype);					\
+    }									\
   }									\
+  *offset += sizeof (datatype) * size;					\
   return sizeof (datatype) * size;					\
 }
 
@@ -125,10 +140,9 @@ prop_copy_int32 (gint32 prop, guint8 ** buffer, guint64 * size,
 
 /* uint8 can use direct copy in any case, and may be used for large quantity */
 INT_ARRAY_COPY_FUNC_FAST (uint8, guint8);
-/* not used in large quantity anyway */
-INT_ARRAY_COPY_FUNC (uint16, guint16);
-INT_ARRAY_COPY_FUNC (uint32, guint32);
-INT_ARRAY_COPY_FUNC (uint64, guint64);
+INT_ARRAY_COPY_FUNC (uint16, guint16, GUINT16_TO_BE);
+INT_ARRAY_COPY_FUNC (uint32, guint32, GUINT32_TO_BE);
+INT_ARRAY_COPY_FUNC (uint64, guint64, GUINT64_TO_BE);
 
 /* FOURCC */
 guint64
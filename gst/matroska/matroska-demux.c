@@ -86,13 +86,23 @@ enum
   PROP_METADATA,
   PROP_STREAMINFO,
   PROP_MAX_GAP_TIME,
-  PROP_MAX_BACKTRACK_DISTANCE
+  PROP_MAX_BACKTRACK_DISTANCE,
+  PROP_CLUSTER_INDEX,
+  PROP_BYTES_COPIED
 };
 
 #define DEFAULT_MAX_GAP_TIME           (2 * GST_SECOND)
 #define DEFAULT_MAX_BACKTRACK_DISTANCE 30
 #define INVALID_DATA_THRESHOLD         (2 * 1024 * 1024)
 
+/* serialised cluster index: magic, version, then per cluster the offset,
+ * time and flags, all big endian */
+#define CLUSTER_INDEX_MAGIC            GST_MAKE_FOURCC ('M', 'K', 'C', 'I')
+#define CLUSTER_INDEX_VERSION          1
+#define CLUSTER_INDEX_HEADER_SIZE      8
+#define CLUSTER_INDEX_ENTRY_SIZE       20
+#define CLUSTER_INDEX_FLAG_KEYFRAME    (1 << 0)
+
 static GstStaticPadTemplate sink_templ = GST_STATIC_PAD_TEMPLATE ("sink",
     GST_PAD_SINK,
     GST_PAD_ALWAYS,
@@ -233,6 +243,35 @@ gst_matroska_demux_class_init (GstMatroskaDemuxClass * klass)
           0, G_MAXUINT, DEFAULT_MAX_BACKTRACK_DISTANCE,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstMatroskaDemux:cluster-index:
+   *
+   * Index of the clusters (and whether they start with a keyframe) seen so
+   * far while reading a file without Cues in pull mode. It is used to speed
+   * up seeking. The application can read it before shutting down the
+   * element and set it again when the same file is opened later.
+   *
+   * Since: 1.18
+   */
+  g_object_class_install_property (gobject_class, PROP_CLUSTER_INDEX,
+      g_param_spec_boxed ("cluster-index", "Cluster index",
+          "Serialised index of the clusters seen so far in files without "
+          "Cues, can be set again for the same file to speed up seeking",
+          G_TYPE_BYTES, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstMatroskaDemux:bytes-copied:
+   *
+   * Number of payload bytes that could not be pushed as sub-buffers of the
+   * input data, because they had to be realigned or decoded.
+   *
+   * Since: 1.18
+   */
+  g_object_class_install_property (gobject_class, PROP_BYTES_COPIED,
+      g_param_spec_uint64 ("bytes-copied", "Bytes copied",
+          "Number of payload bytes copied for realignment or decoding",
+          0, G_MAXUINT64, 0, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
   gstelement_class->change_state =
       GST_DEBUG_FUNCPTR (gst_matroska_demux_change_state);
   gstelement_class->send_event =
@@ -317,6 +356,14 @@ gst_matroska_demux_reset (GstElement * element)
     demux->clusters = NULL;
   }
 
+  GST_OBJECT_LOCK (demux);
+  if (demux->cluster_index) {
+    g_array_free (demux->cluster_index, TRUE);
+    demux->cluster_index = NULL;
+  }
+  demux->bytes_copied = 0;
+  GST_OBJECT_UNLOCK (demux);
+
   g_list_foreach (demux->seek_parsed,
       (GFunc) gst_matroska_read_common_free_parsed_el, NULL);
   g_list_free (demux->seek_parsed);
@@ -366,8 +413,17 @@ gst_matroska_demux_reset (GstElement * element)
   gst_flow_combiner_clear (demux->flowcombiner);
 }
 
+static void
+gst_matroska_demux_add_bytes_copied (GstMatroskaDemux * demux, gsize size)
+{
+  GST_OBJECT_LOCK (demux);
+  demux->bytes_copied += size;
+  GST_OBJECT_UNLOCK (demux);
+}
+
 static GstBuffer *
-gst_matroska_decode_buffer (GstMatroskaTrackContext * context, GstBuffer * buf)
+gst_matroska_decode_buffer (GstMatroskaDemux * demux,
+    GstMatroskaTrackContext * context, GstBuffer * buf)
 {
   GstMapInfo map;
   gpointer data;
@@ -390,6 +446,7 @@ gst_matroska_decode_buffer (GstMatroskaTrackContext * context, GstBuffer * buf)
       gst_buffer_unmap (out_buf, &map);
       gst_buffer_unref (out_buf);
       out_buf = gst_buffer_new_wrapped (data, size);
+      gst_matroska_demux_add_bytes_copied (demux, size);
     } else {
       gst_buffer_unmap (out_buf, &map);
     }
@@ -2053,6 +2110,202 @@ gst_matroska_cluster_compare (gint64 * i1, gint64 * i2)
     return 0;
 }
 
+static gint
+gst_matroska_cluster_index_compare_offset (GstMatroskaClusterIndexEntry * e,
+    guint64 * offset)
+{
+  if (e->offset < *offset)
+    return -1;
+  else if (e->offset > *offset)
+    return 1;
+  else
+    return 0;
+}
+
+static gint
+gst_matroska_cluster_index_compare_time (GstMatroskaClusterIndexEntry * e,
+    GstClockTime * time)
+{
+  if (e->time < *time)
+    return -1;
+  else if (e->time > *time)
+    return 1;
+  else
+    return 0;
+}
+
+/* must be called with the object lock */
+static void
+gst_matroska_demux_cluster_index_add (GstMatroskaDemux * demux,
+    guint64 offset, GstClockTime time, gboolean keyframe)
+{
+  GstMatroskaClusterIndexEntry *entry, new_entry;
+  guint idx;
+
+  if (!GST_CLOCK_TIME_IS_VALID (time))
+    return;
+
+  if (G_UNLIKELY (!demux->cluster_index))
+    demux->cluster_index = g_array_sized_new (FALSE, FALSE,
+        sizeof (GstMatroskaClusterIndexEntry), 128);
+
+  entry = gst_util_array_binary_search (demux->cluster_index->data,
+      demux->cluster_index->len, sizeof (GstMatroskaClusterIndexEntry),
+      (GCompareDataFunc) gst_matroska_cluster_index_compare_offset,
+      GST_SEARCH_MODE_BEFORE, &offset, NULL);
+
+  if (entry && entry->offset == offset) {
+    entry->keyframe |= keyframe;
+    return;
+  }
+
+  idx = entry ? (entry - (GstMatroskaClusterIndexEntry *)
+      demux->cluster_index->data) + 1 : 0;
+
+  GST_LOG_OBJECT (demux, "adding cluster @ %" G_GUINT64_FORMAT " time %"
+      GST_TIME_FORMAT " to index (keyframe: %d)", offset, GST_TIME_ARGS (time),
+      keyframe);
+
+  new_entry.offset = offset;
+  new_entry.time = time;
+  new_entry.keyframe = keyframe;
+  g_array_insert_val (demux->cluster_index, idx, new_entry);
+}
+
+/* Narrows down the range to bisect for @time to the closest clusters
+ * around it that we already know about */
+static void
+gst_matroska_demux_cluster_index_narrow (GstMatroskaDemux * demux,
+    GstClockTime time, gint64 * apos, GstClockTime * atime, gint64 * opos,
+    GstClockTime * otime)
+{
+  GstMatroskaClusterIndexEntry *entries, *before;
+  guint idx, len;
+
+  GST_OBJECT_LOCK (demux);
+  if (!demux->cluster_index || !GST_CLOCK_TIME_IS_VALID (time))
+    goto done;
+
+  entries = (GstMatroskaClusterIndexEntry *) demux->cluster_index->data;
+  len = demux->cluster_index->len;
+
+  before = gst_util_array_binary_search (entries, len,
+      sizeof (GstMatroskaClusterIndexEntry),
+      (GCompareDataFunc) gst_matroska_cluster_index_compare_time,
+      GST_SEARCH_MODE_BEFORE, &time, NULL);
+
+  /* Only ever move the bounds inwards, the incoming [apos, opos] bracket
+   * is known to contain the target */
+  if (before && before->offset >= *apos && before->offset <= *opos
+      && before->time >= *atime && before->time <= *otime) {
+    *apos = before->offset;
+    *atime = before->time;
+  }
+
+  idx = before ? (before - entries) + 1 : 0;
+  if (idx < len && entries[idx].time > time
+      && entries[idx].offset >= *apos && entries[idx].offset <= *opos
+      && entries[idx].time >= *atime && entries[idx].time <= *otime) {
+    *opos = entries[idx].offset;
+    *otime = entries[idx].time;
+  }
+
+  GST_DEBUG_OBJECT (demux, "cluster index narrowed search for %"
+      GST_TIME_FORMAT " to %" G_GINT64_FORMAT " - %" G_GINT64_FORMAT,
+      GST_TIME_ARGS (time), *apos, *opos);
+
+done:
+  GST_OBJECT_UNLOCK (demux);
+}
+
+/* returns TRUE if the cluster at @offset is known to start with a keyframe */
+static gboolean
+gst_matroska_demux_cluster_index_lookup_keyframe (GstMatroskaDemux * demux,
+    guint64 offset, GstClockTime * time)
+{
+  GstMatroskaClusterIndexEntry *entry = NULL;
+  gboolean ret = FALSE;
+
+  GST_OBJECT_LOCK (demux);
+  if (demux->cluster_index) {
+    entry = gst_util_array_binary_search (demux->cluster_index->data,
+        demux->cluster_index->len, sizeof (GstMatroskaClusterIndexEntry),
+        (GCompareDataFunc) gst_matroska_cluster_index_compare_offset,
+        GST_SEARCH_MODE_EXACT, &offset, NULL);
+  }
+  if (entry && entry->keyframe) {
+    *time = entry->time;
+    ret = TRUE;
+  }
+  GST_OBJECT_UNLOCK (demux);
+
+  return ret;
+}
+
+/* must be called with the object lock */
+static GBytes *
+gst_matroska_demux_cluster_index_serialize (GstMatroskaDemux * demux)
+{
+  guint i, len;
+  guint8 *data, *p;
+  gsize size;
+
+  len = demux->cluster_index ? demux->cluster_index->len : 0;
+  size = CLUSTER_INDEX_HEADER_SIZE + len * CLUSTER_INDEX_ENTRY_SIZE;
+  p = data = g_malloc (size);
+
+  GST_WRITE_UINT32_LE (p, CLUSTER_INDEX_MAGIC);
+  GST_WRITE_UINT32_BE (p + 4, CLUSTER_INDEX_VERSION);
+  p += CLUSTER_INDEX_HEADER_SIZE;
+
+  for (i = 0; i < len; i++) {
+    GstMatroskaClusterIndexEntry *entry =
+        &g_array_index (demux->cluster_index, GstMatroskaClusterIndexEntry, i);
+
+    GST_WRITE_UINT64_BE (p, entry->offset);
+    GST_WRITE_UINT64_BE (p + 8, entry->time);
+    GST_WRITE_UINT32_BE (p + 16,
+        entry->keyframe ? CLUSTER_INDEX_FLAG_KEYFRAME : 0);
+    p += CLUSTER_INDEX_ENTRY_SIZE;
+  }
+
+  return g_bytes_new_take (data, size);
+}
+
+/* must be called with the object lock */
+static void
+gst_matroska_demux_cluster_index_merge (GstMatroskaDemux * demux,
+    GBytes * bytes)
+{
+  const guint8 *data;
+  gsize size;
+
+  if (!bytes)
+    return;
+
+  data = g_bytes_get_data (bytes, &size);
+  if (size < CLUSTER_INDEX_HEADER_SIZE
+      || GST_READ_UINT32_LE (data) != CLUSTER_INDEX_MAGIC
+      || GST_READ_UINT32_BE (data + 4) != CLUSTER_INDEX_VERSION) {
+    GST_WARNING_OBJECT (demux, "Ignoring invalid cluster index");
+    return;
+  }
+
+  data += CLUSTER_INDEX_HEADER_SIZE;
+  size -= CLUSTER_INDEX_HEADER_SIZE;
+
+  GST_DEBUG_OBJECT (demux, "merging %" G_GSIZE_FORMAT " clusters into index",
+      size / CLUSTER_INDEX_ENTRY_SIZE);
+
+  while (size >= CLUSTER_INDEX_ENTRY_SIZE) {
+    gst_matroska_demux_cluster_index_add (demux, GST_READ_UINT64_BE (data),
+        GST_READ_UINT64_BE (data + 8),
+        ! !(GST_READ_UINT32_BE (data + 16) & CLUSTER_INDEX_FLAG_KEYFRAME));
+    data += CLUSTER_INDEX_ENTRY_SIZE;
+    size -= CLUSTER_INDEX_ENTRY_SIZE;
+  }
+}
+
 /* searches for a cluster start from @pos,
  * return GST_FLOW_OK and cluster position in @pos if found */
 static GstFlowReturn
@@ -2405,12 +2658,27 @@ gst_matroska_demux_scan_back_for_keyframe_cluster (GstMatroskaDemux * demux,
 
   GST_INFO_OBJECT (demux, "Checking if cluster starts with keyframe");
   while (off > first_cluster_offset) {
+    /* No need to look at clusters we already know start with a keyframe */
+    if (gst_matroska_demux_cluster_index_lookup_keyframe (demux, off,
+            &cluster.time)) {
+      GST_LOG_OBJECT (demux,
+          "Cluster @ %" G_GUINT64_FORMAT " known to start with keyframe", off);
+      cluster.offset = off;
+      cluster.status = CLUSTER_STATUS_STARTS_WITH_KEYFRAME;
+      break;
+    }
+
     if (!gst_matroska_demux_peek_cluster_info (demux, &cluster, off)) {
       GST_LOG_OBJECT (demux,
           "Couldn't get info on cluster @ %" G_GUINT64_FORMAT, off);
       break;
     }
 
+    GST_OBJECT_LOCK (demux);
+    gst_matroska_demux_cluster_index_add (demux, cluster.offset, cluster.time,
+        cluster.status == CLUSTER_STATUS_STARTS_WITH_KEYFRAME);
+    GST_OBJECT_UNLOCK (demux);
+
     /* Keyframe? Then we're done */
     if (cluster.status == CLUSTER_STATUS_STARTS_WITH_KEYFRAME) {
       GST_LOG_OBJECT (demux,
@@ -2528,6 +2796,10 @@ gst_matroska_demux_search_pos (GstMatroskaDemux * demux, GstClockTime time)
   otime = MAX (otime, atime);
   opos = MAX (opos, apos);
 
+  /* start from the closest clusters we already know about, if any */
+  gst_matroska_demux_cluster_index_narrow (demux, time, &apos, &atime, &opos,
+      &otime);
+
   maxpos = gst_matroska_read_common_get_length (&demux->common);
 
   /* invariants;
@@ -4178,6 +4450,10 @@ gst_matroska_demux_align_buffer (GstMatroskaDemux * demux,
 {
   GstMapInfo map;
 
+  /* nothing to check, the buffer can be pushed as is */
+  if (alignment <= 1)
+    return buffer;
+
   gst_buffer_map (buffer, &map, GST_MAP_READ);
 
   if (map.size < sizeof (guintptr)) {
@@ -4199,6 +4475,7 @@ gst_matroska_demux_align_buffer (GstMatroskaDemux * demux,
     GST_DEBUG_OBJECT (demux,
         "We want output aligned on %" G_GSIZE_FORMAT ", reallocated",
         alignment);
+    gst_matroska_demux_add_bytes_copied (demux, map.size);
 
     gst_buffer_unmap (buffer, &map);
     gst_buffer_unref (buffer);
@@ -4629,7 +4906,7 @@ gst_matroska_demux_parse_blockgroup_or_simpleblock (GstMatroskaDemux * demux,
         GST_BUFFER_FLAG_SET (sub, GST_BUFFER_FLAG_DECODE_ONLY);
 
       if (stream->encodings != NULL && stream->encodings->len > 0)
-        sub = gst_matroska_decode_buffer (stream, sub);
+        sub = gst_matroska_decode_buffer (demux, stream, sub);
 
       if (sub == NULL) {
         GST_WARNING_OBJECT (demux, "Decoding buffer failed");
@@ -5534,6 +5811,13 @@ gst_matroska_demux_parse_id (GstMatroskaDemux * demux, guint32 id,
             demux->stream_last_time =
                 demux->cluster_time * demux->common.time_scale;
           }
+          /* remember where clusters are if there's no index to seek with */
+          if (!demux->streaming && !demux->common.index) {
+            GST_OBJECT_LOCK (demux);
+            gst_matroska_demux_cluster_index_add (demux, demux->cluster_offset,
+                demux->cluster_time * demux->common.time_scale, FALSE);
+            GST_OBJECT_UNLOCK (demux);
+          }
 #if 0
           if (demux->common.element_index) {
             if (demux->common.element_index_writer_id == -1)
@@ -7226,6 +7510,11 @@ gst_matroska_demux_set_property (GObject * object,
       demux->max_backtrack_distance = g_value_get_uint (value);
       GST_OBJECT_UNLOCK (demux);
       break;
+    case PROP_CLUSTER_INDEX:
+      GST_OBJECT_LOCK (demux);
+      gst_matroska_demux_cluster_index_merge (demux, g_value_get_boxed (value));
+      GST_OBJECT_UNLOCK (demux);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -7252,6 +7541,17 @@ gst_matroska_demux_get_property (GObject * object,
       g_value_set_uint (value, demux->max_backtrack_distance);
       GST_OBJECT_UNLOCK (demux);
       break;
+    case PROP_CLUSTER_INDEX:
+      GST_OBJECT_LOCK (demux);
+      g_value_take_boxed (value,
+          gst_matroska_demux_cluster_index_serialize (demux));
+      GST_OBJECT_UNLOCK (demux);
+      break;
+    case PROP_BYTES_COPIED:
+      GST_OBJECT_LOCK (demux);
+      g_value_set_uint64 (value, demux->bytes_copied);
+      GST_OBJECT_UNLOCK (demux);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -43,6 +43,14 @@ G_BEGIN_DECLS
 #define GST_IS_MATROSKA_DEMUX_CLASS(klass) \
   (G_TYPE_CHECK_CLASS_TYPE ((klass), GST_TYPE_MATROSKA_DEMUX))
 
+/* cluster seen while reading or scanning a file, for seeking in files
+ * without Cues */
+typedef struct _GstMatroskaClusterIndexEntry {
+  guint64                  offset;   /* absolute offset of the cluster */
+  GstClockTime             time;     /* in nanoseconds */
+  gboolean                 keyframe; /* known to start with a keyframe */
+} GstMatroskaClusterIndexEntry;
+
 typedef struct _GstMatroskaDemux {
   GstElement              parent;
 
@@ -74,6 +82,9 @@ typedef struct _GstMatroskaDemux {
   /* cluster positions (optional) */
   GArray                  *clusters;
 
+  /* clusters seen so far, sorted by offset (protected by object lock) */
+  GArray                  *cluster_index;
+
   /* keeping track of playback position */
   GstClockTime             last_stop_end;
   GstClockTime             stream_start_time;
@@ -121,6 +132,10 @@ typedef struct _GstMatroskaDemux {
 
   guint                    max_backtrack_distance; /* in seconds (0 = don't backtrack) */
 
+  /* payload bytes copied instead of pushed as sub-buffers of the input
+   * (protected by object lock) */
+  guint64                  bytes_copied;
+
   /* gap handling */
   guint64                  max_gap_time;
 
@@ -75,6 +75,7 @@ enum
   PROP_MAX_CLUSTER_DURATION,
   PROP_OFFSET_TO_ZERO,
   PROP_CREATION_TIME,
+  PROP_MAX_CLUSTER_SIZE,
 };
 
 #define  DEFAULT_DOCTYPE_VERSION         2
@@ -85,6 +86,7 @@ enum
 #define  DEFAULT_MIN_CLUSTER_DURATION    500 * GST_MSECOND
 #define  DEFAULT_MAX_CLUSTER_DURATION    65535 * GST_MSECOND
 #define  DEFAULT_OFFSET_TO_ZERO          FALSE
+#define  DEFAULT_MAX_CLUSTER_SIZE        0
 
 /* WAVEFORMATEX is gst_riff_strf_auds + an extra guint16 extension size */
 #define WAVEFORMATEX_SIZE  (2 + sizeof (gst_riff_strf_auds))
@@ -376,6 +378,24 @@ gst_matroska_mux_class_init (GstMatroskaMuxClass * klass)
           " NULL means that the current time will be used.",
           G_TYPE_DATE_TIME, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstMatroskaMux:max-cluster-size:
+   *
+   * Maximum size of a cluster in bytes. Once a cluster reaches this size, a
+   * new one is started with the next block, irrespective of keyframes. As
+   * each block is pushed downstream as soon as it is written, this bounds
+   * the burstiness of live (streamable) output in addition to
+   * #GstMatroskaMux:max-cluster-duration.
+   *
+   * Since: 1.18
+   */
+  g_object_class_install_property (gobject_class, PROP_MAX_CLUSTER_SIZE,
+      g_param_spec_uint64 ("max-cluster-size", "Maximum cluster size",
+          "A new cluster will be created if its size in bytes exceeds this "
+          "value. 0 means no maximum size.", 0, G_MAXUINT64,
+          DEFAULT_MAX_CLUSTER_SIZE,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gstelement_class->change_state =
       GST_DEBUG_FUNCPTR (gst_matroska_mux_change_state);
   gstelement_class->request_new_pad =
@@ -504,6 +524,7 @@ gst_matroska_mux_init (GstMatroskaMux * mux, gpointer g_class)
   mux->time_scale = DEFAULT_TIMECODESCALE;
   mux->min_cluster_duration = DEFAULT_MIN_CLUSTER_DURATION;
   mux->max_cluster_duration = DEFAULT_MAX_CLUSTER_DURATION;
+  mux->max_cluster_size = DEFAULT_MAX_CLUSTER_SIZE;
 
   /* initialize internal variables */
   mux->index = NULL;
@@ -3831,6 +3852,7 @@ gst_matroska_mux_write_data (GstMatroskaMux * mux, GstMatroskaPad * collect_pad,
   gboolean is_audio_only = FALSE;
   gboolean is_min_duration_reached = FALSE;
   gboolean is_max_duration_exceeded = FALSE;
+  gboolean is_max_size_exceeded = FALSE;
   GstMatroskamuxPad *pad;
   gint flags = 0;
   GstClockTime buffer_timestamp;
@@ -3920,11 +3942,14 @@ gst_matroska_mux_write_data (GstMatroskaMux * mux, GstMatroskaPad * collect_pad,
       && buffer_timestamp > mux->cluster_time
       && (buffer_timestamp - mux->cluster_time) >=
       MIN (G_MAXINT16 * mux->time_scale, mux->max_cluster_duration));
+  is_max_size_exceeded = (mux->max_cluster_size > 0 && mux->cluster
+      && ebml->pos - mux->cluster_pos >= mux->max_cluster_size);
 
   if (mux->cluster) {
     /* start a new cluster at every keyframe, at every GstForceKeyUnit event,
-     * or when we may be reaching the limit of the relative timestamp */
-    if (is_max_duration_exceeded || (is_video_keyframe
+     * or when we may be reaching the limit of the relative timestamp or
+     * the configured cluster size */
+    if (is_max_duration_exceeded || is_max_size_exceeded || (is_video_keyframe
             && is_min_duration_reached) || mux->force_key_unit_event
         || (is_audio_only && is_min_duration_reached)) {
       if (!mux->ebml_write->streamable)
@@ -4078,7 +4103,9 @@ gst_matroska_mux_write_data (GstMatroskaMux * mux, GstMatroskaPad * collect_pad,
 
     return gst_ebml_last_write_result (ebml);
   } else {
-    gst_ebml_write_set_cache (ebml, gst_buffer_get_size (buf) * 2);
+    /* only the element headers go into the cache, the payload is pushed
+     * as is afterwards */
+    gst_ebml_write_set_cache (ebml, 0x40);
     /* write and call order slightly unnatural,
      * but avoids seek and minizes pushing */
     blockgroup = gst_ebml_write_master_start (ebml, GST_MATROSKA_ID_BLOCKGROUP);
@@ -4291,6 +4318,9 @@ gst_matroska_mux_set_property (GObject * object,
     case PROP_MAX_CLUSTER_DURATION:
       mux->max_cluster_duration = g_value_get_int64 (value);
       break;
+    case PROP_MAX_CLUSTER_SIZE:
+      mux->max_cluster_size = g_value_get_uint64 (value);
+      break;
     case PROP_OFFSET_TO_ZERO:
       mux->offset_to_zero = g_value_get_boolean (value);
       break;
@@ -4335,6 +4365,9 @@ gst_matroska_mux_get_property (GObject * object,
     case PROP_MAX_CLUSTER_DURATION:
       g_value_set_int64 (value, mux->max_cluster_duration);
       break;
+    case PROP_MAX_CLUSTER_SIZE:
+      g_value_set_uint64 (value, mux->max_cluster_size);
+      break;
     case PROP_OFFSET_TO_ZERO:
       g_value_set_boolean (value, mux->offset_to_zero);
       break;
@@ -0,0 +1,238 @@
+/* GStreamer background file reader for the multifile elements
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* GstFileReadAhead loads whole files on a small thread pool shared by all
+ * readers in the process, so the next files of a sequence are already in
+ * memory when they are needed. The caller decides which files to prefetch
+ * and so bounds the number of files kept in memory. Asking for a file that
+ * wasn't prefetched means the sequence jumped, e.g. after a seek, and drops
+ * everything prefetched so far. */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include "gstfilereadahead.h"
+
+/* Number of threads reading files in the background */
+#define FILE_READ_AHEAD_MAX_THREADS 8
+
+typedef struct
+{
+  GstFileReadAhead *ra;
+  gchar *filename;
+
+  gboolean done;
+  gboolean cancelled;           /* no longer in the table, free when done */
+
+  gchar *contents;
+  gsize length;
+  GError *error;
+} GstFileReadAheadEntry;
+
+struct _GstFileReadAhead
+{
+  GMutex lock;
+  GCond cond;
+
+  GHashTable *files;            /* filename -> GstFileReadAheadEntry */
+  guint n_queued;               /* entries handed to the pool, not done yet */
+};
+
+static void
+gst_file_read_ahead_entry_free (GstFileReadAheadEntry * entry)
+{
+  g_free (entry->filename);
+  g_free (entry->contents);
+  g_clear_error (&entry->error);
+  g_free (entry);
+}
+
+static void
+gst_file_read_ahead_thread_func (GstFileReadAheadEntry * entry,
+    gpointer user_data)
+{
+  GstFileReadAhead *ra = entry->ra;
+  gboolean cancelled;
+
+  g_mutex_lock (&ra->lock);
+  cancelled = entry->cancelled;
+  g_mutex_unlock (&ra->lock);
+
+  if (!cancelled) {
+    if (!g_file_get_contents (entry->filename, &entry->contents,
+            &entry->length, &entry->error)) {
+      entry->contents = NULL;
+      entry->length = 0;
+    }
+  }
+
+  g_mutex_lock (&ra->lock);
+  entry->done = TRUE;
+  if (entry->cancelled)
+    gst_file_read_ahead_entry_free (entry);
+  ra->n_queued--;
+  g_cond_broadcast (&ra->cond);
+  g_mutex_unlock (&ra->lock);
+}
+
+static GThreadPool *
+gst_file_read_ahead_get_pool (void)
+{
+  static gsize pool = 0;
+
+  if (g_once_init_enter (&pool)) {
+    GThreadPool *p =
+        g_thread_pool_new ((GFunc) gst_file_read_ahead_thread_func, NULL,
+        FILE_READ_AHEAD_MAX_THREADS, FALSE, NULL);
+
+    g_once_init_leave (&pool, (gsize) p);
+  }
+
+  return (GThreadPool *) pool;
+}
+
+GstFileReadAhead *
+gst_file_read_ahead_new (void)
+{
+  GstFileReadAhead *ra = g_new0 (GstFileReadAhead, 1);
+
+  g_mutex_init (&ra->lock);
+  g_cond_init (&ra->cond);
+  ra->files = g_hash_table_new (g_str_hash, g_str_equal);
+
+  return ra;
+}
+
+/* Call with lock */
+static void
+gst_file_read_ahead_flush_unlocked (GstFileReadAhead * ra)
+{
+  GHashTableIter iter;
+  GstFileReadAheadEntry *entry;
+
+  g_hash_table_iter_init (&iter, ra->files);
+  while (g_hash_table_iter_next (&iter, NULL, (gpointer *) & entry)) {
+    /* Entries still in the pool are freed by the thread handling them */
+    if (entry->done)
+      gst_file_read_ahead_entry_free (entry);
+    else
+      entry->cancelled = TRUE;
+    g_hash_table_iter_remove (&iter);
+  }
+}
+
+/* Starts loading @filename in the background unless it is already loaded
+ * or being loaded */
+void
+gst_file_read_ahead_prefetch (GstFileReadAhead * ra, const gchar * filename)
+{
+  GstFileReadAheadEntry *entry;
+
+  g_mutex_lock (&ra->lock);
+  if (g_hash_table_contains (ra->files, filename)) {
+    g_mutex_unlock (&ra->lock);
+    return;
+  }
+
+  entry = g_new0 (GstFileReadAheadEntry, 1);
+  entry->ra = ra;
+  entry->filename = g_strdup (filename);
+  g_hash_table_insert (ra->files, entry->filename, entry);
+  ra->n_queued++;
+  g_thread_pool_push (gst_file_read_ahead_get_pool (), entry, NULL);
+  g_mutex_unlock (&ra->lock);
+}
+
+/* Number of files loaded or being loaded */
+guint
+gst_file_read_ahead_get_n_files (GstFileReadAhead * ra)
+{
+  guint n_files;
+
+  g_mutex_lock (&ra->lock);
+  n_files = g_hash_table_size (ra->files);
+  g_mutex_unlock (&ra->lock);
+
+  return n_files;
+}
+
+/* Like g_file_get_contents(), but takes the result of an earlier
+ * gst_file_read_ahead_prefetch() for @filename if there is one, waiting for
+ * it to finish if needed */
+gboolean
+gst_file_read_ahead_get_contents (GstFileReadAhead * ra,
+    const gchar * filename, gchar ** contents, gsize * length,
+    GError ** error)
+{
+  GstFileReadAheadEntry *entry;
+  gboolean ret;
+
+  g_mutex_lock (&ra->lock);
+  entry = g_hash_table_lookup (ra->files, filename);
+  if (entry == NULL) {
+    /* Out of sequence, nothing prefetched is going to be used */
+    gst_file_read_ahead_flush_unlocked (ra);
+    g_mutex_unlock (&ra->lock);
+
+    return g_file_get_contents (filename, contents, length, error);
+  }
+
+  while (!entry->done)
+    g_cond_wait (&ra->cond, &ra->lock);
+  g_hash_table_remove (ra->files, filename);
+  g_mutex_unlock (&ra->lock);
+
+  ret = entry->error == NULL;
+  if (ret) {
+    *contents = entry->contents;
+    *length = entry->length;
+    entry->contents = NULL;
+  } else {
+    g_propagate_error (error, entry->error);
+    entry->error = NULL;
+  }
+  gst_file_read_ahead_entry_free (entry);
+
+  return ret;
+}
+
+/* Drops all prefetched files. Loads that are still in progress finish in
+ * the background and are discarded. */
+void
+gst_file_read_ahead_flush (GstFileReadAhead * ra)
+{
+  g_mutex_lock (&ra->lock);
+  gst_file_read_ahead_flush_unlocked (ra);
+  g_mutex_unlock (&ra->lock);
+}
+
+void
+gst_file_read_ahead_free (GstFileReadAhead * ra)
+{
+  g_mutex_lock (&ra->lock);
+  gst_file_read_ahead_flush_unlocked (ra);
+  while (ra->n_queued > 0)
+    g_cond_wait (&ra->cond, &ra->lock);
+  g_mutex_unlock (&ra->lock);
+
+  g_hash_table_unref (ra->files);
+  g_mutex_clear (&ra->lock);
+  g_cond_clear (&ra->cond);
+  g_free (ra);
+}
@@ -0,0 +1,40 @@
+/* GStreamer background file reader for the multifile elements
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GST_FILE_READ_AHEAD_H__
+#define __GST_FILE_READ_AHEAD_H__
+
+#include <gst/gst.h>
+
+G_BEGIN_DECLS
+
+typedef struct _GstFileReadAhead GstFileReadAhead;
+
+GstFileReadAhead *gst_file_read_ahead_new (void);
+void gst_file_read_ahead_prefetch (GstFileReadAhead * ra,
+    const gchar * filename);
+guint gst_file_read_ahead_get_n_files (GstFileReadAhead * ra);
+gboolean gst_file_read_ahead_get_contents (GstFileReadAhead * ra,
+    const gchar * filename, gchar ** contents, gsize * length,
+    GError ** error);
+void gst_file_read_ahead_flush (GstFileReadAhead * ra);
+void gst_file_read_ahead_free (GstFileReadAhead * ra);
+
+G_END_DECLS
+
+#endif /* __GST_FILE_READ_AHEAD_H__ */
@@ -0,0 +1,350 @@
+/* GStreamer background file writer for the multifile elements
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* GstFileWriter hands buffers for an already opened file over to a small
+ * thread pool shared by all writers in the process. Buffers queued while a
+ * write is in progress are coalesced into the next writev(). Pushing blocks
+ * once more than the configured number of bytes is queued, so a slow disk
+ * throttles the streaming thread instead of growing memory without bound.
+ * Write errors are remembered and reported on the next push, drain or free.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include <errno.h>
+#include <limits.h>
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+#ifdef HAVE_SYS_UIO_H
+#include <sys/uio.h>
+#endif
+
+#include "gstfilewriter.h"
+
+/* Maximum number of memories handed to a single writev() */
+#if defined (IOV_MAX) && IOV_MAX < 64
+#define WRITEV_MAX_VECS IOV_MAX
+#else
+#define WRITEV_MAX_VECS 64
+#endif
+
+/* Number of threads writing out files in the background */
+#define FILE_WRITER_MAX_THREADS 4
+
+struct _GstFileWriter
+{
+  FILE *file;
+
+  GMutex lock;
+  GCond cond;
+
+  GQueue pending;               /* of GstBuffer */
+  guint64 level;                /* bytes in pending and being written */
+  guint64 max_queued;
+
+  gboolean scheduled;           /* a pool thread is working on the queue */
+  gboolean flushing;
+  int error;                    /* errno of the first failed write */
+};
+
+/* Writes all memories of @buffers to @file. The memories are mapped one by
+ * one and handed to writev(), so buffers made up of several memories don't
+ * get merged into a single copy first. Returns FALSE with errno set on
+ * failure. */
+gboolean
+gst_file_writer_write_buffers (FILE * file, GstBuffer ** buffers,
+    guint n_buffers)
+{
+  guint b = 0, m = 0;
+#if defined (HAVE_SYS_UIO_H) && defined (HAVE_UNISTD_H)
+  struct iovec vecs[WRITEV_MAX_VECS];
+  GstMapInfo maps[WRITEV_MAX_VECS];
+  int fd;
+
+  /* Anything written through stdio so far has to go first */
+  if (fflush (file) != 0)
+    return FALSE;
+  fd = fileno (file);
+
+  while (b < n_buffers) {
+    struct iovec *vec = vecs;
+    guint n_vecs = 0, n_left, j;
+    gsize left = 0;
+    gboolean ok = TRUE;
+    int saved_errno = 0;
+
+    while (b < n_buffers && n_vecs < WRITEV_MAX_VECS) {
+      GstMemory *mem;
+
+      if (m >= gst_buffer_n_memory (buffers[b])) {
+        b++;
+        m = 0;
+        continue;
+      }
+
+      mem = gst_buffer_peek_memory (buffers[b], m);
+      if (!gst_memory_map (mem, &maps[n_vecs], GST_MAP_READ)) {
+        saved_errno = EIO;
+        ok = FALSE;
+        break;
+      }
+      vecs[n_vecs].iov_base = maps[n_vecs].data;
+      vecs[n_vecs].iov_len = maps[n_vecs].size;
+      left += maps[n_vecs].size;
+      n_vecs++;
+      m++;
+    }
+
+    n_left = n_vecs;
+    while (ok && left > 0) {
+      gssize written = writev (fd, vec, n_left);
+
+      if (written < 0 && errno == EINTR)
+        continue;
+      if (written <= 0) {
+        saved_errno = written < 0 ? errno : EIO;
+        ok = FALSE;
+        break;
+      }
+
+      /* Skip over what was written and continue with the rest */
+      left -= written;
+      while (written > 0) {
+        if ((gsize) written >= vec->iov_len) {
+          written -= vec->iov_len;
+          vec++;
+          n_left--;
+        } else {
+          vec->iov_base = (guint8 *) vec->iov_base + written;
+          vec->iov_len -= written;
+          written = 0;
+        }
+      }
+    }
+
+    for (j = 0; j < n_vecs; j++)
+      gst_memory_unmap (maps[j].memory, &maps[j]);
+
+    if (!ok) {
+      errno = saved_errno;
+      return FALSE;
+    }
+  }
+#else
+  for (b = 0; b < n_buffers; b++) {
+    for (m = 0; m < gst_buffer_n_memory (buffers[b]); m++) {
+      GstMemory *mem = gst_buffer_peek_memory (buffers[b], m);
+      GstMapInfo map;
+      size_t ret;
+
+      if (!gst_memory_map (mem, &map, GST_MAP_READ)) {
+        errno = EIO;
+        return FALSE;
+      }
+      ret = map.size ? fwrite (map.data, map.size, 1, file) : 1;
+      gst_memory_unmap (mem, &map);
+
+      if (ret != 1)
+        return FALSE;
+    }
+  }
+#endif
+
+  return TRUE;
+}
+
+static void
+gst_file_writer_thread_func (GstFileWriter * writer, gpointer user_data)
+{
+  g_mutex_lock (&writer->lock);
+  while (!g_queue_is_empty (&writer->pending) && writer->error == 0) {
+    guint n_buffers = g_queue_get_length (&writer->pending);
+    GstBuffer **buffers = g_new (GstBuffer *, n_buffers);
+    guint64 bytes = 0;
+    gboolean ok;
+    int saved_errno;
+    guint i;
+
+    /* Take everything queued so far and write it in one go */
+    for (i = 0; i < n_buffers; i++) {
+      buffers[i] = g_queue_pop_head (&writer->pending);
+      bytes += gst_buffer_get_size (buffers[i]);
+    }
+    g_mutex_unlock (&writer->lock);
+
+    ok = gst_file_writer_write_buffers (writer->file, buffers, n_buffers);
+    saved_errno = errno;
+
+    for (i = 0; i < n_buffers; i++)
+      gst_buffer_unref (buffers[i]);
+    g_free (buffers);
+
+    g_mutex_lock (&writer->lock);
+    if (!ok)
+      writer->error = saved_errno ? saved_errno : EIO;
+    writer->level -= bytes;
+    g_cond_broadcast (&writer->cond);
+  }
+
+  if (writer->error != 0) {
+    /* Nothing more can be written after an error, drop the rest */
+    g_queue_foreach (&writer->pending, (GFunc) gst_buffer_unref, NULL);
+    g_queue_clear (&writer->pending);
+    writer->level = 0;
+  }
+
+  writer->scheduled = FALSE;
+  g_cond_broadcast (&writer->cond);
+  g_mutex_unlock (&writer->lock);
+}
+
+static GThreadPool *
+gst_file_writer_get_pool (void)
+{
+  static gsize pool = 0;
+
+  if (g_once_init_enter (&pool)) {
+    GThreadPool *p = g_thread_pool_new ((GFunc) gst_file_writer_thread_func,
+        NULL, FILE_WRITER_MAX_THREADS, FALSE, NULL);
+
+    g_once_init_leave (&pool, (gsize) p);
+  }
+
+  return (GThreadPool *) pool;
+}
+
+/* Creates a writer for @file, which stays owned by the caller. At most
+ * @max_queued bytes are kept queued before gst_file_writer_push() blocks */
+GstFileWriter *
+gst_file_writer_new (FILE * file, guint64 max_queued)
+{
+  GstFileWriter *writer = g_new0 (GstFileWriter, 1);
+
+  writer->file = file;
+  writer->max_queued = max_queued;
+  g_mutex_init (&writer->lock);
+  g_cond_init (&writer->cond);
+  g_queue_init (&writer->pending);
+
+  return writer;
+}
+
+/* Queues @buffer for writing, taking ownership of it. Blocks while the
+ * queue is full. While flushing the buffer is dropped. Returns FALSE with
+ * errno set if an earlier write failed. */
+gboolean
+gst_file_writer_push (GstFileWriter * writer, GstBuffer * buffer)
+{
+  guint64 size = gst_buffer_get_size (buffer);
+
+  g_mutex_lock (&writer->lock);
+  /* Always let a single buffer in if nothing is queued, however big */
+  while (!writer->flushing && writer->error == 0 && writer->level > 0
+      && writer->level + size > writer->max_queued)
+    g_cond_wait (&writer->cond, &writer->lock);
+
+  if (writer->error != 0) {
+    errno = writer->error;
+    g_mutex_unlock (&writer->lock);
+    gst_buffer_unref (buffer);
+    return FALSE;
+  }
+
+  if (writer->flushing) {
+    g_mutex_unlock (&writer->lock);
+    gst_buffer_unref (buffer);
+    return TRUE;
+  }
+
+  g_queue_push_tail (&writer->pending, buffer);
+  writer->level += size;
+
+  if (!writer->scheduled) {
+    writer->scheduled = TRUE;
+    g_thread_pool_push (gst_file_writer_get_pool (), writer, NULL);
+  }
+  g_mutex_unlock (&writer->lock);
+
+  return TRUE;
+}
+
+/* Waits until everything queued so far was written. Returns FALSE with
+ * errno set if a write failed. */
+gboolean
+gst_file_writer_drain (GstFileWriter * writer)
+{
+  gboolean ret = TRUE;
+
+  g_mutex_lock (&writer->lock);
+  while (writer->scheduled)
+    g_cond_wait (&writer->cond, &writer->lock);
+
+  if (writer->error != 0) {
+    errno = writer->error;
+    ret = FALSE;
+  }
+  g_mutex_unlock (&writer->lock);
+
+  return ret;
+}
+
+/* Unblocks gst_file_writer_push() and makes it drop buffers while
+ * @flushing is set. Data that was already queued is still written */
+void
+gst_file_writer_set_flushing (GstFileWriter * writer, gboolean flushing)
+{
+  g_mutex_lock (&writer->lock);
+  writer->flushing = flushing;
+  g_cond_broadcast (&writer->cond);
+  g_mutex_unlock (&writer->lock);
+}
+
+/* Number of bytes queued and not written yet */
+guint64
+gst_file_writer_get_level (GstFileWriter * writer)
+{
+  guint64 level;
+
+  g_mutex_lock (&writer->lock);
+  level = writer->level;
+  g_mutex_unlock (&writer->lock);
+
+  return level;
+}
+
+/* Drains and frees @writer. The file is not closed. Returns FALSE with
+ * errno set if any write failed. */
+gboolean
+gst_file_writer_free (GstFileWriter * writer)
+{
+  gboolean ret;
+  int saved_errno;
+
+  ret = gst_file_writer_drain (writer);
+  saved_errno = errno;
+
+  g_mutex_clear (&writer->lock);
+  g_cond_clear (&writer->cond);
+  g_free (writer);
+
+  errno = saved_errno;
+  return ret;
+}
@@ -0,0 +1,41 @@
+/* GStreamer background file writer for the multifile elements
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GST_FILE_WRITER_H__
+#define __GST_FILE_WRITER_H__
+
+#include <stdio.h>
+#include <gst/gst.h>
+
+G_BEGIN_DECLS
+
+typedef struct _GstFileWriter GstFileWriter;
+
+gboolean gst_file_writer_write_buffers (FILE * file, GstBuffer ** buffers,
+    guint n_buffers);
+
+GstFileWriter *gst_file_writer_new (FILE * file, guint64 max_queued);
+gboolean gst_file_writer_push (GstFileWriter * writer, GstBuffer * buffer);
+gboolean gst_file_writer_drain (GstFileWriter * writer);
+void gst_file_writer_set_flushing (GstFileWriter * writer, gboolean flushing);
+guint64 gst_file_writer_get_level (GstFileWriter * writer);
+gboolean gst_file_writer_free (GstFileWriter * writer);
+
+G_END_DECLS
+
+#endif /* __GST_FILE_WRITER_H__ */
@@ -64,6 +64,7 @@ static GstCaps *gst_image_sequence_src_getcaps (GstBaseSrc * src,
     GstCaps * filter);
 static gboolean gst_image_sequence_src_query (GstBaseSrc * src,
     GstQuery * query);
+static gboolean gst_image_sequence_src_stop (GstBaseSrc * src);
 static void gst_image_sequence_src_set_caps (GstImageSequenceSrc * self,
     GstCaps * caps);
 static void gst_image_sequence_src_set_duration (GstImageSequenceSrc * self);
@@ -86,13 +87,15 @@ enum
   PROP_LOCATION,
   PROP_START_INDEX,
   PROP_STOP_INDEX,
-  PROP_FRAMERATE
+  PROP_FRAMERATE,
+  PROP_READ_AHEAD
 };
 
 #define DEFAULT_LOCATION "%05d"
 #define DEFAULT_START_INDEX 0
 #define DEFAULT_STOP_INDEX -1
 #define DEFAULT_FRAMERATE 30
+#define DEFAULT_READ_AHEAD 0
 
 /* Call with LOCK taken */
 static gboolean
@@ -257,6 +260,10 @@ do_seek (GstBaseSrc * bsrc, GstSegment * segment)
       self->start_index +
       segment->position * self->fps_n / (self->fps_d * GST_SECOND);
 
+  /* files read ahead for the old position are of no use anymore */
+  if (self->reader)
+    gst_file_read_ahead_flush (self->reader);
+
   return TRUE;
 }
 
@@ -318,11 +325,28 @@ gst_image_sequence_src_class_init (GstImageSequenceSrcClass * klass)
           1, 1, G_MAXINT, 1, DEFAULT_FRAMERATE, 1,
           G_PARAM_WRITABLE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstImageSequenceSrc:read-ahead:
+   *
+   * Number of images following the current one to load in the background,
+   * in playback direction. This hides the latency of slow storage, e.g.
+   * network file systems, at the cost of keeping up to this many images in
+   * memory. 0 reads each image only once it is needed.
+   *
+   * Since: 1.18
+   */
+  g_object_class_install_property (gobject_class, PROP_READ_AHEAD,
+      g_param_spec_uint ("read-ahead", "Read Ahead",
+          "Number of images to load in the background ahead of the current "
+          "one (0 = disabled)", 0, 256, DEFAULT_READ_AHEAD,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gobject_class->finalize = gst_image_sequence_src_finalize;
   gobject_class->dispose = gst_image_sequence_src_dispose;
 
   gstbasesrc_class->get_caps = gst_image_sequence_src_getcaps;
   gstbasesrc_class->query = gst_image_sequence_src_query;
+  gstbasesrc_class->stop = gst_image_sequence_src_stop;
   gstbasesrc_class->is_seekable = is_seekable;
   gstbasesrc_class->do_seek = do_seek;
 
@@ -357,6 +381,20 @@ gst_image_sequence_src_init (GstImageSequenceSrc * self)
   self->n_frames = 0;
   self->fps_n = 30;
   self->fps_d = 1;
+  self->read_ahead = DEFAULT_READ_AHEAD;
+}
+
+static gboolean
+gst_image_sequence_src_stop (GstBaseSrc * src)
+{
+  GstImageSequenceSrc *self = GST_IMAGE_SEQUENCE_SRC (src);
+
+  if (self->reader) {
+    gst_file_read_ahead_free (self->reader);
+    self->reader = NULL;
+  }
+
+  return TRUE;
 }
 
 static GstCaps *
@@ -442,6 +480,9 @@ gst_image_sequence_src_set_property (GObject * object, guint prop_id,
       self->fps_n = gst_value_get_fraction_numerator (value);
       self->fps_d = gst_value_get_fraction_denominator (value);
       break;
+    case PROP_READ_AHEAD:
+      self->read_ahead = g_value_get_uint (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -472,6 +513,9 @@ gst_image_sequence_src_get_property (GObject * object, guint prop_id,
       GST_DEBUG_OBJECT (self, "Set (framerate) property to (%d/%d)",
           self->fps_n, self->fps_d);
       break;
+    case PROP_READ_AHEAD:
+      g_value_set_uint (value, self->read_ahead);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -563,6 +607,29 @@ gst_image_sequence_src_get_filename (GstImageSequenceSrc * self)
   return filename;
 }
 
+/* Starts loading the current image and the ones following it in playback
+ * direction in the background.
+ * Call with LOCK */
+static void
+gst_image_sequence_src_prefetch (GstImageSequenceSrc * self)
+{
+  gint index = self->index;
+  guint i;
+
+  for (i = 0; i <= self->read_ahead; i++) {
+    gchar *filename;
+
+    if (index < self->start_index || (self->stop_index > 0
+            && index > self->stop_index))
+      break;
+
+    filename = g_strdup_printf (self->path, index);
+    gst_file_read_ahead_prefetch (self->reader, filename);
+    g_free (filename);
+    index += self->reverse ? -1 : 1;
+  }
+}
+
 static GstFlowReturn
 gst_image_sequence_src_create (GstPushSrc * src, GstBuffer ** buffer)
 {
@@ -592,6 +659,12 @@ gst_image_sequence_src_create (GstPushSrc * src, GstBuffer ** buffer)
   g_assert (start_index <= self->index &&
       (self->index <= stop_index || stop_index <= 0));
 
+  if (self->read_ahead > 0) {
+    if (self->reader == NULL)
+      self->reader = gst_file_read_ahead_new ();
+    gst_image_sequence_src_prefetch (self);
+  }
+
   filename = gst_image_sequence_src_get_filename (self);
   fps_n = self->fps_n;
   fps_d = self->fps_d;
@@ -600,7 +673,11 @@ gst_image_sequence_src_create (GstPushSrc * src, GstBuffer ** buffer)
   if (!filename)
     goto handle_error;
 
-  ret = g_file_get_contents (filename, &data, &size, &error);
+  if (self->reader)
+    ret = gst_file_read_ahead_get_contents (self->reader, filename, &data,
+        &size, &error);
+  else
+    ret = g_file_get_contents (filename, &data, &size, &error);
   if (!ret)
     goto handle_error;
 
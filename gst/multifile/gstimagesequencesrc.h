@@ -23,6 +23,7 @@
 
 #include <gst/gst.h>
 #include <gst/base/gstpushsrc.h>
+#include "gstfilereadahead.h"
 
 G_BEGIN_DECLS
 
@@ -47,6 +48,9 @@ struct _GstImageSequenceSrc
   GstCaps *caps;
 
   gint fps_n, fps_d;
+
+  guint read_ahead;
+  GstFileReadAhead *reader;
 };
 
 
@@ -69,6 +69,7 @@
 #include <gst/base/gstbasetransform.h>
 #include <gst/video/video.h>
 #include <glib/gstdio.h>
+#include <errno.h>
 #include "gstmultifilesink.h"
 
 static GstStaticPadTemplate sinktemplate = GST_STATIC_PAD_TEMPLATE ("sink",
@@ -87,6 +88,7 @@ GST_DEBUG_CATEGORY_STATIC (gst_multi_file_sink_debug);
 #define DEFAULT_MAX_FILE_SIZE G_GUINT64_CONSTANT(2*1024*1024*1024)
 #define DEFAULT_MAX_FILE_DURATION GST_CLOCK_TIME_NONE
 #define DEFAULT_AGGREGATE_GOPS FALSE
+#define DEFAULT_WRITE_BEHIND_SIZE 0
 
 enum
 {
@@ -98,7 +100,9 @@ enum
   PROP_MAX_FILES,
   PROP_MAX_FILE_SIZE,
   PROP_MAX_FILE_DURATION,
-  PROP_AGGREGATE_GOPS
+  PROP_AGGREGATE_GOPS,
+  PROP_WRITE_BEHIND_SIZE,
+  PROP_WRITE_BEHIND_LEVEL
 };
 
 static void gst_multi_file_sink_finalize (GObject * object);
@@ -110,6 +114,8 @@ static void gst_multi_file_sink_get_property (GObject * object, guint prop_id,
 
 static gboolean gst_multi_file_sink_start (GstBaseSink * bsink);
 static gboolean gst_multi_file_sink_stop (GstBaseSink * sink);
+static gboolean gst_multi_file_sink_unlock (GstBaseSink * sink);
+static gboolean gst_multi_file_sink_unlock_stop (GstBaseSink * sink);
 static GstFlowReturn gst_multi_file_sink_render (GstBaseSink * sink,
     GstBuffer * buffer);
 static GstFlowReturn gst_multi_file_sink_render_list (GstBaseSink * sink,
@@ -255,10 +261,43 @@ gst_multi_file_sink_class_init (GstMultiFileSinkClass * klass)
           "splitting", DEFAULT_AGGREGATE_GOPS,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstMultiFileSink:write-behind-size:
+   *
+   * Maximum number of bytes to queue for writing in the background. When
+   * non-zero, buffers are handed over to a shared pool of writer threads so
+   * that slow storage doesn't stall the streaming thread until this many
+   * bytes are pending. Consecutive queued buffers are written together with
+   * a single system call. 0 writes synchronously from the streaming thread.
+   *
+   * Since: 1.18
+   */
+  g_object_class_install_property (gobject_class, PROP_WRITE_BEHIND_SIZE,
+      g_param_spec_uint64 ("write-behind-size", "Write Behind Size",
+          "Maximum number of bytes queued for writing in the background "
+          "(0 = write synchronously)", 0, G_MAXUINT64,
+          DEFAULT_WRITE_BEHIND_SIZE,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstMultiFileSink:write-behind-level:
+   *
+   * Number of bytes currently queued for writing in the background.
+   *
+   * Since: 1.18
+   */
+  g_object_class_install_property (gobject_class, PROP_WRITE_BEHIND_LEVEL,
+      g_param_spec_uint64 ("write-behind-level", "Write Behind Level",
+          "Number of bytes currently queued for writing in the background",
+          0, G_MAXUINT64, 0, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
   gobject_class->finalize = gst_multi_file_sink_finalize;
 
   gstbasesink_class->start = GST_DEBUG_FUNCPTR (gst_multi_file_sink_start);
   gstbasesink_class->stop = GST_DEBUG_FUNCPTR (gst_multi_file_sink_stop);
+  gstbasesink_class->unlock = GST_DEBUG_FUNCPTR (gst_multi_file_sink_unlock);
+  gstbasesink_class->unlock_stop =
+      GST_DEBUG_FUNCPTR (gst_multi_file_sink_unlock_stop);
   gstbasesink_class->render = GST_DEBUG_FUNCPTR (gst_multi_file_sink_render);
   gstbasesink_class->render_list =
       GST_DEBUG_FUNCPTR (gst_multi_file_sink_render_list);
@@ -349,6 +388,9 @@ gst_multi_file_sink_set_property (GObject * object, guint prop_id,
     case PROP_AGGREGATE_GOPS:
       sink->aggregate_gops = g_value_get_boolean (value);
       break;
+    case PROP_WRITE_BEHIND_SIZE:
+      sink->write_behind_size = g_value_get_uint64 (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -386,12 +428,43 @@ gst_multi_file_sink_get_property (GObject * object, guint prop_id,
     case PROP_AGGREGATE_GOPS:
       g_value_set_boolean (value, sink->aggregate_gops);
       break;
+    case PROP_WRITE_BEHIND_SIZE:
+      g_value_set_uint64 (value, sink->write_behind_size);
+      break;
+    case PROP_WRITE_BEHIND_LEVEL:{
+      guint64 level = 0;
+
+      GST_OBJECT_LOCK (sink);
+      if (sink->writer)
+        level = gst_file_writer_get_level (sink->writer);
+      GST_OBJECT_UNLOCK (sink);
+      g_value_set_uint64 (value, level);
+      break;
+    }
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
   }
 }
 
+/* Waits for the background writer of the current file, if any, to finish
+ * and frees it. Returns FALSE with errno set if writing failed. */
+static gboolean
+gst_multi_file_sink_free_writer (GstMultiFileSink * sink)
+{
+  GstFileWriter *writer;
+
+  GST_OBJECT_LOCK (sink);
+  writer = sink->writer;
+  sink->writer = NULL;
+  GST_OBJECT_UNLOCK (sink);
+
+  if (writer == NULL)
+    return TRUE;
+
+  return gst_file_writer_free (writer);
+}
+
 static gboolean
 gst_multi_file_sink_start (GstBaseSink * bsink)
 {
@@ -416,6 +489,9 @@ gst_multi_file_sink_stop (GstBaseSink * sink)
   multifilesink = GST_MULTI_FILE_SINK (sink);
 
   if (multifilesink->file != NULL) {
+    if (!gst_multi_file_sink_free_writer (multifilesink))
+      GST_ELEMENT_ERROR (multifilesink, RESOURCE, WRITE,
+          ("Error while writing to file."), ("%s", g_strerror (errno)));
     fclose (multifilesink->file);
     multifilesink->file = NULL;
   }
@@ -447,6 +523,34 @@ gst_multi_file_sink_stop (GstBaseSink * sink)
   return TRUE;
 }
 
+static gboolean
+gst_multi_file_sink_unlock (GstBaseSink * sink)
+{
+  GstMultiFileSink *multifilesink = GST_MULTI_FILE_SINK (sink);
+
+  GST_OBJECT_LOCK (multifilesink);
+  multifilesink->unlocked = TRUE;
+  if (multifilesink->writer)
+    gst_file_writer_set_flushing (multifilesink->writer, TRUE);
+  GST_OBJECT_UNLOCK (multifilesink);
+
+  return TRUE;
+}
+
+static gboolean
+gst_multi_file_sink_unlock_stop (GstBaseSink * sink)
+{
+  GstMultiFileSink *multifilesink = GST_MULTI_FILE_SINK (sink);
+
+  GST_OBJECT_LOCK (multifilesink);
+  multifilesink->unlocked = FALSE;
+  if (multifilesink->writer)
+    gst_file_writer_set_flushing (multifilesink->writer, FALSE);
+  GST_OBJECT_UNLOCK (multifilesink);
+
+  return TRUE;
+}
+
 
 static void
 gst_multi_file_sink_post_message_full (GstMultiFileSink * multifilesink,
@@ -526,6 +630,18 @@ gst_multi_file_sink_post_message (GstMultiFileSink * multifilesink,
       offset, offset_end, running_time, stream_time, filename);
 }
 
+/* Writes all memories of @buffer to the current file without merging them,
+ * or queues it for the background writer if write-behind is enabled.
+ * Returns FALSE with errno set on failure. */
+static gboolean
+gst_multi_file_sink_write_memories (GstMultiFileSink * sink, GstBuffer * buffer)
+{
+  if (sink->writer)
+    return gst_file_writer_push (sink->writer, gst_buffer_ref (buffer));
+
+  return gst_file_writer_write_buffers (sink->file, &buffer, 1);
+}
+
 static gboolean
 gst_multi_file_sink_write_stream_headers (GstMultiFileSink * sink)
 {
@@ -539,18 +655,12 @@ gst_multi_file_sink_write_stream_headers (GstMultiFileSink * sink)
 
   for (i = 0; i < sink->n_streamheaders; i++) {
     GstBuffer *hdr;
-    GstMapInfo map;
-    int ret;
 
     hdr = sink->streamheaders[i];
-    gst_buffer_map (hdr, &map, GST_MAP_READ);
-    ret = fwrite (map.data, map.size, 1, sink->file);
-    gst_buffer_unmap (hdr, &map);
-
-    if (ret != 1)
+    if (!gst_multi_file_sink_write_memories (sink, hdr))
       return FALSE;
 
-    sink->cur_file_size += map.size;
+    sink->cur_file_size += gst_buffer_get_size (hdr);
   }
 
   return TRUE;
@@ -566,15 +676,15 @@ gst_multi_file_sink_write_buffer (GstMultiFileSink * multifilesink,
   GError *error = NULL;
   gboolean first_file = TRUE;
 
-  gst_buffer_map (buffer, &map, GST_MAP_READ);
-
   switch (multifilesink->next_file) {
     case GST_MULTI_FILE_SINK_NEXT_BUFFER:
       gst_multi_file_sink_ensure_max_files (multifilesink);
 
       filename = g_strdup_printf (multifilesink->filename,
           multifilesink->index);
+      gst_buffer_map (buffer, &map, GST_MAP_READ);
       ret = g_file_set_contents (filename, (char *) map.data, map.size, &error);
+      gst_buffer_unmap (buffer, &map);
       if (!ret)
         goto write_error;
 
@@ -596,8 +706,8 @@ gst_multi_file_sink_write_buffer (GstMultiFileSink * multifilesink,
           goto stdio_write_error;
       }
 
-      ret = fwrite (map.data, map.size, 1, multifilesink->file);
-      if (ret != 1)
+      ret = gst_multi_file_sink_write_memories (multifilesink, buffer);
+      if (!ret)
         goto stdio_write_error;
 
       break;
@@ -627,8 +737,8 @@ gst_multi_file_sink_write_buffer (GstMultiFileSink * multifilesink,
           gst_multi_file_sink_write_stream_headers (multifilesink);
       }
 
-      ret = fwrite (map.data, map.size, 1, multifilesink->file);
-      if (ret != 1)
+      ret = gst_multi_file_sink_write_memories (multifilesink, buffer);
+      if (!ret)
         goto stdio_write_error;
 
       break;
@@ -643,16 +753,17 @@ gst_multi_file_sink_write_buffer (GstMultiFileSink * multifilesink,
          */
       }
 
-      ret = fwrite (map.data, map.size, 1, multifilesink->file);
+      ret = gst_multi_file_sink_write_memories (multifilesink, buffer);
 
-      if (ret != 1)
+      if (!ret)
         goto stdio_write_error;
 
       break;
     case GST_MULTI_FILE_SINK_NEXT_MAX_SIZE:{
       guint64 new_size;
+      gsize size = gst_buffer_get_size (buffer);
 
-      new_size = multifilesink->cur_file_size + map.size;
+      new_size = multifilesink->cur_file_size + size;
       if (new_size > multifilesink->max_file_size) {
 
         GST_INFO_OBJECT (multifilesink, "current size: %" G_GUINT64_FORMAT
@@ -674,12 +785,12 @@ gst_multi_file_sink_write_buffer (GstMultiFileSink * multifilesink,
           gst_multi_file_sink_write_stream_headers (multifilesink);
       }
 
-      ret = fwrite (map.data, map.size, 1, multifilesink->file);
+      ret = gst_multi_file_sink_write_memories (multifilesink, buffer);
 
-      if (ret != 1)
+      if (!ret)
         goto stdio_write_error;
 
-      multifilesink->cur_file_size += map.size;
+      multifilesink->cur_file_size += size;
       break;
     }
     case GST_MULTI_FILE_SINK_NEXT_MAX_DURATION:{
@@ -715,9 +826,9 @@ gst_multi_file_sink_write_buffer (GstMultiFileSink * multifilesink,
           gst_multi_file_sink_write_stream_headers (multifilesink);
       }
 
-      ret = fwrite (map.data, map.size, 1, multifilesink->file);
+      ret = gst_multi_file_sink_write_memories (multifilesink, buffer);
 
-      if (ret != 1)
+      if (!ret)
         goto stdio_write_error;
 
       break;
@@ -726,7 +837,6 @@ gst_multi_file_sink_write_buffer (GstMultiFileSink * multifilesink,
       g_assert_not_reached ();
   }
 
-  gst_buffer_unmap (buffer, &map);
   return GST_FLOW_OK;
 
   /* ERRORS */
@@ -747,7 +857,6 @@ write_error:
     g_error_free (error);
     g_free (filename);
 
-    gst_buffer_unmap (buffer, &map);
     return GST_FLOW_ERROR;
   }
 stdio_write_error:
@@ -760,7 +869,6 @@ stdio_write_error:
       GST_ELEMENT_ERROR (multifilesink, RESOURCE, WRITE,
           ("Error while writing to file."), ("%s", g_strerror (errno)));
   }
-  gst_buffer_unmap (buffer, &map);
   return GST_FLOW_ERROR;
 }
 
@@ -861,21 +969,23 @@ static GstFlowReturn
 gst_multi_file_sink_render_list (GstBaseSink * sink, GstBufferList * list)
 {
   GstBuffer *buf;
+  GstFlowReturn flow;
   guint size;
 
   size = gst_buffer_list_calculate_size (list);
   GST_LOG_OBJECT (sink, "total size of buffer list %p: %u", list, size);
 
-  /* copy all buffers in the list into one single buffer, so we can use
-   * the normal render function (FIXME: optimise to avoid the memcpy) */
+  /* collect the memories of all buffers in the list into one single buffer,
+   * so we can use the normal render function. The memories are written out
+   * with a single writev() without being merged */
   buf = gst_buffer_new ();
   gst_buffer_list_foreach (list, buffer_list_copy_data, buf);
   g_assert (gst_buffer_get_size (buf) == size);
 
-  gst_multi_file_sink_render (sink, buf);
+  flow = gst_multi_file_sink_render (sink, buf);
   gst_buffer_unref (buf);
 
-  return GST_FLOW_OK;
+  return flow;
 }
 
 static gboolean
@@ -1055,6 +1165,17 @@ gst_multi_file_sink_open_next_file (GstMultiFileSink * multifilesink)
 
   GST_INFO_OBJECT (multifilesink, "opening file %s", filename);
 
+  if (multifilesink->write_behind_size > 0) {
+    GstFileWriter *writer = gst_file_writer_new (multifilesink->file,
+        multifilesink->write_behind_size);
+
+    GST_OBJECT_LOCK (multifilesink);
+    if (multifilesink->unlocked)
+      gst_file_writer_set_flushing (writer, TRUE);
+    multifilesink->writer = writer;
+    GST_OBJECT_UNLOCK (multifilesink);
+  }
+
   gst_multi_file_sink_add_old_file (multifilesink, filename);
 
   multifilesink->cur_file_size = 0;
@@ -1067,6 +1188,9 @@ gst_multi_file_sink_close_file (GstMultiFileSink * multifilesink,
 {
   char *filename;
 
+  if (!gst_multi_file_sink_free_writer (multifilesink))
+    GST_ELEMENT_ERROR (multifilesink, RESOURCE, WRITE,
+        ("Error while writing to file."), ("%s", g_strerror (errno)));
   fclose (multifilesink->file);
   multifilesink->file = NULL;
 
@@ -35,6 +35,7 @@
 #ifdef HAVE_UNISTD_H
 #include <unistd.h>
 #endif
+#include "gstfilewriter.h"
 
 G_BEGIN_DECLS
 
@@ -104,6 +105,10 @@ struct _GstMultiFileSink
   gboolean aggregate_gops;
   GstAdapter *gop_adapter;  /* to aggregate GOPs */
   GList *potential_next_gop;	/* To detect false-positives */
+
+  guint64 write_behind_size;
+  GstFileWriter *writer;    /* protected by OBJECT_LOCK, NULL if disabled */
+  gboolean unlocked;        /* protected by OBJECT_LOCK */
 };
 
 struct _GstMultiFileSinkClass
@@ -52,6 +52,7 @@ static GstFlowReturn gst_multi_file_src_create (GstPushSrc * src,
     GstBuffer ** buffer);
 
 static void gst_multi_file_src_dispose (GObject * object);
+static gboolean gst_multi_file_src_stop (GstBaseSrc * src);
 
 static void gst_multi_file_src_set_property (GObject * object, guint prop_id,
     const GValue * value, GParamSpec * pspec);
@@ -80,11 +81,13 @@ enum
   PROP_START_INDEX,
   PROP_STOP_INDEX,
   PROP_CAPS,
-  PROP_LOOP
+  PROP_LOOP,
+  PROP_READ_AHEAD
 };
 
 #define DEFAULT_LOCATION "%05d"
 #define DEFAULT_INDEX 0
+#define DEFAULT_READ_AHEAD 0
 
 #define gst_multi_file_src_parent_class parent_class
 G_DEFINE_TYPE_WITH_CODE (GstMultiFileSrc, gst_multi_file_src, GST_TYPE_PUSH_SRC,
@@ -122,6 +125,10 @@ do_seek (GstBaseSrc * bsrc, GstSegment * segment)
     return FALSE;
   }
 
+  /* files read ahead for the old position are of no use anymore */
+  if (src->reader)
+    gst_file_read_ahead_flush (src->reader);
+
   /* now move to the position indicated */
   if (src->fps_n) {
     src->index = gst_util_uint64_scale (position,
@@ -180,10 +187,27 @@ gst_multi_file_src_class_init (GstMultiFileSrcClass * klass)
           "Whether to repeat from the beginning when all files have been read.",
           FALSE, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstMultiFileSrc:read-ahead:
+   *
+   * Number of files following the current one to load in the background.
+   * This hides the latency of slow storage, e.g. network file systems, at
+   * the cost of keeping up to this many files in memory. 0 reads each file
+   * only once it is needed.
+   *
+   * Since: 1.18
+   */
+  g_object_class_install_property (gobject_class, PROP_READ_AHEAD,
+      g_param_spec_uint ("read-ahead", "Read Ahead",
+          "Number of files to load in the background ahead of the current "
+          "one (0 = disabled)", 0, 256, DEFAULT_READ_AHEAD,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gobject_class->dispose = gst_multi_file_src_dispose;
 
   gstbasesrc_class->get_caps = gst_multi_file_src_getcaps;
   gstbasesrc_class->query = gst_multi_file_src_query;
+  gstbasesrc_class->stop = gst_multi_file_src_stop;
   gstbasesrc_class->is_seekable = is_seekable;
   gstbasesrc_class->do_seek = do_seek;
 
@@ -208,6 +232,7 @@ gst_multi_file_src_init (GstMultiFileSrc * multifilesrc)
   multifilesrc->filename = g_strdup (DEFAULT_LOCATION);
   multifilesrc->successful_read = FALSE;
   multifilesrc->fps_n = multifilesrc->fps_d = -1;
+  multifilesrc->read_ahead = DEFAULT_READ_AHEAD;
 
 }
 
@@ -224,6 +249,19 @@ gst_multi_file_src_dispose (GObject * object)
   G_OBJECT_CLASS (parent_class)->dispose (object);
 }
 
+static gboolean
+gst_multi_file_src_stop (GstBaseSrc * src)
+{
+  GstMultiFileSrc *multifilesrc = GST_MULTI_FILE_SRC (src);
+
+  if (multifilesrc->reader) {
+    gst_file_read_ahead_free (multifilesrc->reader);
+    multifilesrc->reader = NULL;
+  }
+
+  return TRUE;
+}
+
 static GstCaps *
 gst_multi_file_src_getcaps (GstBaseSrc * src, GstCaps * filter)
 {
@@ -347,6 +385,9 @@ gst_multi_file_src_set_property (GObject * object, guint prop_id,
     case PROP_LOOP:
       src->loop = g_value_get_boolean (value);
       break;
+    case PROP_READ_AHEAD:
+      src->read_ahead = g_value_get_uint (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -378,6 +419,9 @@ gst_multi_file_src_get_property (GObject * object, guint prop_id,
     case PROP_LOOP:
       g_value_set_boolean (value, src->loop);
       break;
+    case PROP_READ_AHEAD:
+      g_value_set_uint (value, src->read_ahead);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -395,6 +439,41 @@ gst_multi_file_src_get_filename (GstMultiFileSrc * multifilesrc)
   return filename;
 }
 
+/* Starts loading the current file and the ones following it in the
+ * background */
+static void
+gst_multi_file_src_prefetch (GstMultiFileSrc * multifilesrc)
+{
+  gint index = multifilesrc->index;
+  guint i;
+
+  for (i = 0; i <= multifilesrc->read_ahead; i++) {
+    gchar *filename;
+
+    if (multifilesrc->stop_index != -1 && index > multifilesrc->stop_index) {
+      if (!multifilesrc->loop)
+        break;
+      index = multifilesrc->start_index;
+    }
+
+    filename = g_strdup_printf (multifilesrc->filename, index);
+    gst_file_read_ahead_prefetch (multifilesrc->reader, filename);
+    g_free (filename);
+    index++;
+  }
+}
+
+static gboolean
+gst_multi_file_src_get_contents (GstMultiFileSrc * multifilesrc,
+    const gchar * filename, gchar ** data, gsize * size, GError ** error)
+{
+  if (multifilesrc->reader)
+    return gst_file_read_ahead_get_contents (multifilesrc->reader, filename,
+        data, size, error);
+
+  return g_file_get_contents (filename, data, size, error);
+}
+
 static GstFlowReturn
 gst_multi_file_src_create (GstPushSrc * src, GstBuffer ** buffer)
 {
@@ -420,11 +499,18 @@ gst_multi_file_src_create (GstPushSrc * src, GstBuffer ** buffer)
       return GST_FLOW_EOS;
   }
 
+  if (multifilesrc->read_ahead > 0) {
+    if (multifilesrc->reader == NULL)
+      multifilesrc->reader = gst_file_read_ahead_new ();
+    gst_multi_file_src_prefetch (multifilesrc);
+  }
+
   filename = gst_multi_file_src_get_filename (multifilesrc);
 
   GST_DEBUG_OBJECT (multifilesrc, "reading from file \"%s\".", filename);
 
-  ret = g_file_get_contents (filename, &data, &size, &error);
+  ret = gst_multi_file_src_get_contents (multifilesrc, filename, &data, &size,
+      &error);
   if (!ret) {
     if (multifilesrc->successful_read) {
       /* If we've read at least one buffer successfully, not finding the
@@ -438,7 +524,8 @@ gst_multi_file_src_create (GstPushSrc * src, GstBuffer ** buffer)
         multifilesrc->index = multifilesrc->start_index;
 
         filename = gst_multi_file_src_get_filename (multifilesrc);
-        ret = g_file_get_contents (filename, &data, &size, &error);
+        ret = gst_multi_file_src_get_contents (multifilesrc, filename, &data,
+            &size, &error);
         if (!ret) {
           g_free (filename);
           if (error != NULL)
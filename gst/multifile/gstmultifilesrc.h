@@ -24,6 +24,7 @@
 
 #include <gst/gst.h>
 #include <gst/base/gstpushsrc.h>
+#include "gstfilereadahead.h"
 
 G_BEGIN_DECLS
 
@@ -58,6 +59,9 @@ struct _GstMultiFileSrc
   gboolean successful_read;
 
   gint fps_n, fps_d;
+
+  guint read_ahead;
+  GstFileReadAhead *reader;
 };
 
 struct _GstMultiFileSrcClass
@@ -635,6 +635,7 @@ gst_splitmux_part_reader_init (GstSplitMuxPartReader * reader)
 
   reader->active = FALSE;
   reader->duration = GST_CLOCK_TIME_NONE;
+  reader->end_offset = GST_CLOCK_TIME_NONE;
 
   g_cond_init (&reader->inactive_cond);
   g_mutex_init (&reader->lock);
@@ -905,6 +906,19 @@ gst_splitmux_part_reader_finish_measuring_streams (GstSplitMuxPartReader *
 {
   SPLITMUX_PART_LOCK (reader);
   if (reader->prep_state == PART_STATE_PREPARING_RESET_FOR_READY) {
+    /* Remember where this part ends, so the offset stays available after
+     * the part is closed again and doesn't need measuring when reopened */
+    if (!GST_CLOCK_TIME_IS_VALID (reader->end_offset)) {
+      GList *cur;
+
+      for (cur = g_list_first (reader->pads); cur != NULL;
+          cur = g_list_next (cur)) {
+        GstSplitMuxPartPad *part_pad = SPLITMUX_PART_PAD_CAST (cur->data);
+        if (!part_pad->is_sparse && part_pad->max_ts < reader->end_offset)
+          reader->end_offset = part_pad->max_ts;
+      }
+    }
+
     /* Fire the prepared signal and go to READY state */
     GST_DEBUG_OBJECT (reader,
         "Stream measuring complete. File %s is now ready", reader->path);
@@ -978,6 +992,16 @@ check_if_pads_collected (GstSplitMuxPartReader * reader)
   if (reader->prep_state == PART_STATE_PREPARING_COLLECT_STREAMS) {
     /* Check we have all pads and each pad has seen a buffer */
     if (reader->no_more_pads && splitmux_part_is_prerolled_locked (reader)) {
+      if (GST_CLOCK_TIME_IS_VALID (reader->end_offset)) {
+        /* Reopening a part that was measured before */
+        GST_DEBUG_OBJECT (reader,
+            "no more pads - file %s. Length already known", reader->path);
+        reader->prep_state = PART_STATE_PREPARING_RESET_FOR_READY;
+        gst_element_call_async (GST_ELEMENT_CAST (reader),
+            (GstElementCallAsyncFunc)
+            gst_splitmux_part_reader_finish_measuring_streams, NULL, NULL);
+        return;
+      }
       GST_DEBUG_OBJECT (reader,
           "no more pads - file %s. Measuring stream length", reader->path);
       reader->prep_state = PART_STATE_PREPARING_MEASURE_STREAMS;
@@ -1167,6 +1191,18 @@ gst_splitmux_part_reader_unprepare (GstSplitMuxPartReader * part)
   gst_element_set_state (GST_ELEMENT_CAST (part), GST_STATE_NULL);
 }
 
+gboolean
+gst_splitmux_part_reader_is_prepared (GstSplitMuxPartReader * part)
+{
+  gboolean ret;
+
+  SPLITMUX_PART_LOCK (part);
+  ret = (part->prep_state == PART_STATE_READY);
+  SPLITMUX_PART_UNLOCK (part);
+
+  return ret;
+}
+
 void
 gst_splitmux_part_reader_set_location (GstSplitMuxPartReader * reader,
     const gchar * path)
@@ -1243,6 +1279,12 @@ gst_splitmux_part_reader_get_end_offset (GstSplitMuxPartReader * reader)
   GstClockTime ret = GST_CLOCK_TIME_NONE;
 
   SPLITMUX_PART_LOCK (reader);
+  if (GST_CLOCK_TIME_IS_VALID (reader->end_offset)) {
+    ret = reader->end_offset;
+    SPLITMUX_PART_UNLOCK (reader);
+    return ret;
+  }
+
   for (cur = g_list_first (reader->pads); cur != NULL; cur = g_list_next (cur)) {
     GstSplitMuxPartPad *part_pad = SPLITMUX_PART_PAD_CAST (cur->data);
     if (!part_pad->is_sparse && part_pad->max_ts < ret)
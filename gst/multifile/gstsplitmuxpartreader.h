@@ -74,6 +74,7 @@ struct _GstSplitMuxPartReader
   GstClockTime duration;
   GstClockTime start_offset;
   GstClockTime ts_offset;
+  GstClockTime end_offset;
 
   GList *pads;
 
@@ -100,6 +101,7 @@ void gst_splitmux_part_reader_set_callbacks (GstSplitMuxPartReader *reader,
     gpointer cb_data, GstSplitMuxPartReaderPadCb get_pad_cb);
 gboolean gst_splitmux_part_reader_prepare (GstSplitMuxPartReader *part);
 void gst_splitmux_part_reader_unprepare (GstSplitMuxPartReader *part);
+gboolean gst_splitmux_part_reader_is_prepared (GstSplitMuxPartReader *part);
 void gst_splitmux_part_reader_set_location (GstSplitMuxPartReader *reader,
     const gchar *path);
 gboolean gst_splitmux_part_is_eos (GstSplitMuxPartReader *reader);
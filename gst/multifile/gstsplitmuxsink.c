@@ -116,7 +116,8 @@ enum
   PROP_SINK_FACTORY,
   PROP_SINK_PRESET,
   PROP_SINK_PROPERTIES,
-  PROP_MUXERPAD_MAP
+  PROP_MUXERPAD_MAP,
+  PROP_PREPARE_NEXT_FRAGMENT
 };
 
 #define DEFAULT_MAX_SIZE_TIME       0
@@ -130,6 +131,7 @@ enum
 #define DEFAULT_USE_ROBUST_MUXING FALSE
 #define DEFAULT_RESET_MUXER TRUE
 #define DEFAULT_ASYNC_FINALIZE FALSE
+#define DEFAULT_PREPARE_NEXT_FRAGMENT FALSE
 #define DEFAULT_START_INDEX 0
 
 typedef struct _AsyncEosHelper
@@ -431,6 +433,24 @@ gst_splitmux_sink_class_init (GstSplitMuxSinkClass * klass)
           "Example: {properties,boolean-prop=true,string-prop=\"hi\"}. "
           "Valid only for async-finalize = TRUE",
           GST_TYPE_STRUCTURE, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+  /**
+   * GstSplitMuxSink:prepare-next-fragment
+   *
+   * Create, configure and link the muxer and sink for the next fragment in
+   * the background as soon as a fragment starts, instead of when switching
+   * to the next one. This way only the streams need relinking and the new
+   * file opening at the split point. This only has an effect in
+   * `async-finalize=TRUE` mode.
+   *
+   * Since: 1.18
+   */
+  g_object_class_install_property (gobject_class, PROP_PREPARE_NEXT_FRAGMENT,
+      g_param_spec_boolean ("prepare-next-fragment",
+          "Prepare next fragment",
+          "Prepare the muxer and sink of the next fragment in advance. "
+          "Valid only for async-finalize = TRUE",
+          DEFAULT_PREPARE_NEXT_FRAGMENT,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
   g_object_class_install_property (gobject_class, PROP_START_INDEX,
       g_param_spec_int ("start-index", "Start Index",
           "Start value of fragment index.",
@@ -594,6 +614,7 @@ gst_splitmux_sink_init (GstSplitMuxSink * splitmux)
   gst_splitmux_reset_timecode (splitmux);
 
   splitmux->async_finalize = DEFAULT_ASYNC_FINALIZE;
+  splitmux->prepare_next_fragment = DEFAULT_PREPARE_NEXT_FRAGMENT;
   splitmux->muxer_factory = g_strdup (DEFAULT_MUXER);
   splitmux->muxer_properties = NULL;
   splitmux->sink_factory = g_strdup (DEFAULT_SINK);
@@ -606,9 +627,26 @@ gst_splitmux_sink_init (GstSplitMuxSink * splitmux)
   splitmux->next_fku_time = GST_CLOCK_TIME_NONE;
 }
 
+static void
+gst_splitmux_drop_next_elements (GstSplitMuxSink * splitmux)
+{
+  if (splitmux->next_muxer) {
+    gst_element_set_state (splitmux->next_muxer, GST_STATE_NULL);
+    gst_bin_remove (GST_BIN (splitmux), splitmux->next_muxer);
+  }
+  if (splitmux->next_sink) {
+    gst_element_set_state (splitmux->next_sink, GST_STATE_NULL);
+    gst_bin_remove (GST_BIN (splitmux), splitmux->next_sink);
+  }
+
+  splitmux->next_muxer = splitmux->next_sink = NULL;
+}
+
 static void
 gst_splitmux_reset_elements (GstSplitMuxSink * splitmux)
 {
+  gst_splitmux_drop_next_elements (splitmux);
+
   if (splitmux->muxer) {
     gst_element_set_locked_state (splitmux->muxer, TRUE);
     gst_element_set_state (splitmux->muxer, GST_STATE_NULL);
@@ -639,6 +677,7 @@ gst_splitmux_sink_dispose (GObject * object)
 
   /* Calling parent dispose invalidates all child pointers */
   splitmux->sink = splitmux->active_sink = splitmux->muxer = NULL;
+  splitmux->next_sink = splitmux->next_muxer = NULL;
 
   G_OBJECT_CLASS (parent_class)->dispose (object);
 }
@@ -832,6 +871,11 @@ gst_splitmux_sink_set_property (GObject * object, guint prop_id,
       splitmux->async_finalize = g_value_get_boolean (value);
       GST_OBJECT_UNLOCK (splitmux);
       break;
+    case PROP_PREPARE_NEXT_FRAGMENT:
+      GST_OBJECT_LOCK (splitmux);
+      splitmux->prepare_next_fragment = g_value_get_boolean (value);
+      GST_OBJECT_UNLOCK (splitmux);
+      break;
     case PROP_MUXER_FACTORY:
       GST_OBJECT_LOCK (splitmux);
       if (splitmux->muxer_factory)
@@ -979,6 +1023,11 @@ gst_splitmux_sink_get_property (GObject * object, guint prop_id,
       g_value_set_boolean (value, splitmux->async_finalize);
       GST_OBJECT_UNLOCK (splitmux);
       break;
+    case PROP_PREPARE_NEXT_FRAGMENT:
+      GST_OBJECT_LOCK (splitmux);
+      g_value_set_boolean (value, splitmux->prepare_next_fragment);
+      GST_OBJECT_UNLOCK (splitmux);
+      break;
     case PROP_MUXER_FACTORY:
       GST_OBJECT_LOCK (splitmux);
       g_value_set_string (value, splitmux->muxer_factory);
@@ -1878,6 +1927,93 @@ _send_event (const GValue * value, gpointer user_data)
   gst_pad_send_event (pad, gst_event_ref (ev));
 }
 
+/* Called with lock held. Creates and configures the muxer and sink
+ * for fragment @id in async-finalize mode */
+static gboolean
+create_fragment_elements (GstSplitMuxSink * splitmux, guint id,
+    GstElement ** muxer_out, GstElement ** sink_out)
+{
+  GstElement *muxer, *sink;
+  gchar *newname;
+
+  newname = g_strdup_printf ("sink_%u", id);
+  sink = create_element (splitmux, splitmux->sink_factory, newname, TRUE);
+  g_free (newname);
+  if (sink == NULL)
+    return FALSE;
+  if (splitmux->sink_preset && GST_IS_PRESET (sink))
+    gst_preset_load_preset (GST_PRESET (sink), splitmux->sink_preset);
+  if (splitmux->sink_properties)
+    gst_structure_foreach (splitmux->sink_properties,
+        _set_property_from_structure, sink);
+  g_signal_emit (splitmux, signals[SIGNAL_SINK_ADDED], 0, sink);
+
+  newname = g_strdup_printf ("muxer_%u", id);
+  muxer = create_element (splitmux, splitmux->muxer_factory, newname, TRUE);
+  g_free (newname);
+  if (muxer == NULL) {
+    gst_bin_remove (GST_BIN (splitmux), sink);
+    return FALSE;
+  }
+  if (g_object_class_find_property (G_OBJECT_GET_CLASS (sink),
+          "async") != NULL) {
+    /* async child elements are causing state change races and weird
+     * failures, so let's try and turn that off */
+    g_object_set (sink, "async", FALSE, NULL);
+  }
+  if (splitmux->muxer_preset && GST_IS_PRESET (muxer))
+    gst_preset_load_preset (GST_PRESET (muxer), splitmux->muxer_preset);
+  if (splitmux->muxer_properties)
+    gst_structure_foreach (splitmux->muxer_properties,
+        _set_property_from_structure, muxer);
+  g_signal_emit (splitmux, signals[SIGNAL_MUXER_ADDED], 0, muxer);
+
+  *muxer_out = muxer;
+  *sink_out = sink;
+  return TRUE;
+}
+
+/* Creates, links and readies the muxer and sink for the next fragment
+ * while the current one is being written, so the switch doesn't have to */
+static void
+prepare_next_fragment_elements (GstSplitMuxSink * splitmux, gpointer user_data)
+{
+  GstElement *muxer, *sink;
+
+  /* Serialise against fragment switches and state changes */
+  GST_STATE_LOCK (splitmux);
+  GST_SPLITMUX_LOCK (splitmux);
+  if (splitmux->next_muxer != NULL
+      || splitmux->output_state == SPLITMUX_OUTPUT_STATE_STOPPED
+      || GST_STATE_TARGET (splitmux) < GST_STATE_PAUSED)
+    goto done;
+
+  GST_DEBUG_OBJECT (splitmux, "Preparing muxer and sink for fragment %u",
+      splitmux->fragment_id);
+  if (!create_fragment_elements (splitmux, splitmux->fragment_id, &muxer,
+          &sink))
+    goto done;
+  GST_SPLITMUX_UNLOCK (splitmux);
+
+  if (!gst_element_link (muxer, sink)) {
+    GST_WARNING_OBJECT (splitmux, "Failed to link prepared muxer and sink");
+    gst_bin_remove (GST_BIN (splitmux), muxer);
+    gst_bin_remove (GST_BIN (splitmux), sink);
+    GST_STATE_UNLOCK (splitmux);
+    return;
+  }
+  gst_element_set_state (sink, GST_STATE_READY);
+  gst_element_set_state (muxer, GST_STATE_READY);
+
+  GST_SPLITMUX_LOCK (splitmux);
+  splitmux->next_muxer = muxer;
+  splitmux->next_sink = sink;
+
+done:
+  GST_SPLITMUX_UNLOCK (splitmux);
+  GST_STATE_UNLOCK (splitmux);
+}
+
 /* Called with lock held when a fragment
  * reaches EOS and it is time to restart
  * a new fragment
@@ -1886,6 +2022,7 @@ static void
 start_next_fragment (GstSplitMuxSink * splitmux, MqStreamCtx * ctx)
 {
   GstElement *muxer, *sink;
+  gint64 switch_start = g_get_monotonic_time ();
 
   g_assert (ctx->is_reference);
 
@@ -1903,51 +2040,29 @@ start_next_fragment (GstSplitMuxSink * splitmux, MqStreamCtx * ctx)
   if (splitmux->async_finalize) {
     if (splitmux->muxed_out_bytes > 0
         || splitmux->fragment_id != splitmux->start_index) {
-      gchar *newname;
       GstElement *new_sink, *new_muxer;
+      gboolean prelinked = FALSE;
 
       GST_DEBUG_OBJECT (splitmux, "Starting fragment %u",
           splitmux->fragment_id);
       g_list_foreach (splitmux->contexts, (GFunc) block_context, splitmux);
-      newname = g_strdup_printf ("sink_%u", splitmux->fragment_id);
       GST_SPLITMUX_LOCK (splitmux);
-      if ((splitmux->sink =
-              create_element (splitmux, splitmux->sink_factory, newname,
-                  TRUE)) == NULL)
-        goto fail;
-      if (splitmux->sink_preset && GST_IS_PRESET (splitmux->sink))
-        gst_preset_load_preset (GST_PRESET (splitmux->sink),
-            splitmux->sink_preset);
-      if (splitmux->sink_properties)
-        gst_structure_foreach (splitmux->sink_properties,
-            _set_property_from_structure, splitmux->sink);
-      splitmux->active_sink = splitmux->sink;
-      g_signal_emit (splitmux, signals[SIGNAL_SINK_ADDED], 0, splitmux->sink);
-      g_free (newname);
-      newname = g_strdup_printf ("muxer_%u", splitmux->fragment_id);
-      if ((splitmux->muxer =
-              create_element (splitmux, splitmux->muxer_factory, newname,
-                  TRUE)) == NULL)
+      if (splitmux->next_muxer != NULL) {
+        GST_DEBUG_OBJECT (splitmux, "Using muxer and sink prepared in advance");
+        new_muxer = splitmux->next_muxer;
+        new_sink = splitmux->next_sink;
+        splitmux->next_muxer = splitmux->next_sink = NULL;
+        prelinked = TRUE;
+      } else if (!create_fragment_elements (splitmux, splitmux->fragment_id,
+              &new_muxer, &new_sink)) {
         goto fail;
-      if (g_object_class_find_property (G_OBJECT_GET_CLASS (splitmux->sink),
-              "async") != NULL) {
-        /* async child elements are causing state change races and weird
-         * failures, so let's try and turn that off */
-        g_object_set (splitmux->sink, "async", FALSE, NULL);
       }
-      if (splitmux->muxer_preset && GST_IS_PRESET (splitmux->muxer))
-        gst_preset_load_preset (GST_PRESET (splitmux->muxer),
-            splitmux->muxer_preset);
-      if (splitmux->muxer_properties)
-        gst_structure_foreach (splitmux->muxer_properties,
-            _set_property_from_structure, splitmux->muxer);
-      g_signal_emit (splitmux, signals[SIGNAL_MUXER_ADDED], 0, splitmux->muxer);
-      g_free (newname);
-      new_sink = splitmux->sink;
-      new_muxer = splitmux->muxer;
+      splitmux->muxer = new_muxer;
+      splitmux->sink = splitmux->active_sink = new_sink;
       GST_SPLITMUX_UNLOCK (splitmux);
       g_list_foreach (splitmux->contexts, (GFunc) relink_context, splitmux);
-      gst_element_link (new_muxer, new_sink);
+      if (!prelinked)
+        gst_element_link (new_muxer, new_sink);
 
       if (g_object_get_qdata ((GObject *) sink, EOS_FROM_US)) {
         if (GPOINTER_TO_INT (g_object_get_qdata ((GObject *) sink,
@@ -2022,6 +2137,14 @@ start_next_fragment (GstSplitMuxSink * splitmux, MqStreamCtx * ctx)
 
   send_fragment_opened_closed_msg (splitmux, TRUE, sink);
 
+  GST_DEBUG_OBJECT (splitmux, "Switching fragment took %" G_GINT64_FORMAT
+      " us", g_get_monotonic_time () - switch_start);
+
+  if (splitmux->async_finalize && splitmux->prepare_next_fragment) {
+    gst_element_call_async (GST_ELEMENT_CAST (splitmux),
+        (GstElementCallAsyncFunc) prepare_next_fragment_elements, NULL, NULL);
+  }
+
   /* FIXME: Is this always the correct next state? */
   GST_LOG_OBJECT (splitmux, "Resetting state to AWAITING_COMMAND");
   splitmux->output_state = SPLITMUX_OUTPUT_STATE_AWAITING_COMMAND;
@@ -3572,6 +3695,11 @@ gst_splitmux_sink_change_state (GstElement * element, GstStateChange transition)
       ret = GST_STATE_CHANGE_ASYNC;
       break;
     }
+    case GST_STATE_CHANGE_PAUSED_TO_READY:
+      GST_SPLITMUX_LOCK (splitmux);
+      gst_splitmux_drop_next_elements (splitmux);
+      GST_SPLITMUX_UNLOCK (splitmux);
+      break;
     case GST_STATE_CHANGE_READY_TO_NULL:
       GST_SPLITMUX_LOCK (splitmux);
       splitmux->fragment_id = 0;
@@ -193,6 +193,10 @@ struct _GstSplitMuxSink
   gchar *sink_factory;
   gchar *sink_preset;
   GstStructure *sink_properties;
+  gboolean prepare_next_fragment;
+  /* Muxer and sink created ahead of time for the next fragment */
+  GstElement *next_muxer;
+  GstElement *next_sink;
 
   GstStructure *muxerpad_map;
 };
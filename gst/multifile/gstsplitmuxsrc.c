@@ -57,10 +57,13 @@ GST_DEBUG_CATEGORY (splitmux_debug);
 
 #define FIXED_TS_OFFSET (1000*GST_SECOND)
 
+#define DEFAULT_NUM_OPEN_FRAGMENTS 0
+
 enum
 {
   PROP_0,
-  PROP_LOCATION
+  PROP_LOCATION,
+  PROP_NUM_OPEN_FRAGMENTS
 };
 
 enum
@@ -232,6 +235,22 @@ gst_splitmux_src_class_init (GstSplitMuxSrcClass * klass)
           "Glob pattern for the location of the files to read", NULL,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstSplitMuxSrc:num-open-fragments:
+   *
+   * Maximum number of file parts to keep open at the same time. Parts are
+   * still all measured at startup, but once measured any part beyond this
+   * limit is closed again and reopened on demand when playback gets to it.
+   * The least recently used parts are closed first. 0 keeps all parts open.
+   *
+   * Since: 1.18
+   */
+  g_object_class_install_property (gobject_class, PROP_NUM_OPEN_FRAGMENTS,
+      g_param_spec_uint ("num-open-fragments", "Open files limit",
+          "Number of files to keep open at the same time (0 = unlimited)",
+          0, G_MAXUINT, DEFAULT_NUM_OPEN_FRAGMENTS,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   /**
    * GstSplitMuxSrc::format-location:
    * @splitmux: the #GstSplitMuxSrc
@@ -251,8 +270,10 @@ static void
 gst_splitmux_src_init (GstSplitMuxSrc * splitmux)
 {
   g_mutex_init (&splitmux->lock);
+  g_mutex_init (&splitmux->open_lock);
   g_rw_lock_init (&splitmux->pads_rwlock);
   splitmux->total_duration = GST_CLOCK_TIME_NONE;
+  splitmux->num_open_fragments = DEFAULT_NUM_OPEN_FRAGMENTS;
   gst_segment_init (&splitmux->play_segment, GST_FORMAT_TIME);
 }
 
@@ -282,6 +303,7 @@ gst_splitmux_src_finalize (GObject * object)
 {
   GstSplitMuxSrc *splitmux = GST_SPLITMUX_SRC (object);
   g_mutex_clear (&splitmux->lock);
+  g_mutex_clear (&splitmux->open_lock);
   g_rw_lock_clear (&splitmux->pads_rwlock);
   g_free (splitmux->location);
 
@@ -302,6 +324,11 @@ gst_splitmux_src_set_property (GObject * object, guint prop_id,
       GST_OBJECT_UNLOCK (splitmux);
       break;
     }
+    case PROP_NUM_OPEN_FRAGMENTS:
+      GST_OBJECT_LOCK (splitmux);
+      splitmux->num_open_fragments = g_value_get_uint (value);
+      GST_OBJECT_UNLOCK (splitmux);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -320,6 +347,11 @@ gst_splitmux_src_get_property (GObject * object, guint prop_id,
       g_value_set_string (value, splitmux->location);
       GST_OBJECT_UNLOCK (splitmux);
       break;
+    case PROP_NUM_OPEN_FRAGMENTS:
+      GST_OBJECT_LOCK (splitmux);
+      g_value_set_uint (value, splitmux->num_open_fragments);
+      GST_OBJECT_UNLOCK (splitmux);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -408,9 +440,12 @@ gst_splitmux_src_change_state (GstElement * element, GstStateChange transition)
 static void
 gst_splitmux_src_activate_first_part (GstSplitMuxSrc * splitmux)
 {
+  gboolean prepared = gst_splitmux_src_ensure_part_prepared (splitmux, 0);
+
   SPLITMUX_SRC_LOCK (splitmux);
   if (splitmux->running) {
-    if (!gst_splitmux_src_activate_part (splitmux, 0, GST_SEEK_FLAG_NONE)) {
+    if (!prepared
+        || !gst_splitmux_src_activate_part (splitmux, 0, GST_SEEK_FLAG_NONE)) {
       GST_ELEMENT_ERROR (splitmux, RESOURCE, OPEN_READ, (NULL),
           ("Failed to activate first part for playback"));
     }
@@ -418,6 +453,219 @@ gst_splitmux_src_activate_first_part (GstSplitMuxSrc * splitmux)
   SPLITMUX_SRC_UNLOCK (splitmux);
 }
 
+/* Called with the splitmux lock held */
+static gboolean
+gst_splitmux_src_part_in_use (GstSplitMuxSrc * splitmux, guint idx)
+{
+  gboolean ret = FALSE;
+  GList *cur;
+
+  if (idx == splitmux->cur_part
+      || gst_splitmux_part_reader_is_active (splitmux->parts[idx]))
+    return TRUE;
+
+  SPLITMUX_SRC_PADS_RLOCK (splitmux);
+  for (cur = g_list_first (splitmux->pads);
+      cur != NULL; cur = g_list_next (cur)) {
+    SplitMuxSrcPad *splitpad = (SplitMuxSrcPad *) (cur->data);
+    if (splitpad->cur_part == idx) {
+      ret = TRUE;
+      break;
+    }
+  }
+  SPLITMUX_SRC_PADS_RUNLOCK (splitmux);
+
+  return ret;
+}
+
+/* Unprepare and unref the collected parts. Must be called without the
+ * splitmux lock held, as the pad callbacks of the parts take it while they
+ * are shut down */
+static void
+gst_splitmux_src_unprepare_parts (GstSplitMuxSrc * splitmux, GList * parts)
+{
+  GList *cur;
+
+  for (cur = parts; cur != NULL; cur = g_list_next (cur)) {
+    GstSplitMuxPartReader *part = cur->data;
+
+    GST_DEBUG_OBJECT (splitmux, "Closing file part %s", part->path);
+    gst_splitmux_part_reader_unprepare (part);
+  }
+  g_list_free_full (parts, gst_object_unref);
+}
+
+/* Closes the least recently used parts until no more than
+ * num-open-fragments are left open */
+static void
+gst_splitmux_src_close_unused_parts (GstSplitMuxSrc * splitmux,
+    gpointer user_data)
+{
+  GList *victims = NULL;
+  guint max_open;
+  guint i, n_open = 0;
+
+  GST_OBJECT_LOCK (splitmux);
+  max_open = splitmux->num_open_fragments;
+  GST_OBJECT_UNLOCK (splitmux);
+
+  if (max_open == 0)
+    return;
+
+  g_mutex_lock (&splitmux->open_lock);
+  SPLITMUX_SRC_LOCK (splitmux);
+  if (!splitmux->running)
+    goto done;
+
+  for (i = 0; i < splitmux->num_prepared_parts; i++) {
+    if (splitmux->parts[i] != NULL
+        && gst_splitmux_part_reader_is_prepared (splitmux->parts[i]))
+      n_open++;
+  }
+
+  while (n_open > max_open) {
+    gint victim = -1;
+
+    for (i = 0; i < splitmux->num_prepared_parts; i++) {
+      if (splitmux->parts[i] == NULL
+          || !gst_splitmux_part_reader_is_prepared (splitmux->parts[i])
+          || g_list_find (victims, splitmux->parts[i])
+          || gst_splitmux_src_part_in_use (splitmux, i))
+        continue;
+      /* On ties, prefer closing parts further from the start */
+      if (victim == -1 ||
+          splitmux->part_last_used[i] <= splitmux->part_last_used[victim])
+        victim = i;
+    }
+
+    if (victim == -1)
+      break;
+
+    victims = g_list_prepend (victims, gst_object_ref (splitmux->parts[victim]));
+    n_open--;
+  }
+
+done:
+  SPLITMUX_SRC_UNLOCK (splitmux);
+
+  gst_splitmux_src_unprepare_parts (splitmux, victims);
+  g_mutex_unlock (&splitmux->open_lock);
+}
+
+static void
+gst_splitmux_src_close_prepared_part (GstSplitMuxSrc * splitmux,
+    gpointer user_data)
+{
+  guint idx = GPOINTER_TO_UINT (user_data);
+  GList *victims = NULL;
+
+  g_mutex_lock (&splitmux->open_lock);
+  SPLITMUX_SRC_LOCK (splitmux);
+  if (splitmux->running && idx < splitmux->num_prepared_parts
+      && splitmux->parts[idx] != NULL
+      && splitmux->part_last_used[idx] == 0
+      && !gst_splitmux_src_part_in_use (splitmux, idx)) {
+    victims = g_list_prepend (victims, gst_object_ref (splitmux->parts[idx]));
+  }
+  SPLITMUX_SRC_UNLOCK (splitmux);
+
+  gst_splitmux_src_unprepare_parts (splitmux, victims);
+  g_mutex_unlock (&splitmux->open_lock);
+}
+
+/* Must be called without the splitmux lock held, as reopening the part
+ * blocks until its pads were exposed again */
+static gboolean
+gst_splitmux_src_ensure_part_prepared (GstSplitMuxSrc * splitmux, guint idx)
+{
+  GstSplitMuxPartReader *part;
+  gboolean ret = TRUE;
+  gboolean stopped;
+
+  g_mutex_lock (&splitmux->open_lock);
+  SPLITMUX_SRC_LOCK (splitmux);
+  if (!splitmux->running || idx >= splitmux->num_parts
+      || splitmux->parts[idx] == NULL) {
+    SPLITMUX_SRC_UNLOCK (splitmux);
+    g_mutex_unlock (&splitmux->open_lock);
+    return FALSE;
+  }
+  part = gst_object_ref (splitmux->parts[idx]);
+  splitmux->part_last_used[idx] = ++splitmux->part_use_count;
+  SPLITMUX_SRC_UNLOCK (splitmux);
+
+  if (!gst_splitmux_part_reader_is_prepared (part)) {
+    GST_DEBUG_OBJECT (splitmux, "Reopening file part %s (%u)", part->path,
+        idx);
+    if (!gst_splitmux_part_reader_prepare (part) ||
+        gst_element_get_state (GST_ELEMENT_CAST (part), NULL, NULL,
+            GST_CLOCK_TIME_NONE) == GST_STATE_CHANGE_FAILURE) {
+      GST_WARNING_OBJECT (splitmux, "Failed to reopen file part %s",
+          part->path);
+      ret = FALSE;
+    }
+
+    SPLITMUX_SRC_LOCK (splitmux);
+    stopped = !splitmux->running;
+    SPLITMUX_SRC_UNLOCK (splitmux);
+
+    /* Stopped meanwhile, don't leave the part open */
+    if (stopped) {
+      gst_splitmux_part_reader_unprepare (part);
+      ret = FALSE;
+    }
+  }
+  g_mutex_unlock (&splitmux->open_lock);
+
+  gst_object_unref (part);
+  return ret;
+}
+
+/* Reopen the part playback will move to next, so the switch doesn't
+ * have to wait for it */
+static void
+gst_splitmux_src_prepare_lookahead (GstSplitMuxSrc * splitmux,
+    gpointer user_data)
+{
+  gint next_part;
+
+  SPLITMUX_SRC_LOCK (splitmux);
+  if (splitmux->play_segment.rate >= 0.0)
+    next_part = splitmux->cur_part + 1;
+  else
+    next_part = (gint) splitmux->cur_part - 1;
+  SPLITMUX_SRC_UNLOCK (splitmux);
+
+  if (next_part >= 0)
+    gst_splitmux_src_ensure_part_prepared (splitmux, next_part);
+}
+
+/* Called with the splitmux lock held, after a part was activated */
+static void
+gst_splitmux_src_update_open_parts (GstSplitMuxSrc * splitmux)
+{
+  guint max_open;
+
+  GST_OBJECT_LOCK (splitmux);
+  max_open = splitmux->num_open_fragments;
+  GST_OBJECT_UNLOCK (splitmux);
+
+  if (max_open == 0)
+    return;
+
+  /* Parts can't be closed with the lock held */
+  splitmux->part_last_used[splitmux->cur_part] = ++splitmux->part_use_count;
+  gst_element_call_async (GST_ELEMENT_CAST (splitmux),
+      (GstElementCallAsyncFunc) gst_splitmux_src_close_unused_parts,
+      NULL, NULL);
+
+  if (max_open > 1) {
+    gst_element_call_async (GST_ELEMENT_CAST (splitmux),
+        (GstElementCallAsyncFunc) gst_splitmux_src_prepare_lookahead,
+        NULL, NULL);
+  }
+}
+
 static GstBusSyncReply
 gst_splitmux_part_bus_handler (GstBus * bus, GstMessage * msg,
     gpointer user_data)
@@ -428,11 +676,14 @@ gst_splitmux_part_bus_handler (GstBus * bus, GstMessage * msg,
     case GST_MESSAGE_ASYNC_DONE:{
       guint idx = splitmux->num_prepared_parts;
       gboolean need_no_more_pads;
-
-      if (idx >= splitmux->num_parts) {
-        /* Shouldn't really happen! */
-        do_async_done (splitmux);
-        g_warn_if_reached ();
+      guint max_open;
+
+      if (idx >= splitmux->num_parts
+          || GST_MESSAGE_SRC (msg) != GST_OBJECT_CAST (splitmux->parts[idx])) {
+        /* A part that was closed to stay within num-open-fragments
+         * finished reopening. Nothing to do here */
+        GST_LOG_OBJECT (splitmux, "Reopened part %" GST_PTR_FORMAT
+            " is prepared", GST_MESSAGE_SRC (msg));
         break;
       }
 
@@ -469,6 +720,17 @@ gst_splitmux_part_bus_handler (GstBus * bus, GstMessage * msg,
 
       splitmux->num_prepared_parts++;
 
+      /* Now that its offsets are known, close the part again if it's
+       * beyond the number of parts we may keep open */
+      GST_OBJECT_LOCK (splitmux);
+      max_open = splitmux->num_open_fragments;
+      GST_OBJECT_UNLOCK (splitmux);
+      if (max_open > 0 && idx >= max_open) {
+        gst_element_call_async (GST_ELEMENT_CAST (splitmux),
+            (GstElementCallAsyncFunc) gst_splitmux_src_close_prepared_part,
+            GUINT_TO_POINTER (idx), NULL);
+      }
+
       /* If we're done or preparing the next part fails, finish here */
       if (splitmux->num_prepared_parts >= splitmux->num_parts
           || !gst_splitmux_src_prepare_next_part (splitmux)) {
@@ -854,6 +1116,8 @@ gst_splitmux_src_activate_part (GstSplitMuxSrc * splitmux, guint part,
   }
   SPLITMUX_SRC_PADS_RUNLOCK (splitmux);
 
+  gst_splitmux_src_update_open_parts (splitmux);
+
   return TRUE;
 }
 
@@ -930,6 +1194,8 @@ gst_splitmux_src_start (GstSplitMuxSrc * splitmux)
   splitmux->num_parts = g_strv_length (files);
 
   splitmux->parts = g_new0 (GstSplitMuxPartReader *, splitmux->num_parts);
+  splitmux->part_last_used = g_new0 (guint64, splitmux->num_parts);
+  splitmux->part_use_count = 0;
 
   /* Create all part pipelines */
   for (i = 0; i < splitmux->num_parts; i++) {
@@ -1025,6 +1291,8 @@ gst_splitmux_src_stop (GstSplitMuxSrc * splitmux)
 
   g_free (splitmux->parts);
   splitmux->parts = NULL;
+  g_free (splitmux->part_last_used);
+  splitmux->part_last_used = NULL;
   splitmux->num_parts = 0;
   splitmux->num_prepared_parts = 0;
   splitmux->num_created_parts = 0;
@@ -1192,6 +1460,15 @@ gst_splitmux_end_of_part (GstSplitMuxSrc * splitmux, SplitMuxSrcPad * splitpad)
     }
   }
 
+  /* Reopen the next part first if it was closed to stay within
+   * num-open-fragments. This can't be done with the lock held */
+  if (next_part != -1
+      && !gst_splitmux_src_ensure_part_prepared (splitmux, next_part)) {
+    GST_ELEMENT_ERROR (splitmux, RESOURCE, READ, (NULL),
+        ("Failed to reopen part %d", next_part));
+    return FALSE;
+  }
+
   SPLITMUX_SRC_LOCK (splitmux);
 
   /* If all pads are done with this part, deactivate it */
@@ -1252,6 +1529,7 @@ gst_splitmux_end_of_part (GstSplitMuxSrc * splitmux, SplitMuxSrcPad * splitpad)
           goto error;
       }
       splitmux->cur_part = next_part;
+      gst_splitmux_src_update_open_parts (splitmux);
     }
     res = TRUE;
   }
@@ -1426,6 +1704,18 @@ splitmux_src_pad_event (GstPad * pad, GstObject * parent, GstEvent * event)
           GST_TIME_FORMAT, GST_TIME_ARGS (position),
           i, GST_TIME_ARGS (position - part_start));
 
+      /* Reopen the part if it was closed, which can't be done with the
+       * lock held */
+      SPLITMUX_SRC_UNLOCK (splitmux);
+      if (!gst_splitmux_src_ensure_part_prepared (splitmux, i)) {
+        /* The flush is already done and nothing restarts the pad tasks
+         * without an active part */
+        GST_ELEMENT_ERROR (splitmux, RESOURCE, READ, (NULL),
+            ("Failed to reopen part %d for seeking", i));
+        goto done;
+      }
+      SPLITMUX_SRC_LOCK (splitmux);
+
       ret = gst_splitmux_src_activate_part (splitmux, i, flags);
       SPLITMUX_SRC_UNLOCK (splitmux);
     }
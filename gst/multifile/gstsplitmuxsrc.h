@@ -48,6 +48,7 @@ struct _GstSplitMuxSrc
   gboolean     running;
 
   gchar       *location;  /* OBJECT_LOCK */
+  guint        num_open_fragments; /* OBJECT_LOCK */
 
   GstSplitMuxPartReader **parts;
   guint        num_parts;
@@ -55,6 +56,14 @@ struct _GstSplitMuxSrc
   guint        num_created_parts;
   guint        cur_part;
 
+  /* Last use of each part, to pick which ones to close */
+  guint64     *part_last_used;
+  guint64      part_use_count;
+  /* Serialises opening and closing parts. Never taken by pad callbacks,
+   * so unlike the splitmux lock it can be held while changing the state
+   * of a part */
+  GMutex       open_lock;
+
   gboolean async_pending;
   gboolean pads_complete;
 
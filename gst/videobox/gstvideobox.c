@@ -2425,6 +2425,10 @@ static gboolean gst_video_box_src_event (GstBaseTransform * trans,
 
 static gboolean gst_video_box_set_info (GstVideoFilter * vfilter, GstCaps * in,
     GstVideoInfo * in_info, GstCaps * out, GstVideoInfo * out_info);
+static gboolean gst_video_box_decide_allocation (GstBaseTransform * trans,
+    GstQuery * query);
+static GstFlowReturn gst_video_box_transform_ip (GstBaseTransform * trans,
+    GstBuffer * buf);
 static GstFlowReturn gst_video_box_transform_frame (GstVideoFilter * vfilter,
     GstVideoFrame * in_frame, GstVideoFrame * out_frame);
 
@@ -2519,6 +2523,10 @@ gst_video_box_class_init (GstVideoBoxClass * klass)
   trans_class->transform_caps =
       GST_DEBUG_FUNCPTR (gst_video_box_transform_caps);
   trans_class->src_event = GST_DEBUG_FUNCPTR (gst_video_box_src_event);
+  trans_class->decide_allocation =
+      GST_DEBUG_FUNCPTR (gst_video_box_decide_allocation);
+  trans_class->transform_ip = GST_DEBUG_FUNCPTR (gst_video_box_transform_ip);
+  trans_class->transform_ip_on_passthrough = FALSE;
 
   vfilter_class->set_info = GST_DEBUG_FUNCPTR (gst_video_box_set_info);
   vfilter_class->transform_frame =
@@ -2552,6 +2560,7 @@ gst_video_box_init (GstVideoBox * video_box)
   video_box->alpha = DEFAULT_ALPHA;
   video_box->border_alpha = DEFAULT_BORDER_ALPHA;
   video_box->autocrop = FALSE;
+  video_box->use_crop_meta = FALSE;
 
   g_mutex_init (&video_box->mutex);
 }
@@ -3175,6 +3184,11 @@ gst_video_box_set_info (GstVideoFilter * vfilter, GstCaps * in,
 
   if (ret)
     ret = gst_video_box_select_processing_functions (video_box);
+
+  /* The new configuration might not be a pure crop anymore. Ensure our
+   * decide_allocation will be called again to decide about it */
+  video_box->use_crop_meta = FALSE;
+  gst_base_transform_set_in_place (GST_BASE_TRANSFORM (video_box), FALSE);
   g_mutex_unlock (&video_box->mutex);
 
   return ret;
@@ -3332,6 +3346,91 @@ gst_video_box_transform_frame (GstVideoFilter * vfilter,
   return GST_FLOW_OK;
 }
 
+/* Whether the output is just a rectangle of the input, which downstream can
+ * get as the input buffer with a crop meta instead of a copy. Formats with
+ * alpha are excluded as the copy scales the alpha channel */
+static gboolean
+gst_video_box_is_pure_crop (GstVideoBox * video_box)
+{
+  const GstVideoFormatInfo *finfo =
+      gst_video_format_get_info (video_box->out_format);
+
+  return video_box->in_format == video_box->out_format &&
+      video_box->in_sdtv == video_box->out_sdtv &&
+      !GST_VIDEO_FORMAT_INFO_HAS_ALPHA (finfo) &&
+      video_box->box_left >= 0 && video_box->box_right >= 0 &&
+      video_box->box_top >= 0 && video_box->box_bottom >= 0;
+}
+
+static gboolean
+gst_video_box_decide_allocation (GstBaseTransform * trans, GstQuery * query)
+{
+  GstVideoBox *video_box = GST_VIDEO_BOX (trans);
+  gboolean use_crop_meta;
+
+  use_crop_meta = (gst_query_find_allocation_meta (query,
+          GST_VIDEO_CROP_META_API_TYPE, NULL) &&
+      gst_query_find_allocation_meta (query, GST_VIDEO_META_API_TYPE, NULL));
+
+  g_mutex_lock (&video_box->mutex);
+  video_box->use_crop_meta = use_crop_meta &&
+      !gst_base_transform_is_passthrough (trans) &&
+      gst_video_box_is_pure_crop (video_box);
+
+  if (video_box->use_crop_meta)
+    GST_INFO_OBJECT (video_box, "we are cropping in-place using crop meta");
+  gst_base_transform_set_in_place (trans, video_box->use_crop_meta);
+  g_mutex_unlock (&video_box->mutex);
+
+  return GST_BASE_TRANSFORM_CLASS (parent_class)->decide_allocation (trans,
+      query);
+}
+
+static GstFlowReturn
+gst_video_box_transform_ip (GstBaseTransform * trans, GstBuffer * buf)
+{
+  GstVideoBox *video_box = GST_VIDEO_BOX (trans);
+  GstVideoFilter *vfilter = GST_VIDEO_FILTER (trans);
+  GstVideoMeta *video_meta;
+  GstVideoCropMeta *crop_meta;
+
+  GST_LOG_OBJECT (video_box, "Cropping in-place");
+
+  g_mutex_lock (&video_box->mutex);
+  /* The properties changed since the caps were negotiated and the output
+   * can't be expressed as a crop of this buffer anymore. The pending
+   * reconfiguration switches back to the pixel path */
+  if (G_UNLIKELY (!gst_video_box_is_pure_crop (video_box))) {
+    g_mutex_unlock (&video_box->mutex);
+    GST_DEBUG_OBJECT (video_box, "not a pure crop anymore, dropping buffer");
+    return GST_BASE_TRANSFORM_FLOW_DROPPED;
+  }
+
+  /* The caps get smaller, so downstream needs the video meta to map the
+   * buffer with its full size */
+  video_meta = gst_buffer_get_video_meta (buf);
+  if (!video_meta) {
+    gst_buffer_add_video_meta_full (buf, GST_VIDEO_FRAME_FLAG_NONE,
+        GST_VIDEO_INFO_FORMAT (&vfilter->in_info),
+        GST_VIDEO_INFO_WIDTH (&vfilter->in_info),
+        GST_VIDEO_INFO_HEIGHT (&vfilter->in_info),
+        GST_VIDEO_INFO_N_PLANES (&vfilter->in_info), vfilter->in_info.offset,
+        vfilter->in_info.stride);
+  }
+
+  crop_meta = gst_buffer_get_video_crop_meta (buf);
+  if (!crop_meta)
+    crop_meta = gst_buffer_add_video_crop_meta (buf);
+
+  crop_meta->x += video_box->crop_left;
+  crop_meta->y += video_box->crop_top;
+  crop_meta->width = video_box->out_width;
+  crop_meta->height = video_box->out_height;
+  g_mutex_unlock (&video_box->mutex);
+
+  return GST_FLOW_OK;
+}
+
 /* FIXME: 0.11 merge with videocrop plugin */
 static gboolean
 plugin_init (GstPlugin * plugin)
@@ -0,0 +1,126 @@
+/* GStreamer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Splits a frame into horizontal bands that are processed in parallel, by
+ * the streaming thread and the threads of a pool owned by the element */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "gstvideobands.h"
+
+typedef struct
+{
+  GstVideoBandFunc func;
+  gpointer user_data;
+  guint n_bands;
+  gint next_band;
+
+  GMutex lock;
+  GCond cond;
+  guint n_pending;
+} GstVideoBandsJob;
+
+static void
+gst_video_bands_process (GstVideoBandsJob * job)
+{
+  guint i;
+
+  while ((i = g_atomic_int_add (&job->next_band, 1)) < job->n_bands)
+    job->func (job->user_data, i, job->n_bands);
+}
+
+static void
+gst_video_bands_worker_func (GstVideoBandsJob * job, gpointer user_data)
+{
+  gst_video_bands_process (job);
+
+  g_mutex_lock (&job->lock);
+  if (--job->n_pending == 0)
+    g_cond_signal (&job->cond);
+  g_mutex_unlock (&job->lock);
+}
+
+/* Number of bands to use for @n_threads threads, 0 meaning one per CPU,
+ * such that no band is lower than @min_band_height lines. At least 1 */
+guint
+gst_video_bands_get_count (guint n_threads, gint height, gint min_band_height)
+{
+  if (n_threads == 0)
+    n_threads = g_get_num_processors ();
+
+  n_threads = MIN (n_threads, height / min_band_height);
+
+  return MAX (n_threads, 1);
+}
+
+/* Calls @func for each of the @n_bands bands and returns once all of them
+ * are done. The calling thread takes part, the other bands are handled by
+ * up to @n_bands - 1 threads of *@pool, which is created or grown as
+ * needed */
+void
+gst_video_bands_run (GThreadPool ** pool, guint n_bands,
+    GstVideoBandFunc func, gpointer user_data)
+{
+  GstVideoBandsJob job;
+  guint i;
+
+  if (n_bands <= 1) {
+    func (user_data, 0, 1);
+    return;
+  }
+
+  if (*pool == NULL) {
+    *pool = g_thread_pool_new ((GFunc) gst_video_bands_worker_func, NULL,
+        n_bands - 1, TRUE, NULL);
+  } else if (g_thread_pool_get_max_threads (*pool) < (gint) n_bands - 1) {
+    g_thread_pool_set_max_threads (*pool, n_bands - 1, NULL);
+  }
+
+  job.func = func;
+  job.user_data = user_data;
+  job.n_bands = n_bands;
+  job.next_band = 0;
+  g_mutex_init (&job.lock);
+  g_cond_init (&job.cond);
+  job.n_pending = n_bands - 1;
+
+  for (i = 1; i < n_bands; i++)
+    g_thread_pool_push (*pool, &job, NULL);
+
+  gst_video_bands_process (&job);
+
+  g_mutex_lock (&job.lock);
+  while (job.n_pending > 0)
+    g_cond_wait (&job.cond, &job.lock);
+  g_mutex_unlock (&job.lock);
+
+  g_mutex_clear (&job.lock);
+  g_cond_clear (&job.cond);
+}
+
+/* Stops the threads of *@pool, if any */
+void
+gst_video_bands_free_pool (GThreadPool ** pool)
+{
+  if (*pool) {
+    g_thread_pool_free (*pool, FALSE, TRUE);
+    *pool = NULL;
+  }
+}
@@ -0,0 +1,43 @@
+/* GStreamer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GST_VIDEO_BANDS_H__
+#define __GST_VIDEO_BANDS_H__
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+/* Processes band @band of @n_bands */
+typedef void (*GstVideoBandFunc) (gpointer user_data, guint band,
+    guint n_bands);
+
+G_GNUC_INTERNAL
+guint gst_video_bands_get_count (guint n_threads, gint height,
+    gint min_band_height);
+
+G_GNUC_INTERNAL
+void gst_video_bands_run (GThreadPool ** pool, guint n_bands,
+    GstVideoBandFunc func, gpointer user_data);
+
+G_GNUC_INTERNAL
+void gst_video_bands_free_pool (GThreadPool ** pool);
+
+G_END_DECLS
+
+#endif /* __GST_VIDEO_BANDS_H__ */
@@ -43,6 +43,7 @@
 #endif
 
 #include "gstvideoflip.h"
+#include "gstvideobands.h"
 
 #include <string.h>
 #include <gst/gst.h>
@@ -53,11 +54,13 @@ enum
 {
   PROP_0,
   PROP_METHOD,
-  PROP_VIDEO_DIRECTION
+  PROP_VIDEO_DIRECTION,
+  PROP_N_THREADS
       /* FILL ME */
 };
 
 #define PROP_METHOD_DEFAULT GST_VIDEO_FLIP_METHOD_IDENTITY
+#define DEFAULT_N_THREADS 1
 
 GST_DEBUG_CATEGORY_STATIC (video_flip_debug);
 #define GST_CAT_DEFAULT video_flip_debug
@@ -195,6 +198,179 @@ gst_video_flip_transform_caps (GstBaseTransform * trans,
   return ret;
 }
 
+/* Side of the square tiles the transposing methods work on. A tile reads
+ * TRANSPOSE_TILE source lines, which stay in the cache while the
+ * corresponding columns are written out */
+#define TRANSPOSE_TILE 16
+
+/* Minimum number of output lines per thread */
+#define MIN_BAND_HEIGHT 32
+
+#define TRANSPOSE_LINE(pstride) G_STMT_START {  \
+  for (i = 0; i < n; i++) {                     \
+    memcpy (d, s, pstride);                     \
+    d += pstride;                               \
+    s += step;                                  \
+  }                                             \
+} G_STMT_END
+
+/* Writes the output lines y0 to y1 of a plane for one of the transposing
+ * methods. @sw and @sh are the source plane size in pixels of @pstride
+ * bytes. Output line y is made of source column sx(y), output column x of
+ * source line sy(x), both of which are linear */
+static void
+gst_video_flip_transpose_plane (GstVideoOrientationMethod method,
+    guint8 * dest, gint dest_stride, const guint8 * src, gint src_stride,
+    gint sw, gint sh, gint pstride, gint y0, gint y1)
+{
+  gint dw = sh;
+  gint sx0, sx_dir, sy0, sy_dir;
+  gint tx, ty, x1, y, i, n, step;
+
+  switch (method) {
+    case GST_VIDEO_ORIENTATION_90R:
+      sx0 = 0;
+      sx_dir = 1;
+      sy0 = sh - 1;
+      sy_dir = -1;
+      break;
+    case GST_VIDEO_ORIENTATION_90L:
+      sx0 = sw - 1;
+      sx_dir = -1;
+      sy0 = 0;
+      sy_dir = 1;
+      break;
+    case GST_VIDEO_ORIENTATION_UL_LR:
+      sx0 = 0;
+      sx_dir = 1;
+      sy0 = 0;
+      sy_dir = 1;
+      break;
+    case GST_VIDEO_ORIENTATION_UR_LL:
+      sx0 = sw - 1;
+      sx_dir = -1;
+      sy0 = sh - 1;
+      sy_dir = -1;
+      break;
+    default:
+      g_assert_not_reached ();
+      return;
+  }
+
+  step = sy_dir * src_stride;
+
+  for (ty = y0; ty < y1; ty += TRANSPOSE_TILE) {
+    gint ty1 = MIN (ty + TRANSPOSE_TILE, y1);
+
+    for (tx = 0; tx < dw; tx += TRANSPOSE_TILE) {
+      x1 = MIN (tx + TRANSPOSE_TILE, dw);
+      n = x1 - tx;
+
+      for (y = ty; y < ty1; y++) {
+        guint8 *d = dest + y * dest_stride + tx * pstride;
+        const guint8 *s = src + (sy0 + sy_dir * tx) * src_stride +
+            (sx0 + sx_dir * y) * pstride;
+
+        /* Constant sizes let the compiler turn the copies into single
+         * loads and stores */
+        switch (pstride) {
+          case 1:
+            TRANSPOSE_LINE (1);
+            break;
+          case 2:
+            TRANSPOSE_LINE (2);
+            break;
+          case 3:
+            TRANSPOSE_LINE (3);
+            break;
+          case 4:
+            TRANSPOSE_LINE (4);
+            break;
+          default:
+            TRANSPOSE_LINE (pstride);
+            break;
+        }
+      }
+    }
+  }
+}
+
+#undef TRANSPOSE_LINE
+
+/* Transposes the output lines y0 to y1 of all planes. Each plane is handled
+ * in units of the pixel stride of its first component, which moves the
+ * interleaved chroma of the semi-planar formats and the components of the
+ * packed formats together */
+static void
+gst_video_flip_transpose_band (GstVideoOrientationMethod method,
+    GstVideoFrame * dest, const GstVideoFrame * src, gint y0, gint y1)
+{
+  const GstVideoFormatInfo *finfo = src->info.finfo;
+  guint i, j;
+
+  for (i = 0; i < GST_VIDEO_FRAME_N_COMPONENTS (src); i++) {
+    guint plane = GST_VIDEO_FORMAT_INFO_PLANE (finfo, i);
+
+    for (j = 0; j < i; j++) {
+      if (GST_VIDEO_FORMAT_INFO_PLANE (finfo, j) == plane)
+        break;
+    }
+    if (j < i)
+      continue;
+
+    gst_video_flip_transpose_plane (method,
+        GST_VIDEO_FRAME_PLANE_DATA (dest, plane),
+        GST_VIDEO_FRAME_PLANE_STRIDE (dest, plane),
+        GST_VIDEO_FRAME_PLANE_DATA (src, plane),
+        GST_VIDEO_FRAME_PLANE_STRIDE (src, plane),
+        GST_VIDEO_FRAME_COMP_WIDTH (src, i),
+        GST_VIDEO_FRAME_COMP_HEIGHT (src, i),
+        GST_VIDEO_FRAME_COMP_PSTRIDE (src, i),
+        GST_VIDEO_FORMAT_INFO_SCALE_HEIGHT (finfo, i, y0),
+        GST_VIDEO_FORMAT_INFO_SCALE_HEIGHT (finfo, i, y1));
+  }
+}
+
+typedef struct
+{
+  GstVideoOrientationMethod method;
+  GstVideoFrame *dest;
+  const GstVideoFrame *src;
+} GstVideoFlipJob;
+
+static void
+gst_video_flip_transpose_job_band (GstVideoFlipJob * job, guint band,
+    guint n_bands)
+{
+  gint height = GST_VIDEO_FRAME_HEIGHT (job->dest);
+  /* Bands start on tile boundaries, which also keeps them on even lines
+   * for the vertically subsampled formats */
+  gint y0 = (height * band / n_bands) & ~(TRANSPOSE_TILE - 1);
+  gint y1 = band + 1 == n_bands ? height :
+      (height * (band + 1) / n_bands) & ~(TRANSPOSE_TILE - 1);
+
+  gst_video_flip_transpose_band (job->method, job->dest, job->src, y0, y1);
+}
+
+/* Implements the transposing methods for all formats but the packed 4:2:2
+ * ones, splitting the output into bands over up to n-threads threads.
+ * Called with the object lock */
+static void
+gst_video_flip_transpose (GstVideoFlip * videoflip, GstVideoFrame * dest,
+    const GstVideoFrame * src)
+{
+  GstVideoFlipJob job;
+
+  job.method = videoflip->active_method;
+  job.dest = dest;
+  job.src = src;
+
+  gst_video_bands_run (&videoflip->pool,
+      gst_video_bands_get_count (videoflip->n_threads,
+          GST_VIDEO_FRAME_HEIGHT (dest), MIN_BAND_HEIGHT),
+      (GstVideoBandFunc) gst_video_flip_transpose_job_band, &job);
+}
+
 static void
 gst_video_flip_planar_yuv (GstVideoFlip * videoflip, GstVideoFrame * dest,
     const GstVideoFrame * src)
@@ -235,62 +411,10 @@ gst_video_flip_planar_yuv (GstVideoFlip * videoflip, GstVideoFrame * dest,
 
   switch (videoflip->active_method) {
     case GST_VIDEO_ORIENTATION_90R:
-      /* Flip Y */
-      s = GST_VIDEO_FRAME_PLANE_DATA (src, 0);
-      d = GST_VIDEO_FRAME_PLANE_DATA (dest, 0);
-      for (y = 0; y < dest_y_height; y++) {
-        for (x = 0; x < dest_y_width; x++) {
-          d[y * dest_y_stride + x] =
-              s[(src_y_height - 1 - x) * src_y_stride + y];
-        }
-      }
-      /* Flip U */
-      s = GST_VIDEO_FRAME_PLANE_DATA (src, 1);
-      d = GST_VIDEO_FRAME_PLANE_DATA (dest, 1);
-      for (y = 0; y < dest_u_height; y++) {
-        for (x = 0; x < dest_u_width; x++) {
-          d[y * dest_u_stride + x] =
-              s[(src_u_height - 1 - x) * src_u_stride + y];
-        }
-      }
-      /* Flip V */
-      s = GST_VIDEO_FRAME_PLANE_DATA (src, 2);
-      d = GST_VIDEO_FRAME_PLANE_DATA (dest, 2);
-      for (y = 0; y < dest_v_height; y++) {
-        for (x = 0; x < dest_v_width; x++) {
-          d[y * dest_v_stride + x] =
-              s[(src_v_height - 1 - x) * src_v_stride + y];
-        }
-      }
-      break;
     case GST_VIDEO_ORIENTATION_90L:
-      /* Flip Y */
-      s = GST_VIDEO_FRAME_PLANE_DATA (src, 0);
-      d = GST_VIDEO_FRAME_PLANE_DATA (dest, 0);
-      for (y = 0; y < dest_y_height; y++) {
-        for (x = 0; x < dest_y_width; x++) {
-          d[y * dest_y_stride + x] =
-              s[x * src_y_stride + (src_y_width - 1 - y)];
-        }
-      }
-      /* Flip U */
-      s = GST_VIDEO_FRAME_PLANE_DATA (src, 1);
-      d = GST_VIDEO_FRAME_PLANE_DATA (dest, 1);
-      for (y = 0; y < dest_u_height; y++) {
-        for (x = 0; x < dest_u_width; x++) {
-          d[y * dest_u_stride + x] =
-              s[x * src_u_stride + (src_u_width - 1 - y)];
-        }
-      }
-      /* Flip V */
-      s = GST_VIDEO_FRAME_PLANE_DATA (src, 2);
-      d = GST_VIDEO_FRAME_PLANE_DATA (dest, 2);
-      for (y = 0; y < dest_v_height; y++) {
-        for (x = 0; x < dest_v_width; x++) {
-          d[y * dest_v_stride + x] =
-              s[x * src_v_stride + (src_v_width - 1 - y)];
-        }
-      }
+    case GST_VIDEO_ORIENTATION_UL_LR:
+    case GST_VIDEO_ORIENTATION_UR_LL:
+      gst_video_flip_transpose (videoflip, dest, src);
       break;
     case GST_VIDEO_ORIENTATION_180:
       /* Flip Y */
@@ -379,61 +503,6 @@ gst_video_flip_planar_yuv (GstVideoFlip * videoflip, GstVideoFrame * dest,
         }
       }
       break;
-    case GST_VIDEO_ORIENTATION_UL_LR:
-      /* Flip Y */
-      s = GST_VIDEO_FRAME_PLANE_DATA (src, 0);
-      d = GST_VIDEO_FRAME_PLANE_DATA (dest, 0);
-      for (y = 0; y < dest_y_height; y++) {
-        for (x = 0; x < dest_y_width; x++) {
-          d[y * dest_y_stride + x] = s[x * src_y_stride + y];
-        }
-      }
-      /* Flip U */
-      s = GST_VIDEO_FRAME_PLANE_DATA (src, 1);
-      d = GST_VIDEO_FRAME_PLANE_DATA (dest, 1);
-      for (y = 0; y < dest_u_height; y++) {
-        for (x = 0; x < dest_u_width; x++) {
-          d[y * dest_u_stride + x] = s[x * src_u_stride + y];
-        }
-      }
-      /* Flip V */
-      s = GST_VIDEO_FRAME_PLANE_DATA (src, 2);
-      d = GST_VIDEO_FRAME_PLANE_DATA (dest, 2);
-      for (y = 0; y < dest_u_height; y++) {
-        for (x = 0; x < dest_u_width; x++) {
-          d[y * dest_v_stride + x] = s[x * src_v_stride + y];
-        }
-      }
-      break;
-    case GST_VIDEO_ORIENTATION_UR_LL:
-      /* Flip Y */
-      s = GST_VIDEO_FRAME_PLANE_DATA (src, 0);
-      d = GST_VIDEO_FRAME_PLANE_DATA (dest, 0);
-      for (y = 0; y < dest_y_height; y++) {
-        for (x = 0; x < dest_y_width; x++) {
-          d[y * dest_y_stride + x] =
-              s[(src_y_height - 1 - x) * src_y_stride + (src_y_width - 1 - y)];
-        }
-      }
-      /* Flip U */
-      s = GST_VIDEO_FRAME_PLANE_DATA (src, 1);
-      d = GST_VIDEO_FRAME_PLANE_DATA (dest, 1);
-      for (y = 0; y < dest_u_height; y++) {
-        for (x = 0; x < dest_u_width; x++) {
-          d[y * dest_u_stride + x] =
-              s[(src_u_height - 1 - x) * src_u_stride + (src_u_width - 1 - y)];
-        }
-      }
-      /* Flip V */
-      s = GST_VIDEO_FRAME_PLANE_DATA (src, 2);
-      d = GST_VIDEO_FRAME_PLANE_DATA (dest, 2);
-      for (y = 0; y < dest_v_height; y++) {
-        for (x = 0; x < dest_v_width; x++) {
-          d[y * dest_v_stride + x] =
-              s[(src_v_height - 1 - x) * src_v_stride + (src_v_width - 1 - y)];
-        }
-      }
-      break;
     case GST_VIDEO_ORIENTATION_IDENTITY:
       g_assert_not_reached ();
       break;
@@ -479,48 +548,10 @@ gst_video_flip_semi_planar_yuv (GstVideoFlip * videoflip, GstVideoFrame * dest,
 
   switch (videoflip->active_method) {
     case GST_VIDEO_ORIENTATION_90R:
-      /* Flip Y */
-      s = GST_VIDEO_FRAME_PLANE_DATA (src, 0);
-      d = GST_VIDEO_FRAME_PLANE_DATA (dest, 0);
-      for (y = 0; y < dest_y_height; y++) {
-        for (x = 0; x < dest_y_width; x++) {
-          d[y * dest_y_stride + x] =
-              s[(src_y_height - 1 - x) * src_y_stride + y];
-        }
-      }
-      /* Flip UV */
-      s = GST_VIDEO_FRAME_PLANE_DATA (src, 1);
-      d = GST_VIDEO_FRAME_PLANE_DATA (dest, 1);
-      for (y = 0; y < dest_uv_height; y++) {
-        for (x = 0; x < dest_uv_width; x++) {
-          d_off = y * dest_uv_stride + x * 2;
-          s_off = (src_uv_height - 1 - x) * src_uv_stride + y * 2;
-          d[d_off] = s[s_off];
-          d[d_off + 1] = s[s_off + 1];
-        }
-      }
-      break;
     case GST_VIDEO_ORIENTATION_90L:
-      /* Flip Y */
-      s = GST_VIDEO_FRAME_PLANE_DATA (src, 0);
-      d = GST_VIDEO_FRAME_PLANE_DATA (dest, 0);
-      for (y = 0; y < dest_y_height; y++) {
-        for (x = 0; x < dest_y_width; x++) {
-          d[y * dest_y_stride + x] =
-              s[x * src_y_stride + (src_y_width - 1 - y)];
-        }
-      }
-      /* Flip UV */
-      s = GST_VIDEO_FRAME_PLANE_DATA (src, 1);
-      d = GST_VIDEO_FRAME_PLANE_DATA (dest, 1);
-      for (y = 0; y < dest_uv_height; y++) {
-        for (x = 0; x < dest_uv_width; x++) {
-          d_off = y * dest_uv_stride + x * 2;
-          s_off = x * src_uv_stride + (src_uv_width - 1 - y) * 2;
-          d[d_off] = s[s_off];
-          d[d_off + 1] = s[s_off + 1];
-        }
-      }
+    case GST_VIDEO_ORIENTATION_UL_LR:
+    case GST_VIDEO_ORIENTATION_UR_LL:
+      gst_video_flip_transpose (videoflip, dest, src);
       break;
     case GST_VIDEO_ORIENTATION_180:
       /* Flip Y */
@@ -589,50 +620,6 @@ gst_video_flip_semi_planar_yuv (GstVideoFlip * videoflip, GstVideoFrame * dest,
         }
       }
       break;
-    case GST_VIDEO_ORIENTATION_UL_LR:
-      /* Flip Y */
-      s = GST_VIDEO_FRAME_PLANE_DATA (src, 0);
-      d = GST_VIDEO_FRAME_PLANE_DATA (dest, 0);
-      for (y = 0; y < dest_y_height; y++) {
-        for (x = 0; x < dest_y_width; x++) {
-          d[y * dest_y_stride + x] = s[x * src_y_stride + y];
-        }
-      }
-      /* Flip UV */
-      s = GST_VIDEO_FRAME_PLANE_DATA (src, 1);
-      d = GST_VIDEO_FRAME_PLANE_DATA (dest, 1);
-      for (y = 0; y < dest_uv_height; y++) {
-        for (x = 0; x < dest_uv_width; x++) {
-          d_off = y * dest_uv_stride + x * 2;
-          s_off = x * src_uv_stride + y * 2;
-          d[d_off] = s[s_off];
-          d[d_off + 1] = s[s_off + 1];
-        }
-      }
-      break;
-    case GST_VIDEO_ORIENTATION_UR_LL:
-      /* Flip Y */
-      s = GST_VIDEO_FRAME_PLANE_DATA (src, 0);
-      d = GST_VIDEO_FRAME_PLANE_DATA (dest, 0);
-      for (y = 0; y < dest_y_height; y++) {
-        for (x = 0; x < dest_y_width; x++) {
-          d[y * dest_y_stride + x] =
-              s[(src_y_height - 1 - x) * src_y_stride + (src_y_width - 1 - y)];
-        }
-      }
-      /* Flip UV */
-      s = GST_VIDEO_FRAME_PLANE_DATA (src, 1);
-      d = GST_VIDEO_FRAME_PLANE_DATA (dest, 1);
-      for (y = 0; y < dest_uv_height; y++) {
-        for (x = 0; x < dest_uv_width; x++) {
-          d_off = y * dest_uv_stride + x * 2;
-          s_off = (src_uv_height - 1 - x) * src_uv_stride + (src_uv_width - 1 -
-              y) * 2;
-          d[d_off] = s[s_off];
-          d[d_off + 1] = s[s_off + 1];
-        }
-      }
-      break;
     case GST_VIDEO_ORIENTATION_IDENTITY:
       g_assert_not_reached ();
       break;
@@ -666,24 +653,10 @@ gst_video_flip_packed_simple (GstVideoFlip * videoflip, GstVideoFrame * dest,
 
   switch (videoflip->active_method) {
     case GST_VIDEO_ORIENTATION_90R:
-      for (y = 0; y < dh; y++) {
-        for (x = 0; x < dw; x++) {
-          for (z = 0; z < bpp; z++) {
-            d[y * dest_stride + x * bpp + z] =
-                s[(sh - 1 - x) * src_stride + y * bpp + z];
-          }
-        }
-      }
-      break;
     case GST_VIDEO_ORIENTATION_90L:
-      for (y = 0; y < dh; y++) {
-        for (x = 0; x < dw; x++) {
-          for (z = 0; z < bpp; z++) {
-            d[y * dest_stride + x * bpp + z] =
-                s[x * src_stride + (sw - 1 - y) * bpp + z];
-          }
-        }
-      }
+    case GST_VIDEO_ORIENTATION_UL_LR:
+    case GST_VIDEO_ORIENTATION_UR_LL:
+      gst_video_flip_transpose (videoflip, dest, src);
       break;
     case GST_VIDEO_ORIENTATION_180:
       for (y = 0; y < dh; y++) {
@@ -715,25 +688,6 @@ gst_video_flip_packed_simple (GstVideoFlip * videoflip, GstVideoFrame * dest,
         }
       }
       break;
-    case GST_VIDEO_ORIENTATION_UL_LR:
-      for (y = 0; y < dh; y++) {
-        for (x = 0; x < dw; x++) {
-          for (z = 0; z < bpp; z++) {
-            d[y * dest_stride + x * bpp + z] = s[x * src_stride + y * bpp + z];
-          }
-        }
-      }
-      break;
-    case GST_VIDEO_ORIENTATION_UR_LL:
-      for (y = 0; y < dh; y++) {
-        for (x = 0; x < dw; x++) {
-          for (z = 0; z < bpp; z++) {
-            d[y * dest_stride + x * bpp + z] =
-                s[(sh - 1 - x) * src_stride + (sw - 1 - y) * bpp + z];
-          }
-        }
-      }
-      break;
     case GST_VIDEO_ORIENTATION_IDENTITY:
       g_assert_not_reached ();
       break;
@@ -1271,6 +1225,11 @@ gst_video_flip_set_property (GObject * object, guint prop_id,
     case PROP_VIDEO_DIRECTION:
       gst_video_flip_set_method (videoflip, g_value_get_enum (value), FALSE);
       break;
+    case PROP_N_THREADS:
+      GST_OBJECT_LOCK (videoflip);
+      videoflip->n_threads = g_value_get_uint (value);
+      GST_OBJECT_UNLOCK (videoflip);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1288,12 +1247,37 @@ gst_video_flip_get_property (GObject * object, guint prop_id, GValue * value,
     case PROP_VIDEO_DIRECTION:
       g_value_set_enum (value, videoflip->method);
       break;
+    case PROP_N_THREADS:
+      GST_OBJECT_LOCK (videoflip);
+      g_value_set_uint (value, videoflip->n_threads);
+      GST_OBJECT_UNLOCK (videoflip);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
   }
 }
 
+static gboolean
+gst_video_flip_stop (GstBaseTransform * trans)
+{
+  GstVideoFlip *videoflip = GST_VIDEO_FLIP (trans);
+
+  gst_video_bands_free_pool (&videoflip->pool);
+
+  return TRUE;
+}
+
+static void
+gst_video_flip_finalize (GObject * object)
+{
+  GstVideoFlip *videoflip = GST_VIDEO_FLIP (object);
+
+  gst_video_bands_free_pool (&videoflip->pool);
+
+  G_OBJECT_CLASS (gst_video_flip_parent_class)->finalize (object);
+}
+
 static void
 gst_video_flip_class_init (GstVideoFlipClass * klass)
 {
@@ -1306,6 +1290,7 @@ gst_video_flip_class_init (GstVideoFlipClass * klass)
 
   gobject_class->set_property = gst_video_flip_set_property;
   gobject_class->get_property = gst_video_flip_get_property;
+  gobject_class->finalize = gst_video_flip_finalize;
 
   g_object_class_install_property (gobject_class, PROP_METHOD,
       g_param_spec_enum ("method", "method",
@@ -1316,6 +1301,20 @@ gst_video_flip_class_init (GstVideoFlipClass * klass)
   g_object_class_override_property (gobject_class, PROP_VIDEO_DIRECTION,
       "video-direction");
 
+  /**
+   * GstVideoFlip:n-threads:
+   *
+   * Maximum number of threads to use for the rotations by 90 degrees and
+   * the diagonal flips. The output is split into horizontal bands that are
+   * transposed in parallel. 0 uses one thread per CPU.
+   *
+   * Since: 1.18
+   */
+  g_object_class_install_property (gobject_class, PROP_N_THREADS,
+      g_param_spec_uint ("n-threads", "Threads",
+          "Maximum number of threads to use", 0, G_MAXUINT,
+          DEFAULT_N_THREADS, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gst_element_class_set_static_metadata (gstelement_class, "Video flipper",
       "Filter/Effect/Video",
       "Flips and rotates video", "David Schleef <ds@schleef.org>");
@@ -1331,6 +1330,7 @@ gst_video_flip_class_init (GstVideoFlipClass * klass)
       GST_DEBUG_FUNCPTR (gst_video_flip_before_transform);
   trans_class->src_event = GST_DEBUG_FUNCPTR (gst_video_flip_src_event);
   trans_class->sink_event = GST_DEBUG_FUNCPTR (gst_video_flip_sink_event);
+  trans_class->stop = GST_DEBUG_FUNCPTR (gst_video_flip_stop);
 
   vfilter_class->set_info = GST_DEBUG_FUNCPTR (gst_video_flip_set_info);
   vfilter_class->transform_frame =
@@ -1345,4 +1345,5 @@ gst_video_flip_init (GstVideoFlip * videoflip)
   /* AUTO is not valid for active method, this is just to ensure we setup the
    * method in gst_video_flip_set_method() */
   videoflip->active_method = GST_VIDEO_ORIENTATION_AUTO;
+  videoflip->n_threads = DEFAULT_N_THREADS;
 }
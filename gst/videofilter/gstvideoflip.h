@@ -79,6 +79,9 @@ struct _GstVideoFlip {
   GstVideoOrientationMethod tag_method;
   GstVideoOrientationMethod active_method;
   void (*process) (GstVideoFlip *videoflip, GstVideoFrame *dest, const GstVideoFrame *src);
+
+  guint n_threads;
+  GThreadPool *pool;
 };
 
 struct _GstVideoFlipClass {
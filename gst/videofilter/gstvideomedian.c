@@ -22,6 +22,8 @@
 #endif
 #include <string.h>
 #include "gstvideomedian.h"
+#include "gstvideobands.h"
+#include "gstvideomedianorc.h"
 
 static GstStaticPadTemplate video_median_src_factory =
 GST_STATIC_PAD_TEMPLATE ("src",
@@ -47,11 +49,15 @@ enum
 
 #define DEFAULT_FILTERSIZE   5
 #define DEFAULT_LUM_ONLY     TRUE
+#define DEFAULT_RADIUS       0
+#define DEFAULT_N_THREADS    1
 enum
 {
   PROP_0,
   PROP_FILTERSIZE,
-  PROP_LUM_ONLY
+  PROP_LUM_ONLY,
+  PROP_RADIUS,
+  PROP_N_THREADS
 };
 
 #define GST_TYPE_VIDEO_MEDIAN_SIZE (gst_video_median_size_get_type())
@@ -80,6 +86,8 @@ G_DEFINE_TYPE (GstVideoMedian, gst_video_median, GST_TYPE_VIDEO_FILTER);
 static GstFlowReturn gst_video_median_transform_frame (GstVideoFilter * filter,
     GstVideoFrame * in_frame, GstVideoFrame * out_frame);
 
+static gboolean gst_video_median_stop (GstBaseTransform * trans);
+static void gst_video_median_finalize (GObject * object);
 static void gst_video_median_set_property (GObject * object, guint prop_id,
     const GValue * value, GParamSpec * pspec);
 static void gst_video_median_get_property (GObject * object, guint prop_id,
@@ -90,14 +98,17 @@ gst_video_median_class_init (GstVideoMedianClass * klass)
 {
   GObjectClass *gobject_class;
   GstElementClass *gstelement_class;
+  GstBaseTransformClass *trans_class;
   GstVideoFilterClass *vfilter_class;
 
   gobject_class = (GObjectClass *) klass;
   gstelement_class = (GstElementClass *) klass;
+  trans_class = (GstBaseTransformClass *) klass;
   vfilter_class = (GstVideoFilterClass *) klass;
 
   gobject_class->set_property = gst_video_median_set_property;
   gobject_class->get_property = gst_video_median_get_property;
+  gobject_class->finalize = gst_video_median_finalize;
 
   g_object_class_install_property (G_OBJECT_CLASS (klass), PROP_FILTERSIZE,
       g_param_spec_enum ("filtersize", "Filtersize", "The size of the filter",
@@ -109,6 +120,35 @@ gst_video_median_class_init (GstVideoMedianClass * klass)
           "luminance", DEFAULT_LUM_ONLY,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstVideoMedian:radius:
+   *
+   * Radius of the square window to take the median over, for windows
+   * larger than the fixed filter sizes. The window is 2 * radius + 1 pixels
+   * wide and high, and the cost per pixel does not depend on its size.
+   * Pixels outside the image are taken from the nearest edge. 0 uses
+   * #GstVideoMedian:filtersize instead.
+   *
+   * Since: 1.18
+   */
+  g_object_class_install_property (G_OBJECT_CLASS (klass), PROP_RADIUS,
+      g_param_spec_uint ("radius", "Radius", "Radius of the square window "
+          "of the median, 0 uses filtersize", 0, 127, DEFAULT_RADIUS,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstVideoMedian:n-threads:
+   *
+   * Maximum number of threads to use. Frames are split into horizontal
+   * bands that are filtered in parallel. 0 uses one thread per CPU.
+   *
+   * Since: 1.18
+   */
+  g_object_class_install_property (G_OBJECT_CLASS (klass), PROP_N_THREADS,
+      g_param_spec_uint ("n-threads", "Threads",
+          "Maximum number of threads to use", 0, G_MAXUINT,
+          DEFAULT_N_THREADS, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gst_element_class_add_static_pad_template (gstelement_class,
       &video_median_sink_factory);
   gst_element_class_add_static_pad_template (gstelement_class,
@@ -117,6 +157,8 @@ gst_video_median_class_init (GstVideoMedianClass * klass)
       "Filter/Effect/Video", "Apply a median filter to an image",
       "Wim Taymans <wim.taymans@gmail.com>");
 
+  trans_class->stop = GST_DEBUG_FUNCPTR (gst_video_median_stop);
+
   vfilter_class->transform_frame =
       GST_DEBUG_FUNCPTR (gst_video_median_transform_frame);
 
@@ -128,99 +170,279 @@ gst_video_median_init (GstVideoMedian * median)
 {
   median->filtersize = DEFAULT_FILTERSIZE;
   median->lum_only = DEFAULT_LUM_ONLY;
+  median->radius = DEFAULT_RADIUS;
+  median->n_threads = DEFAULT_N_THREADS;
+}
+
+static void
+gst_video_median_free_resources (GstVideoMedian * median)
+{
+  gst_video_bands_free_pool (&median->pool);
+  g_free (median->histograms);
+  median->histograms = NULL;
+  median->histograms_size = 0;
+  g_free (median->lines);
+  median->lines = NULL;
+  median->lines_size = 0;
+}
+
+static gboolean
+gst_video_median_stop (GstBaseTransform * trans)
+{
+  gst_video_median_free_resources (GST_VIDEO_MEDIAN (trans));
+
+  return TRUE;
+}
+
+static void
+gst_video_median_finalize (GObject * object)
+{
+  gst_video_median_free_resources (GST_VIDEO_MEDIAN (object));
+
+  G_OBJECT_CLASS (parent_class)->finalize (object);
 }
 
-#define PIX_SORT(a,b) { if ((a)>(b)) PIX_SWAP((a),(b)); }
-#define PIX_SWAP(a,b) { unsigned char temp=(a);(a)=(b);(b)=temp; }
+/* Minimum number of lines per thread */
+#define MIN_BAND_HEIGHT 16
 
 static void
 median_5 (guint8 * dest, gint dstride, const guint8 * src, gint sstride,
-    gint width, gint height)
+    gint width, gint height, gint y0, gint y1)
 {
-  unsigned char p[5];
-  int i, j, k;
+  gint y;
 
-  /* copy the top and bottom rows into the result array */
-  for (i = 0; i < width; i++) {
-    dest[i] = src[i];
-    dest[(height - 1) * dstride + i] = src[(height - 1) * sstride + i];
-  }
+  for (y = y0; y < y1; y++) {
+    guint8 *d = dest + y * dstride;
+    const guint8 *s = src + y * sstride;
 
-  /* process the interior pixels */
-  for (k = 2; k < height; k++) {
-    dest += dstride;
-    src += sstride;
-
-    dest[0] = src[0];
-    for (j = 2, i = 1; j < width; j++, i++) {
-      p[0] = src[i - sstride];
-      p[1] = src[i - 1];
-      p[2] = src[i];
-      p[3] = src[i + 1];
-      p[4] = src[i + sstride];
-      PIX_SORT (p[0], p[1]);
-      PIX_SORT (p[3], p[4]);
-      PIX_SORT (p[0], p[3]);
-      PIX_SORT (p[1], p[4]);
-      PIX_SORT (p[1], p[2]);
-      PIX_SORT (p[2], p[3]);
-      PIX_SORT (p[1], p[2]);
-      dest[i] = p[2];
+    /* copy the top and bottom rows into the result array */
+    if (y == 0 || y == height - 1 || width < 3) {
+      memcpy (d, s, width);
+      continue;
     }
-    dest[i] = src[i];
+
+    /* process the interior pixels */
+    d[0] = s[0];
+    video_median_orc_median_5 (d + 1, s - sstride + 1, s, s + 1, s + 2,
+        s + sstride + 1, width - 2);
+    d[width - 1] = s[width - 1];
   }
 }
 
+/* The median of 9 is the median of the largest of the row minimums, the
+ * median of the row medians and the smallest of the row maximums. Every
+ * line is sorted horizontally once and kept while it is used for the three
+ * output lines around it, in @lines which holds at least 11 * (width - 2)
+ * bytes. */
 static void
 median_9 (guint8 * dest, gint dstride, const guint8 * src, gint sstride,
-    gint width, gint height)
+    gint width, gint height, gint y0, gint y1, guint8 * lines)
 {
-  unsigned char p[9];
-  int i, j, k;
+  guint8 *lo[3], *mid[3], *hi[3], *max_lo, *min_hi;
+  gint n = width - 2;
+  gint y, i;
+
+  /* copy the top and bottom rows into the result array */
+  for (y = y0; y < y1; y++) {
+    if (y == 0 || y == height - 1 || n < 1)
+      memcpy (dest + y * dstride, src + y * sstride, width);
+  }
+
+  y0 = MAX (y0, 1);
+  y1 = MIN (y1, height - 1);
+  if (y0 >= y1 || n < 1)
+    return;
 
-  /*copy the top and bottom rows into the result array */
-  for (i = 0; i < width; i++) {
-    dest[i] = src[i];
-    dest[(height - 1) * dstride + i] = src[(height - 1) * sstride + i];
+  for (i = 0; i < 3; i++) {
+    lo[i] = lines + 3 * i * n;
+    mid[i] = lo[i] + n;
+    hi[i] = mid[i] + n;
   }
+  max_lo = lines + 9 * n;
+  min_hi = lines + 10 * n;
+
+#define SORT_LINE(l) G_STMT_START {                             \
+  const guint8 *s = src + (l) * sstride;                        \
+  video_median_orc_sort_3 (lo[(l) % 3], mid[(l) % 3], hi[(l) % 3], \
+      s, s + 1, s + 2, n);                                      \
+} G_STMT_END
+
+  SORT_LINE (y0 - 1);
+  SORT_LINE (y0);
+
   /* process the interior pixels */
-  for (k = 2; k < height; k++) {
-    dest += dstride;
-    src += sstride;
-
-    dest[0] = src[0];
-    for (j = 2, i = 1; j < width; j++, i++) {
-      p[0] = src[i - sstride - 1];
-      p[1] = src[i - sstride];
-      p[2] = src[i - sstride + 1];
-      p[3] = src[i - 1];
-      p[4] = src[i];
-      p[5] = src[i + 1];
-      p[6] = src[i + sstride - 1];
-      p[7] = src[i + sstride];
-      p[8] = src[i + sstride + 1];
-      PIX_SORT (p[1], p[2]);
-      PIX_SORT (p[4], p[5]);
-      PIX_SORT (p[7], p[8]);
-      PIX_SORT (p[0], p[1]);
-      PIX_SORT (p[3], p[4]);
-      PIX_SORT (p[6], p[7]);
-      PIX_SORT (p[1], p[2]);
-      PIX_SORT (p[4], p[5]);
-      PIX_SORT (p[7], p[8]);
-      PIX_SORT (p[0], p[3]);
-      PIX_SORT (p[5], p[8]);
-      PIX_SORT (p[4], p[7]);
-      PIX_SORT (p[3], p[6]);
-      PIX_SORT (p[1], p[4]);
-      PIX_SORT (p[2], p[5]);
-      PIX_SORT (p[4], p[7]);
-      PIX_SORT (p[4], p[2]);
-      PIX_SORT (p[6], p[4]);
-      PIX_SORT (p[4], p[2]);
-      dest[i] = p[4];
+  for (y = y0; y < y1; y++) {
+    gint a = (y - 1) % 3, b = y % 3, c = (y + 1) % 3;
+    guint8 *d = dest + y * dstride;
+    const guint8 *s = src + y * sstride;
+
+    SORT_LINE (y + 1);
+
+    video_median_orc_bounds_3 (max_lo, min_hi, lo[a], lo[b], lo[c], hi[a],
+        hi[b], hi[c], n);
+
+    d[0] = s[0];
+    video_median_orc_median_9 (d + 1, mid[a], mid[b], mid[c], max_lo, min_hi,
+        n);
+    d[width - 1] = s[width - 1];
+  }
+
+#undef SORT_LINE
+}
+
+/* Constant time median over a square window of 2 * radius + 1 pixels, with
+ * the edge pixels repeated outside the image (Perreault and Hebert, "Median
+ * Filtering in Constant Time"). A 256 bin histogram is kept for every
+ * column and moved down one line per output line. The histogram of the
+ * window is moved along the line by adding and removing one column, first
+ * only for its 16 coarse bins. The fine bins are only brought up to date
+ * for the coarse bin that holds the median.
+ *
+ * @histograms holds width * (256 + 16) counters that must be zero, and are
+ * zero again on return. */
+static void
+median_histogram (guint8 * dest, gint dstride, const guint8 * src,
+    gint sstride, gint width, gint height, gint radius, gint y0, gint y1,
+    guint16 * histograms)
+{
+  gint size = 2 * radius + 1;
+  gint rank = size * size / 2;
+  guint16 *col_fine = histograms;
+  guint16 *col_coarse = histograms + width * 256;
+  guint16 coarse[16], fine[16][16];
+  gint fine_x[16];
+  gint x, y, k, b, j;
+
+#define COL(x) CLAMP ((x), 0, width - 1)
+
+  /* Column histograms of the lines around the first output line */
+  for (k = -radius; k <= radius; k++) {
+    const guint8 *s = src + CLAMP (y0 + k, 0, height - 1) * sstride;
+
+    for (x = 0; x < width; x++) {
+      col_fine[x * 256 + s[x]]++;
+      col_coarse[x * 16 + (s[x] >> 4)]++;
+    }
+  }
+
+  for (y = y0; y < y1; y++) {
+    guint8 *d = dest + y * dstride;
+
+    if (y > y0) {
+      const guint8 *rem = src + CLAMP (y - radius - 1, 0, height - 1) * sstride;
+      const guint8 *add = src + CLAMP (y + radius, 0, height - 1) * sstride;
+
+      for (x = 0; x < width; x++) {
+        col_fine[x * 256 + rem[x]]--;
+        col_coarse[x * 16 + (rem[x] >> 4)]--;
+        col_fine[x * 256 + add[x]]++;
+        col_coarse[x * 16 + (add[x] >> 4)]++;
+      }
+    }
+
+    memset (coarse, 0, sizeof (coarse));
+    for (k = -radius; k <= radius; k++) {
+      const guint16 *c = col_coarse + COL (k) * 16;
+
+      for (b = 0; b < 16; b++)
+        coarse[b] += c[b];
+    }
+    /* Far enough in the past to make the first use rebuild them */
+    for (b = 0; b < 16; b++)
+      fine_x[b] = -size - 1;
+
+    for (x = 0; x < width; x++) {
+      gint sum = 0;
+
+      if (x > 0) {
+        const guint16 *add = col_coarse + COL (x + radius) * 16;
+        const guint16 *rem = col_coarse + COL (x - radius - 1) * 16;
+
+        for (b = 0; b < 16; b++)
+          coarse[b] += add[b] - rem[b];
+      }
+
+      for (b = 0; sum + coarse[b] <= rank; b++)
+        sum += coarse[b];
+
+      if (x - fine_x[b] > size) {
+        memset (fine[b], 0, sizeof (fine[b]));
+        for (k = -radius; k <= radius; k++) {
+          const guint16 *f = col_fine + COL (x + k) * 256 + b * 16;
+
+          for (j = 0; j < 16; j++)
+            fine[b][j] += f[j];
+        }
+      } else {
+        for (k = fine_x[b] + 1; k <= x; k++) {
+          const guint16 *add = col_fine + COL (k + radius) * 256 + b * 16;
+          const guint16 *rem = col_fine + COL (k - radius - 1) * 256 + b * 16;
+
+          for (j = 0; j < 16; j++)
+            fine[b][j] += add[j] - rem[j];
+        }
+      }
+      fine_x[b] = x;
+
+      for (j = 0; sum + fine[b][j] <= rank; j++)
+        sum += fine[b][j];
+
+      d[x] = b * 16 + j;
+    }
+  }
+
+  /* Remove the lines of the last window, which is cheaper than clearing
+   * all the bins */
+  y = MAX (y1 - 1, y0);
+  for (k = -radius; k <= radius; k++) {
+    const guint8 *s = src + CLAMP (y + k, 0, height - 1) * sstride;
+
+    for (x = 0; x < width; x++) {
+      col_fine[x * 256 + s[x]]--;
+      col_coarse[x * 16 + (s[x] >> 4)]--;
     }
-    dest[i] = src[i];
+  }
+
+#undef COL
+}
+
+typedef struct
+{
+  GstVideoMedianSize filtersize;
+  gint radius;
+  guint16 *histograms;          /* histograms_stride counters per band */
+  gsize histograms_stride;
+  guint8 *lines;                /* lines_stride bytes per band */
+  gsize lines_stride;
+  guint n_components;
+  const GstVideoFrame *in_frame;
+  GstVideoFrame *out_frame;
+} GstVideoMedianJob;
+
+static void
+gst_video_median_process_band (GstVideoMedianJob * job, guint band,
+    guint n_bands)
+{
+  guint c;
+
+  for (c = 0; c < job->n_components; c++) {
+    guint8 *dest = GST_VIDEO_FRAME_COMP_DATA (job->out_frame, c);
+    gint dstride = GST_VIDEO_FRAME_COMP_STRIDE (job->out_frame, c);
+    const guint8 *src = GST_VIDEO_FRAME_COMP_DATA (job->in_frame, c);
+    gint sstride = GST_VIDEO_FRAME_COMP_STRIDE (job->in_frame, c);
+    gint width = GST_VIDEO_FRAME_COMP_WIDTH (job->in_frame, c);
+    gint height = GST_VIDEO_FRAME_COMP_HEIGHT (job->in_frame, c);
+    gint y0 = height * band / n_bands;
+    gint y1 = height * (band + 1) / n_bands;
+
+    if (job->radius > 0)
+      median_histogram (dest, dstride, src, sstride, width, height,
+          job->radius, y0, y1, job->histograms + band * job->histograms_stride);
+    else if (job->filtersize == GST_VIDEO_MEDIAN_SIZE_5)
+      median_5 (dest, dstride, src, sstride, width, height, y0, y1);
+    else
+      median_9 (dest, dstride, src, sstride, width, height, y0, y1,
+          job->lines + band * job->lines_stride);
   }
 }
 
@@ -229,57 +451,63 @@ gst_video_median_transform_frame (GstVideoFilter * filter,
     GstVideoFrame * in_frame, GstVideoFrame * out_frame)
 {
   GstVideoMedian *median = GST_VIDEO_MEDIAN (filter);
+  GstVideoMedianJob job;
+  gboolean lum_only;
+  guint n_threads, n_bands;
+
+  GST_OBJECT_LOCK (median);
+  job.filtersize = median->filtersize;
+  job.radius = median->radius;
+  lum_only = median->lum_only;
+  n_threads = median->n_threads;
+  GST_OBJECT_UNLOCK (median);
+
+  if (lum_only) {
+    gst_video_frame_copy_plane (out_frame, in_frame, 1);
+    gst_video_frame_copy_plane (out_frame, in_frame, 2);
+  }
 
-  if (median->filtersize == 5) {
-    median_5 (GST_VIDEO_FRAME_PLANE_DATA (out_frame, 0),
-        GST_VIDEO_FRAME_PLANE_STRIDE (out_frame, 0),
-        GST_VIDEO_FRAME_PLANE_DATA (in_frame, 0),
-        GST_VIDEO_FRAME_PLANE_STRIDE (in_frame, 0),
-        GST_VIDEO_FRAME_WIDTH (in_frame), GST_VIDEO_FRAME_HEIGHT (in_frame));
-
-    if (median->lum_only) {
-      gst_video_frame_copy_plane (out_frame, in_frame, 1);
-      gst_video_frame_copy_plane (out_frame, in_frame, 2);
-    } else {
-      median_5 (GST_VIDEO_FRAME_PLANE_DATA (out_frame, 1),
-          GST_VIDEO_FRAME_PLANE_STRIDE (out_frame, 1),
-          GST_VIDEO_FRAME_PLANE_DATA (in_frame, 1),
-          GST_VIDEO_FRAME_PLANE_STRIDE (in_frame, 1),
-          GST_VIDEO_FRAME_WIDTH (in_frame) / 2,
-          GST_VIDEO_FRAME_HEIGHT (in_frame) / 2);
-      median_5 (GST_VIDEO_FRAME_PLANE_DATA (out_frame, 2),
-          GST_VIDEO_FRAME_PLANE_STRIDE (out_frame, 2),
-          GST_VIDEO_FRAME_PLANE_DATA (in_frame, 2),
-          GST_VIDEO_FRAME_PLANE_STRIDE (in_frame, 2),
-          GST_VIDEO_FRAME_WIDTH (in_frame) / 2,
-          GST_VIDEO_FRAME_HEIGHT (in_frame) / 2);
+  job.n_components = lum_only ? 1 : 3;
+  job.in_frame = in_frame;
+  job.out_frame = out_frame;
+
+  n_bands = gst_video_bands_get_count (n_threads,
+      GST_VIDEO_FRAME_HEIGHT (in_frame), MIN_BAND_HEIGHT);
+
+  /* The per band buffers are only reallocated when the frame gets wider or
+   * more bands are used, the first component being the widest */
+  job.histograms = NULL;
+  job.histograms_stride = 0;
+  job.lines = NULL;
+  job.lines_stride = 0;
+  if (job.radius > 0) {
+    gsize size;
+
+    job.histograms_stride = (gsize) GST_VIDEO_FRAME_WIDTH (in_frame) *
+        (256 + 16);
+    size = job.histograms_stride * n_bands;
+    if (size > median->histograms_size) {
+      g_free (median->histograms);
+      median->histograms = g_new0 (guint16, size);
+      median->histograms_size = size;
     }
-  } else {
-    median_9 (GST_VIDEO_FRAME_PLANE_DATA (out_frame, 0),
-        GST_VIDEO_FRAME_PLANE_STRIDE (out_frame, 0),
-        GST_VIDEO_FRAME_PLANE_DATA (in_frame, 0),
-        GST_VIDEO_FRAME_PLANE_STRIDE (in_frame, 0),
-        GST_VIDEO_FRAME_WIDTH (in_frame), GST_VIDEO_FRAME_HEIGHT (in_frame));
-
-    if (median->lum_only) {
-      gst_video_frame_copy_plane (out_frame, in_frame, 1);
-      gst_video_frame_copy_plane (out_frame, in_frame, 2);
-    } else {
-      median_9 (GST_VIDEO_FRAME_PLANE_DATA (out_frame, 1),
-          GST_VIDEO_FRAME_PLANE_STRIDE (out_frame, 1),
-          GST_VIDEO_FRAME_PLANE_DATA (in_frame, 1),
-          GST_VIDEO_FRAME_PLANE_STRIDE (in_frame, 1),
-          GST_VIDEO_FRAME_WIDTH (in_frame) / 2,
-          GST_VIDEO_FRAME_HEIGHT (in_frame) / 2);
-      median_9 (GST_VIDEO_FRAME_PLANE_DATA (out_frame, 2),
-          GST_VIDEO_FRAME_PLANE_STRIDE (out_frame, 2),
-          GST_VIDEO_FRAME_PLANE_DATA (in_frame, 2),
-          GST_VIDEO_FRAME_PLANE_STRIDE (in_frame, 2),
-          GST_VIDEO_FRAME_WIDTH (in_frame) / 2,
-          GST_VIDEO_FRAME_HEIGHT (in_frame) / 2);
+    job.histograms = median->histograms;
+  } else if (job.filtersize == GST_VIDEO_MEDIAN_SIZE_9) {
+    gsize size;
+
+    job.lines_stride = (gsize) 11 * GST_VIDEO_FRAME_WIDTH (in_frame);
+    size = job.lines_stride * n_bands;
+    if (size > median->lines_size) {
+      g_free (median->lines);
+      median->lines = g_malloc (size);
+      median->lines_size = size;
     }
+    job.lines = median->lines;
   }
 
+  gst_video_bands_run (&median->pool, n_bands,
+      (GstVideoBandFunc) gst_video_median_process_band, &job);
+
   return GST_FLOW_OK;
 }
 
@@ -291,6 +519,7 @@ gst_video_median_set_property (GObject * object, guint prop_id,
 
   median = GST_VIDEO_MEDIAN (object);
 
+  GST_OBJECT_LOCK (median);
   switch (prop_id) {
     case PROP_FILTERSIZE:
       median->filtersize = g_value_get_enum (value);
@@ -298,9 +527,16 @@ gst_video_median_set_property (GObject * object, guint prop_id,
     case PROP_LUM_ONLY:
       median->lum_only = g_value_get_boolean (value);
       break;
+    case PROP_RADIUS:
+      median->radius = g_value_get_uint (value);
+      break;
+    case PROP_N_THREADS:
+      median->n_threads = g_value_get_uint (value);
+      break;
     default:
       break;
   }
+  GST_OBJECT_UNLOCK (median);
 }
 
 static void
@@ -311,6 +547,7 @@ gst_video_median_get_property (GObject * object, guint prop_id, GValue * value,
 
   median = GST_VIDEO_MEDIAN (object);
 
+  GST_OBJECT_LOCK (median);
   switch (prop_id) {
     case PROP_FILTERSIZE:
       g_value_set_enum (value, median->filtersize);
@@ -318,8 +555,15 @@ gst_video_median_get_property (GObject * object, guint prop_id, GValue * value,
     case PROP_LUM_ONLY:
       g_value_set_boolean (value, median->lum_only);
       break;
+    case PROP_RADIUS:
+      g_value_set_uint (value, median->radius);
+      break;
+    case PROP_N_THREADS:
+      g_value_set_uint (value, median->n_threads);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
   }
+  GST_OBJECT_UNLOCK (median);
 }
@@ -53,6 +53,19 @@ struct _GstVideoMedian {
 
   GstVideoMedianSize filtersize;
   gboolean lum_only;
+  guint radius;
+  guint n_threads;
+
+  GThreadPool *pool;
+
+  /* Column histograms for each band of the radius filter, kept zeroed
+   * between frames */
+  guint16 *histograms;
+  gsize histograms_size;
+
+  /* Sorted lines for each band of the 9 pixel median */
+  guint8 *lines;
+  gsize lines_size;
 };
 
 struct _GstVideoMedianClass {
@@ -38,6 +38,10 @@
 GST_DEBUG_CATEGORY_STATIC (gst_videomixer_blend_debug);
 #define GST_CAT_DEFAULT gst_videomixer_blend_debug
 
+/* The checker pattern only depends on bit 3 of the line number, so only
+ * lines 0 and 8 are drawn pixel by pixel and all others are copied */
+#define CHECKER_DRAW_LINE(i) ((i) == 0 || (i) == 8)
+
 /* Below are the implementations of everything */
 
 /* A32 is for AYUV, ARGB and BGRA */
@@ -128,32 +132,25 @@ fill_checker_##name##_c (GstVideoFrame * frame) \
   gint val; \
   static const gint tab[] = { 80, 160, 80, 160 }; \
   gint width, height; \
-  guint8 *dest; \
+  guint8 *dest, *start; \
   \
-  dest = GST_VIDEO_FRAME_PLANE_DATA (frame, 0); \
+  start = dest = GST_VIDEO_FRAME_PLANE_DATA (frame, 0); \
   width = GST_VIDEO_FRAME_COMP_WIDTH (frame, 0); \
   height = GST_VIDEO_FRAME_COMP_HEIGHT (frame, 0); \
   \
-  if (!RGB) { \
-    for (i = 0; i < height; i++) { \
-      for (j = 0; j < width; j++) { \
-        dest[A] = 0xff; \
-        dest[C1] = tab[((i & 0x8) >> 3) + ((j & 0x8) >> 3)]; \
-        dest[C2] = 128; \
-        dest[C3] = 128; \
-        dest += 4; \
-      } \
+  for (i = 0; i < height; i++) { \
+    if (!CHECKER_DRAW_LINE (i)) { \
+      memcpy (dest, start + (i & 0x8) * width * 4, width * 4); \
+      dest += width * 4; \
+      continue; \
     } \
-  } else { \
-    for (i = 0; i < height; i++) { \
-      for (j = 0; j < width; j++) { \
-        val = tab[((i & 0x8) >> 3) + ((j & 0x8) >> 3)]; \
-        dest[A] = 0xFF; \
-        dest[C1] = val; \
-        dest[C2] = val; \
-        dest[C3] = val; \
-        dest += 4; \
-      } \
+    for (j = 0; j < width; j++) { \
+      val = tab[((i & 0x8) >> 3) + ((j & 0x8) >> 3)]; \
+      dest[A] = 0xff; \
+      dest[C1] = val; \
+      dest[C2] = RGB ? val : 128; \
+      dest[C3] = RGB ? val : 128; \
+      dest += 4; \
     } \
   } \
 }
@@ -346,20 +343,23 @@ fill_checker_##format_name (GstVideoFrame * frame) \
 { \
   gint i, j; \
   static const int tab[] = { 80, 160, 80, 160 }; \
-  guint8 *p; \
+  guint8 *p, *start; \
   gint comp_width, comp_height; \
   gint rowstride; \
   \
-  p = GST_VIDEO_FRAME_COMP_DATA (frame, 0); \
+  start = p = GST_VIDEO_FRAME_COMP_DATA (frame, 0); \
   comp_width = GST_VIDEO_FRAME_COMP_WIDTH (frame, 0); \
   comp_height = GST_VIDEO_FRAME_COMP_HEIGHT (frame, 0); \
   rowstride = GST_VIDEO_FRAME_COMP_STRIDE (frame, 0); \
   \
   for (i = 0; i < comp_height; i++) { \
-    for (j = 0; j < comp_width; j++) { \
-      *p++ = tab[((i & 0x8) >> 3) + ((j & 0x8) >> 3)]; \
+    if (CHECKER_DRAW_LINE (i)) { \
+      for (j = 0; j < comp_width; j++) \
+        p[j] = tab[((i & 0x8) >> 3) + ((j & 0x8) >> 3)]; \
+    } else { \
+      memcpy (p, start + (i & 0x8) * rowstride, comp_width); \
     } \
-    p += rowstride - comp_width; \
+    p += rowstride; \
   } \
   \
   p = GST_VIDEO_FRAME_COMP_DATA (frame, 1); \
@@ -525,10 +525,10 @@ blend_##format_name (GstVideoFrame * srcframe, gint xpos, gint ypos, \
   } \
   \
   /* adjust width/height if the src is bigger than dest */ \
-  if (xpos + src_width > dest_width) { \
+  if (xpos + b_src_width > dest_width) { \
     b_src_width = dest_width - xpos; \
   } \
-  if (ypos + src_height > dest_height) { \
+  if (ypos + b_src_height > dest_height) { \
     b_src_height = dest_height - ypos; \
   } \
   if (b_src_width < 0 || b_src_height < 0) { \
@@ -575,20 +575,23 @@ fill_checker_##format_name (GstVideoFrame * frame) \
 { \
   gint i, j; \
   static const int tab[] = { 80, 160, 80, 160 }; \
-  guint8 *p; \
+  guint8 *p, *start; \
   gint comp_width, comp_height; \
   gint rowstride; \
   \
-  p = GST_VIDEO_FRAME_COMP_DATA (frame, 0); \
+  start = p = GST_VIDEO_FRAME_COMP_DATA (frame, 0); \
   comp_width = GST_VIDEO_FRAME_COMP_WIDTH (frame, 0); \
   comp_height = GST_VIDEO_FRAME_COMP_HEIGHT (frame, 0); \
   rowstride = GST_VIDEO_FRAME_COMP_STRIDE (frame, 0); \
   \
   for (i = 0; i < comp_height; i++) { \
-    for (j = 0; j < comp_width; j++) { \
-      *p++ = tab[((i & 0x8) >> 3) + ((j & 0x8) >> 3)]; \
+    if (CHECKER_DRAW_LINE (i)) { \
+      for (j = 0; j < comp_width; j++) \
+        p[j] = tab[((i & 0x8) >> 3) + ((j & 0x8) >> 3)]; \
+    } else { \
+      memcpy (p, start + (i & 0x8) * rowstride, comp_width); \
     } \
-    p += rowstride - comp_width; \
+    p += rowstride; \
   } \
   \
   p = GST_VIDEO_FRAME_PLANE_DATA (frame, 1); \
@@ -607,10 +610,11 @@ static void \
 fill_color_##format_name (GstVideoFrame * frame, \
     gint colY, gint colU, gint colV) \
 { \
-  guint8 *y, *u, *v; \
+  guint8 *y, *u, *v, *uv; \
+  guint16 val; \
   gint comp_width, comp_height; \
   gint rowstride; \
-  gint i, j; \
+  gint i; \
   \
   y = GST_VIDEO_FRAME_COMP_DATA (frame, 0); \
   comp_width = GST_VIDEO_FRAME_COMP_WIDTH (frame, 0); \
@@ -622,19 +626,20 @@ fill_color_##format_name (GstVideoFrame * frame, \
     y += rowstride; \
   } \
   \
+  uv = GST_VIDEO_FRAME_PLANE_DATA (frame, 1); \
   u = GST_VIDEO_FRAME_COMP_DATA (frame, 1); \
   v = GST_VIDEO_FRAME_COMP_DATA (frame, 2); \
   comp_width = GST_VIDEO_FRAME_COMP_WIDTH (frame, 1); \
   comp_height = GST_VIDEO_FRAME_COMP_HEIGHT (frame, 1); \
   rowstride = GST_VIDEO_FRAME_COMP_STRIDE (frame, 1); \
   \
+  /* Splat the interleaved chroma pair, with U and V in memory order */ \
+  ((guint8 *) &val)[u - uv] = colU; \
+  ((guint8 *) &val)[v - uv] = colV; \
+  \
   for (i = 0; i < comp_height; i++) { \
-    for (j = 0; j < comp_width; j++) { \
-      u[j*2] = colU; \
-      v[j*2] = colV; \
-    } \
-    u += rowstride; \
-    v += rowstride; \
+    video_mixer_orc_splat_u16 ((guint16 *) uv, val, comp_width); \
+    uv += rowstride; \
   } \
 }
 
@@ -719,15 +724,20 @@ fill_checker_##name##_c (GstVideoFrame * frame) \
   gint i, j; \
   static const int tab[] = { 80, 160, 80, 160 }; \
   gint stride, dest_add, width, height; \
-  guint8 *dest; \
+  guint8 *dest, *start; \
   \
   width = GST_VIDEO_FRAME_WIDTH (frame); \
   height = GST_VIDEO_FRAME_HEIGHT (frame); \
-  dest = GST_VIDEO_FRAME_PLANE_DATA (frame, 0); \
+  start = dest = GST_VIDEO_FRAME_PLANE_DATA (frame, 0); \
   stride = GST_VIDEO_FRAME_COMP_STRIDE (frame, 0); \
   dest_add = stride - width * bpp; \
   \
   for (i = 0; i < height; i++) { \
+    if (!CHECKER_DRAW_LINE (i)) { \
+      memcpy (dest, start + (i & 0x8) * stride, width * bpp); \
+      dest += stride; \
+      continue; \
+    } \
     for (j = 0; j < width; j++) { \
       dest[r] = tab[((i & 0x8) >> 3) + ((j & 0x8) >> 3)];       /* red */ \
       dest[g] = tab[((i & 0x8) >> 3) + ((j & 0x8) >> 3)];       /* green */ \
@@ -758,10 +768,13 @@ fill_color_##name (GstVideoFrame * frame, \
   green = YUV_TO_G (colY, colU, colV); \
   blue = YUV_TO_B (colY, colU, colV); \
   \
-  for (i = 0; i < height; i++) { \
-    MEMSET_RGB (dest, red, green, blue, width); \
-    dest += dest_stride; \
-  } \
+  if (height <= 0) \
+    return; \
+  \
+  /* All lines are the same, so only draw the first one */ \
+  MEMSET_RGB (dest, red, green, blue, width); \
+  for (i = 1; i < height; i++) \
+    memcpy (dest + i * dest_stride, dest, width * bpp); \
 }
 
 #define MEMSET_RGB_C(name, r, g, b) \
@@ -887,18 +900,24 @@ fill_checker_##name##_c (GstVideoFrame * frame) \
 { \
   gint i, j; \
   static const int tab[] = { 80, 160, 80, 160 }; \
-  gint dest_add; \
+  gint stride, dest_add; \
   gint width, height; \
-  guint8 *dest; \
+  guint8 *dest, *start; \
   \
   width = GST_VIDEO_FRAME_WIDTH (frame); \
   width = GST_ROUND_UP_2 (width); \
   height = GST_VIDEO_FRAME_HEIGHT (frame); \
-  dest = GST_VIDEO_FRAME_PLANE_DATA (frame, 0); \
-  dest_add = GST_VIDEO_FRAME_COMP_STRIDE (frame, 0) - width * 2; \
+  start = dest = GST_VIDEO_FRAME_PLANE_DATA (frame, 0); \
+  stride = GST_VIDEO_FRAME_COMP_STRIDE (frame, 0); \
+  dest_add = stride - width * 2; \
   width /= 2; \
   \
   for (i = 0; i < height; i++) { \
+    if (!CHECKER_DRAW_LINE (i)) { \
+      memcpy (dest, start + (i & 0x8) * stride, width * 4); \
+      dest += stride; \
+      continue; \
+    } \
     for (j = 0; j < width; j++) { \
       dest[Y1] = tab[((i & 0x8) >> 3) + ((j & 0x8) >> 3)]; \
       dest[Y2] = tab[((i & 0x8) >> 3) + ((j & 0x8) >> 3)]; \
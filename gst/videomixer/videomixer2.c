@@ -765,10 +765,15 @@ gst_videomixer2_pad_init (GstVideoMixer2Pad * mixerpad)
 
 /* GstVideoMixer2 */
 #define DEFAULT_BACKGROUND VIDEO_MIXER2_BACKGROUND_CHECKER
+#define DEFAULT_N_THREADS 1
+#define DEFAULT_REUSE_UNCHANGED FALSE
 enum
 {
   PROP_0,
-  PROP_BACKGROUND
+  PROP_BACKGROUND,
+  PROP_N_THREADS,
+  PROP_REUSE_UNCHANGED,
+  PROP_STATS
 };
 
 #define GST_TYPE_VIDEO_MIXER2_BACKGROUND (gst_videomixer2_background_get_type())
@@ -840,6 +845,8 @@ gst_videomixer2_read_qos (GstVideoMixer2 * mix, gdouble * proportion,
   GST_OBJECT_UNLOCK (mix);
 }
 
+static void gst_videomixer2_clear_previous (GstVideoMixer2 * mix);
+
 static void
 gst_videomixer2_reset (GstVideoMixer2 * mix)
 {
@@ -853,6 +860,7 @@ gst_videomixer2_reset (GstVideoMixer2 * mix)
   mix->segment.position = -1;
 
   gst_videomixer2_reset_qos (mix);
+  gst_videomixer2_clear_previous (mix);
 
   for (l = mix->sinkpads; l; l = l->next) {
     GstVideoMixer2Pad *p = l->data;
@@ -1045,74 +1053,541 @@ gst_videomixer2_fill_queues (GstVideoMixer2 * mix,
   return 1;
 }
 
-static GstFlowReturn
-gst_videomixer2_blend_buffers (GstVideoMixer2 * mix,
-    GstClockTime output_start_time, GstClockTime output_end_time,
-    GstBuffer ** outbuf)
+/* Don't split output frames into stripes of fewer lines than this */
+#define MIN_STRIPE_HEIGHT 16
+/* Height of the stripes whose inputs are checked for changes with
+ * reuse-unchanged */
+#define REUSE_STRIPE_HEIGHT 64
+/* Stripes start at multiples of this many lines. This covers the vertical
+ * chroma subsampling, the position rounding of all supported formats and
+ * the period of the checker background, so filling and blending a stripe
+ * gives exactly the same result as for the same lines of the whole frame */
+#define STRIPE_ALIGN 16
+
+typedef struct
 {
-  GSList *l;
-  guint outsize;
+  GstVideoMixer2Pad *pad;
+  gint xpos, ypos;
+  gint blend_xpos, blend_ypos;  /* position after rounding when blending */
+  gdouble alpha;
+  gint width, height;
+  gboolean opaque;
+  gboolean changed;
+  gboolean needed;              /* blended in at least one stripe */
+
+  GstVideoFrame frame;
+  GstVideoFrame converted_frame;
+  GstBuffer *converted_buf;
+} GstVideoMixer2Input;
+
+typedef struct
+{
+  gboolean dirty;               /* FALSE if copied from the previous frame */
+  gboolean fill;                /* background not fully covered */
+  guint64 pixels_blended;
+  guint64 pixels_filled;
+  guint64 pixels_reused;
+} GstVideoMixer2Stripe;
+
+typedef struct _GstVideoMixer2Job GstVideoMixer2Job;
+
+struct _GstVideoMixer2Job
+{
+  void (*func) (GstVideoMixer2Job * job, guint index);
+  guint n_items;
+  gint next_item;
+
+  GstVideoMixer2 *mix;
+  GstVideoMixer2Input *inputs;
+  guint n_inputs;
+  guint *convert;               /* indices of the inputs to convert */
   BlendFunction composite;
-  GstVideoFrame outframe;
-  static GstAllocationParams params = { 0, 15, 0, 0, };
+  GstVideoMixer2Background background;
+  GstVideoFrame *outframe;
+  GstVideoFrame *prevframe;     /* previous output, NULL if not reusable */
+  GstVideoMixer2Stripe *stripes;
+  gboolean *blend;              /* per stripe and input */
+  guint n_stripes;
+
+  GMutex lock;
+  GCond cond;
+  guint n_pending;
+};
 
-  outsize = GST_VIDEO_INFO_SIZE (&mix->info);
+static void
+gst_videomixer2_job_run_items (GstVideoMixer2Job * job)
+{
+  guint i;
 
-  *outbuf = gst_buffer_new_allocate (NULL, outsize, &params);
-  GST_BUFFER_TIMESTAMP (*outbuf) = output_start_time;
-  GST_BUFFER_DURATION (*outbuf) = output_end_time - output_start_time;
+  while ((i = g_atomic_int_add (&job->next_item, 1)) < job->n_items)
+    job->func (job, i);
+}
 
-  gst_video_frame_map (&outframe, &mix->info, *outbuf, GST_MAP_READWRITE);
+static void
+gst_videomixer2_worker_func (GstVideoMixer2Job * job, gpointer user_data)
+{
+  gst_videomixer2_job_run_items (job);
+
+  g_mutex_lock (&job->lock);
+  if (--job->n_pending == 0)
+    g_cond_signal (&job->cond);
+  g_mutex_unlock (&job->lock);
+}
+
+static guint
+gst_videomixer2_get_n_threads (GstVideoMixer2 * mix)
+{
+  guint n_threads;
+
+  GST_OBJECT_LOCK (mix);
+  n_threads = mix->n_threads;
+  GST_OBJECT_UNLOCK (mix);
+
+  return n_threads == 0 ? g_get_num_processors () : n_threads;
+}
+
+/* Runs job->func for all job->n_items items, spread over the worker pool
+ * and the calling thread. Returns once all items are done */
+static void
+gst_videomixer2_run_job (GstVideoMixer2 * mix, GstVideoMixer2Job * job)
+{
+  guint n_workers, i;
+
+  n_workers = MIN (gst_videomixer2_get_n_threads (mix), job->n_items);
+
+  job->next_item = 0;
+  if (n_workers <= 1) {
+    gst_videomixer2_job_run_items (job);
+    return;
+  }
+
+  if (mix->pool == NULL) {
+    mix->pool = g_thread_pool_new ((GFunc) gst_videomixer2_worker_func,
+        NULL, n_workers - 1, TRUE, NULL);
+  } else if (g_thread_pool_get_max_threads (mix->pool) < (gint) n_workers - 1) {
+    g_thread_pool_set_max_threads (mix->pool, n_workers - 1, NULL);
+  }
+
+  g_mutex_init (&job->lock);
+  g_cond_init (&job->cond);
+  job->n_pending = n_workers - 1;
+  for (i = 1; i < n_workers; i++)
+    g_thread_pool_push (mix->pool, job, NULL);
+
+  gst_videomixer2_job_run_items (job);
+
+  g_mutex_lock (&job->lock);
+  while (job->n_pending > 0)
+    g_cond_wait (&job->cond, &job->lock);
+  g_mutex_unlock (&job->lock);
+
+  g_mutex_clear (&job->lock);
+  g_cond_clear (&job->cond);
+}
+
+static void
+gst_videomixer2_convert_input (GstVideoMixer2Job * job, guint index)
+{
+  GstVideoMixer2Input *input = &job->inputs[job->convert[index]];
+
+  gst_video_converter_frame (input->pad->convert, &input->frame,
+      &input->converted_frame);
+}
+
+static gint
+gst_videomixer2_stripe_start (GstVideoMixer2Job * job, guint stripe)
+{
+  gint height = GST_VIDEO_FRAME_HEIGHT (job->outframe);
+
+  if (stripe >= job->n_stripes)
+    return height;
 
-  /* default to blending */
-  composite = mix->blend;
-  switch (mix->background) {
+  return ((height * stripe / job->n_stripes) / STRIPE_ALIGN) * STRIPE_ALIGN;
+}
+
+/* Makes @view a frame of the lines y0 to y1 of @frame */
+static void
+gst_videomixer2_stripe_view (GstVideoFrame * frame, gint y0, gint y1,
+    GstVideoFrame * view)
+{
+  const GstVideoFormatInfo *finfo = frame->info.finfo;
+  guint i;
+
+  *view = *frame;
+  view->info.height = y1 - y0;
+  for (i = 0; i < GST_VIDEO_FORMAT_INFO_N_COMPONENTS (finfo); i++) {
+    guint plane = GST_VIDEO_FORMAT_INFO_PLANE (finfo, i);
+
+    view->data[plane] = (guint8 *) frame->data[plane] +
+        GST_VIDEO_FORMAT_INFO_SCALE_HEIGHT (finfo, i, y0) *
+        GST_VIDEO_FRAME_PLANE_STRIDE (frame, plane);
+  }
+}
+
+static void
+gst_videomixer2_fill_background (GstVideoMixer2 * mix,
+    GstVideoMixer2Background background, GstVideoFrame * frame)
+{
+  switch (background) {
     case VIDEO_MIXER2_BACKGROUND_CHECKER:
-      mix->fill_checker (&outframe);
+      mix->fill_checker (frame);
       break;
     case VIDEO_MIXER2_BACKGROUND_BLACK:
-      mix->fill_color (&outframe, 16, 128, 128);
+      mix->fill_color (frame, 16, 128, 128);
       break;
     case VIDEO_MIXER2_BACKGROUND_WHITE:
-      mix->fill_color (&outframe, 240, 128, 128);
+      mix->fill_color (frame, 240, 128, 128);
       break;
     case VIDEO_MIXER2_BACKGROUND_TRANSPARENT:
     {
       guint i, plane, num_planes, height;
 
-      num_planes = GST_VIDEO_FRAME_N_PLANES (&outframe);
+      num_planes = GST_VIDEO_FRAME_N_PLANES (frame);
       for (plane = 0; plane < num_planes; ++plane) {
         guint8 *pdata;
         gsize rowsize, plane_stride;
 
-        pdata = GST_VIDEO_FRAME_PLANE_DATA (&outframe, plane);
-        plane_stride = GST_VIDEO_FRAME_PLANE_STRIDE (&outframe, plane);
-        rowsize = GST_VIDEO_FRAME_COMP_WIDTH (&outframe, plane)
-            * GST_VIDEO_FRAME_COMP_PSTRIDE (&outframe, plane);
-        height = GST_VIDEO_FRAME_COMP_HEIGHT (&outframe, plane);
+        pdata = GST_VIDEO_FRAME_PLANE_DATA (frame, plane);
+        plane_stride = GST_VIDEO_FRAME_PLANE_STRIDE (frame, plane);
+        rowsize = GST_VIDEO_FRAME_COMP_WIDTH (frame, plane)
+            * GST_VIDEO_FRAME_COMP_PSTRIDE (frame, plane);
+        height = GST_VIDEO_FRAME_COMP_HEIGHT (frame, plane);
         for (i = 0; i < height; ++i) {
           memset (pdata, 0, rowsize);
           pdata += plane_stride;
         }
       }
-
-      /* use overlay to keep background transparent */
-      composite = mix->overlay;
       break;
     }
   }
+}
+
+static void
+gst_videomixer2_copy_stripe (GstVideoFrame * dest, GstVideoFrame * src)
+{
+  guint plane, i, height;
+
+  for (plane = 0; plane < GST_VIDEO_FRAME_N_PLANES (dest); plane++) {
+    guint8 *d = GST_VIDEO_FRAME_PLANE_DATA (dest, plane);
+    const guint8 *s = GST_VIDEO_FRAME_PLANE_DATA (src, plane);
+    gsize rowsize = GST_VIDEO_FRAME_COMP_WIDTH (dest, plane)
+        * GST_VIDEO_FRAME_COMP_PSTRIDE (dest, plane);
+
+    height = GST_VIDEO_FRAME_COMP_HEIGHT (dest, plane);
+    for (i = 0; i < height; i++) {
+      memcpy (d, s, rowsize);
+      d += GST_VIDEO_FRAME_PLANE_STRIDE (dest, plane);
+      s += GST_VIDEO_FRAME_PLANE_STRIDE (src, plane);
+    }
+  }
+}
+
+/* The blend functions round positions up to a multiple of the chroma
+ * subsampling of the output format */
+static void
+gst_videomixer2_round_position (const GstVideoInfo * info, gint * xpos,
+    gint * ypos)
+{
+  gint xalign = 1 << GST_VIDEO_FORMAT_INFO_W_SUB (info->finfo, 1);
+  gint yalign = 1 << GST_VIDEO_FORMAT_INFO_H_SUB (info->finfo, 1);
+
+  *xpos = (*xpos + xalign - 1) & ~(xalign - 1);
+  *ypos = (*ypos + yalign - 1) & ~(yalign - 1);
+}
+
+/* Whether @input covers every pixel of the given area where it gets
+ * blended */
+static gboolean
+gst_videomixer2_input_covers (GstVideoMixer2Input * input, gint x0, gint y0,
+    gint x1, gint y1)
+{
+  return input->opaque && input->blend_xpos <= x0
+      && input->blend_xpos + input->width >= x1
+      && input->blend_ypos <= y0 && input->blend_ypos + input->height >= y1;
+}
+
+/* Decides for every stripe whether it can be copied from the previous frame,
+ * whether the background has to be filled and which inputs are visible in
+ * it. Inputs that are completely hidden behind an opaque input above them
+ * are skipped, and so is the background below an input covering the whole
+ * stripe */
+static void
+gst_videomixer2_plan_stripes (GstVideoMixer2Job * job, gboolean all_dirty)
+{
+  gint width = GST_VIDEO_FRAME_WIDTH (job->outframe);
+  guint s, i, j;
+
+  for (s = 0; s < job->n_stripes; s++) {
+    GstVideoMixer2Stripe *stripe = &job->stripes[s];
+    gboolean *blend = &job->blend[s * job->n_inputs];
+    gint y0 = gst_videomixer2_stripe_start (job, s);
+    gint y1 = gst_videomixer2_stripe_start (job, s + 1);
+    guint first = 0;
+
+    stripe->dirty = all_dirty;
+    stripe->fill = TRUE;
+    if (y0 >= y1)
+      continue;
+
+    for (i = 0; i < job->n_inputs; i++) {
+      GstVideoMixer2Input *input = &job->inputs[i];
+
+      if (input->changed && input->blend_ypos < y1
+          && input->blend_ypos + input->height > y0)
+        stripe->dirty = TRUE;
+    }
+
+    if (!stripe->dirty) {
+      stripe->pixels_reused = (guint64) width * (y1 - y0);
+      continue;
+    }
+
+    /* Nothing below the topmost input covering the whole stripe shows */
+    for (i = job->n_inputs; i > 0; i--) {
+      if (gst_videomixer2_input_covers (&job->inputs[i - 1], 0, y0, width,
+              y1)) {
+        first = i - 1;
+        stripe->fill = FALSE;
+        break;
+      }
+    }
+    if (stripe->fill)
+      stripe->pixels_filled = (guint64) width * (y1 - y0);
+
+    for (i = first; i < job->n_inputs; i++) {
+      GstVideoMixer2Input *input = &job->inputs[i];
+      gint ix0 = MAX (input->blend_xpos, 0);
+      gint iy0 = MAX (input->blend_ypos, y0);
+      gint ix1 = MIN (input->blend_xpos + input->width, width);
+      gint iy1 = MIN (input->blend_ypos + input->height, y1);
+
+      if (ix0 >= ix1 || iy0 >= iy1)
+        continue;
+
+      for (j = i + 1; j < job->n_inputs; j++) {
+        if (gst_videomixer2_input_covers (&job->inputs[j], ix0, iy0, ix1, iy1))
+          break;
+      }
+      if (j < job->n_inputs)
+        continue;
+
+      blend[i] = TRUE;
+      input->needed = TRUE;
+      stripe->pixels_blended += (guint64) (ix1 - ix0) * (iy1 - iy0);
+    }
+  }
+}
+
+static void
+gst_videomixer2_blend_stripe (GstVideoMixer2Job * job, guint index)
+{
+  GstVideoMixer2Stripe *stripe = &job->stripes[index];
+  gboolean *blend = &job->blend[index * job->n_inputs];
+  gint y0 = gst_videomixer2_stripe_start (job, index);
+  gint y1 = gst_videomixer2_stripe_start (job, index + 1);
+  GstVideoFrame dest;
+  guint i;
+
+  if (y0 >= y1)
+    return;
+
+  gst_videomixer2_stripe_view (job->outframe, y0, y1, &dest);
+
+  if (!stripe->dirty) {
+    GstVideoFrame prev;
+
+    gst_videomixer2_stripe_view (job->prevframe, y0, y1, &prev);
+    gst_videomixer2_copy_stripe (&dest, &prev);
+    return;
+  }
+
+  if (stripe->fill)
+    gst_videomixer2_fill_background (job->mix, job->background, &dest);
+
+  for (i = 0; i < job->n_inputs; i++) {
+    GstVideoMixer2Input *input = &job->inputs[i];
+
+    if (blend[i])
+      job->composite (&input->converted_frame, input->xpos, input->ypos - y0,
+          input->alpha, &dest);
+  }
+}
+
+static gboolean
+gst_videomixer2_same_buffer (GstBuffer * a, GstBuffer * b)
+{
+  guint i, n;
+
+  if (a == b)
+    return TRUE;
+
+  n = gst_buffer_n_memory (a);
+  if (n == 0 || n != gst_buffer_n_memory (b))
+    return FALSE;
+
+  for (i = 0; i < n; i++) {
+    if (gst_buffer_peek_memory (a, i) != gst_buffer_peek_memory (b, i))
+      return FALSE;
+  }
+
+  return TRUE;
+}
+
+static void
+gst_videomixer2_clear_previous_inputs (GstVideoMixer2 * mix)
+{
+  guint i;
+
+  for (i = 0; i < mix->n_prev_inputs; i++)
+    gst_buffer_unref (mix->prev_inputs[i].buffer);
+  g_free (mix->prev_inputs);
+  mix->prev_inputs = NULL;
+  mix->n_prev_inputs = 0;
+}
+
+/* Forgets the previous output frame and its inputs */
+static void
+gst_videomixer2_clear_previous (GstVideoMixer2 * mix)
+{
+  gst_buffer_replace (&mix->prev_outbuf, NULL);
+  gst_videomixer2_clear_previous_inputs (mix);
+}
+
+/* Marks the inputs that changed since the previous output frame. Returns
+ * FALSE if the previous frame can't be reused at all */
+static gboolean
+gst_videomixer2_find_changes (GstVideoMixer2 * mix,
+    GstVideoMixer2Background background, GstVideoMixer2Input * inputs,
+    guint n_inputs)
+{
+  guint i;
+
+  if (!mix->prev_outbuf || mix->prev_background != background
+      || !gst_video_info_is_equal (&mix->prev_info, &mix->info)
+      || mix->n_prev_inputs != n_inputs)
+    return FALSE;
+
+  for (i = 0; i < n_inputs; i++) {
+    GstVideoMixer2PrevInput *prev = &mix->prev_inputs[i];
+    GstVideoMixer2Input *input = &inputs[i];
+
+    /* Moving inputs around uncovers other parts of the frame */
+    if (prev->xpos != input->xpos || prev->ypos != input->ypos
+        || prev->width != input->width || prev->height != input->height
+        || prev->alpha != input->alpha)
+      return FALSE;
+  }
+
+  for (i = 0; i < n_inputs; i++)
+    inputs[i].changed = !gst_videomixer2_same_buffer (mix->prev_inputs[i].buffer,
+        inputs[i].pad->mixcol->buffer);
+
+  return TRUE;
+}
+
+/* Keeps a copy of the output frame of @job for the next frame. The output
+ * buffer itself is pushed downstream and must stay writable there, so only
+ * the stripes that were redrawn are copied into our own buffer */
+static void
+gst_videomixer2_remember_previous (GstVideoMixer2 * mix,
+    GstVideoMixer2Background background, GstVideoMixer2Job * job)
+{
+  GstVideoMixer2Input *inputs = job->inputs;
+  guint n_inputs = job->n_inputs;
+  GstVideoFrame prevframe;
+  gboolean copy_all = FALSE;
+  guint i;
+
+  gst_videomixer2_clear_previous_inputs (mix);
+
+  if (!mix->prev_outbuf || !gst_video_info_is_equal (&mix->prev_info,
+          &mix->info)) {
+    gst_buffer_replace (&mix->prev_outbuf, NULL);
+    mix->prev_outbuf =
+        gst_buffer_new_allocate (NULL, GST_VIDEO_INFO_SIZE (&mix->info), NULL);
+    copy_all = TRUE;
+  }
+
+  gst_video_frame_map (&prevframe, &mix->info, mix->prev_outbuf,
+      GST_MAP_WRITE);
+  for (i = 0; i < job->n_stripes; i++) {
+    gint y0 = gst_videomixer2_stripe_start (job, i);
+    gint y1 = gst_videomixer2_stripe_start (job, i + 1);
+    GstVideoFrame dest, src;
+
+    if (y0 >= y1 || (!copy_all && !job->stripes[i].dirty))
+      continue;
+
+    gst_videomixer2_stripe_view (&prevframe, y0, y1, &dest);
+    gst_videomixer2_stripe_view (job->outframe, y0, y1, &src);
+    gst_videomixer2_copy_stripe (&dest, &src);
+  }
+  gst_video_frame_unmap (&prevframe);
+
+  mix->prev_info = mix->info;
+  mix->prev_background = background;
+  mix->prev_inputs = g_new (GstVideoMixer2PrevInput, n_inputs);
+  mix->n_prev_inputs = n_inputs;
+  for (i = 0; i < n_inputs; i++) {
+    GstVideoMixer2PrevInput *prev = &mix->prev_inputs[i];
+
+    prev->buffer = gst_buffer_ref (inputs[i].pad->mixcol->buffer);
+    prev->xpos = inputs[i].xpos;
+    prev->ypos = inputs[i].ypos;
+    prev->width = inputs[i].width;
+    prev->height = inputs[i].height;
+    prev->alpha = inputs[i].alpha;
+  }
+}
+
+static GstFlowReturn
+gst_videomixer2_blend_buffers (GstVideoMixer2 * mix,
+    GstClockTime output_start_time, GstClockTime output_end_time,
+    GstBuffer ** outbuf)
+{
+  GSList *l;
+  guint outsize;
+  GstVideoFrame outframe, prevframe;
+  GstVideoMixer2Background background;
+  GstVideoMixer2Input *inputs;
+  guint *convert;
+  guint i, n_pads, n_inputs = 0, n_convert = 0, n_hidden = 0;
+  gboolean opaque_format, reuse, all_dirty = TRUE;
+  guint64 pixels_blended = 0, pixels_filled = 0, pixels_reused = 0;
+  GstVideoMixer2Job job = { NULL, };
+  static GstAllocationParams params = { 0, 15, 0, 0, };
+
+  outsize = GST_VIDEO_INFO_SIZE (&mix->info);
 
+  *outbuf = gst_buffer_new_allocate (NULL, outsize, &params);
+  GST_BUFFER_TIMESTAMP (*outbuf) = output_start_time;
+  GST_BUFFER_DURATION (*outbuf) = output_end_time - output_start_time;
+
+  gst_video_frame_map (&outframe, &mix->info, *outbuf, GST_MAP_READWRITE);
+
+  GST_OBJECT_LOCK (mix);
+  reuse = mix->reuse_unchanged;
+  GST_OBJECT_UNLOCK (mix);
+
+  background = mix->background;
+  /* use overlay to keep a transparent background transparent */
+  job.composite = background == VIDEO_MIXER2_BACKGROUND_TRANSPARENT ?
+      mix->overlay : mix->blend;
+  /* Inputs with per-pixel alpha can't hide anything below them */
+  opaque_format = !GST_VIDEO_INFO_HAS_ALPHA (&mix->info);
+
+  n_pads = g_slist_length (mix->sinkpads);
+  inputs = g_new0 (GstVideoMixer2Input, n_pads);
+  convert = g_new (guint, n_pads);
   for (l = mix->sinkpads; l; l = l->next) {
     GstVideoMixer2Pad *pad = l->data;
     GstVideoMixer2Collect *mixcol = pad->mixcol;
 
     if (mixcol->buffer != NULL) {
+      GstVideoMixer2Input *input = &inputs[n_inputs];
       GstClockTime timestamp;
       gint64 stream_time;
       GstSegment *seg;
-      GstVideoFrame converted_frame;
-      GstBuffer *converted_buf = NULL;
-      GstVideoFrame frame;
 
       seg = &mixcol->collect.segment;
 
@@ -1125,41 +1600,149 @@ gst_videomixer2_blend_buffers (GstVideoMixer2 * mix,
       if (GST_CLOCK_TIME_IS_VALID (stream_time))
         gst_object_sync_values (GST_OBJECT (pad), stream_time);
 
-      gst_video_frame_map (&frame, &mixcol->buffer_vinfo, mixcol->buffer,
-          GST_MAP_READ);
-
+      input->pad = pad;
+      input->xpos = pad->xpos;
+      input->ypos = pad->ypos;
+      input->blend_xpos = pad->xpos;
+      input->blend_ypos = pad->ypos;
+      gst_videomixer2_round_position (&mix->info, &input->blend_xpos,
+          &input->blend_ypos);
+      input->alpha = pad->alpha;
       if (pad->convert) {
-        gint converted_size;
-
-        /* We wait until here to set the conversion infos, in case mix->info changed */
-        if (pad->need_conversion_update) {
-          pad->conversion_info = mix->info;
-          gst_video_info_set_format (&(pad->conversion_info),
-              GST_VIDEO_INFO_FORMAT (&mix->info), pad->info.width,
-              pad->info.height);
-          pad->need_conversion_update = FALSE;
-        }
-
-        converted_size = pad->conversion_info.size;
-        converted_size = converted_size > outsize ? converted_size : outsize;
-        converted_buf = gst_buffer_new_allocate (NULL, converted_size, &params);
-
-        gst_video_frame_map (&converted_frame, &(pad->conversion_info),
-            converted_buf, GST_MAP_READWRITE);
-        gst_video_converter_frame (pad->convert, &frame, &converted_frame);
-        gst_video_frame_unmap (&frame);
+        input->width = GST_VIDEO_INFO_WIDTH (&pad->info);
+        input->height = GST_VIDEO_INFO_HEIGHT (&pad->info);
       } else {
-        converted_frame = frame;
+        input->width = GST_VIDEO_INFO_WIDTH (&mixcol->buffer_vinfo);
+        input->height = GST_VIDEO_INFO_HEIGHT (&mixcol->buffer_vinfo);
       }
+      input->opaque = opaque_format && input->alpha == 1.0;
+      input->changed = TRUE;
+
+      n_inputs++;
+    }
+  }
+
+  if (reuse)
+    all_dirty = !gst_videomixer2_find_changes (mix, background, inputs,
+        n_inputs);
+
+  if (!all_dirty) {
+    gst_video_frame_map (&prevframe, &mix->info, mix->prev_outbuf,
+        GST_MAP_READ);
+    job.prevframe = &prevframe;
+  }
+
+  job.mix = mix;
+  job.background = background;
+  job.inputs = inputs;
+  job.n_inputs = n_inputs;
+  job.outframe = &outframe;
+  job.n_stripes = MIN (gst_videomixer2_get_n_threads (mix),
+      GST_VIDEO_FRAME_HEIGHT (&outframe) / MIN_STRIPE_HEIGHT);
+  if (reuse)
+    job.n_stripes = MAX (job.n_stripes,
+        GST_VIDEO_FRAME_HEIGHT (&outframe) / REUSE_STRIPE_HEIGHT);
+  job.n_stripes = MAX (job.n_stripes, 1);
+  job.stripes = g_new0 (GstVideoMixer2Stripe, job.n_stripes);
+  job.blend = g_new0 (gboolean, job.n_stripes * n_inputs);
+
+  gst_videomixer2_plan_stripes (&job, all_dirty);
+
+  /* Only map and convert the inputs that are visible somewhere */
+  for (i = 0; i < n_inputs; i++) {
+    GstVideoMixer2Input *input = &inputs[i];
+    GstVideoMixer2Pad *pad = input->pad;
+
+    if (!input->needed) {
+      if (input->changed)
+        n_hidden++;
+      continue;
+    }
+
+    gst_video_frame_map (&input->frame, &pad->mixcol->buffer_vinfo,
+        pad->mixcol->buffer, GST_MAP_READ);
 
-      composite (&converted_frame, pad->xpos, pad->ypos, pad->alpha, &outframe);
+    if (pad->convert) {
+      gint converted_size;
+
+      /* We wait until here to set the conversion infos, in case mix->info changed */
+      if (pad->need_conversion_update) {
+        pad->conversion_info = mix->info;
+        gst_video_info_set_format (&(pad->conversion_info),
+            GST_VIDEO_INFO_FORMAT (&mix->info), pad->info.width,
+            pad->info.height);
+        pad->need_conversion_update = FALSE;
+      }
 
-      if (pad->convert)
-        gst_buffer_unref (converted_buf);
+      converted_size = pad->conversion_info.size;
+      converted_size = converted_size > outsize ? converted_size : outsize;
+      input->converted_buf =
+          gst_buffer_new_allocate (NULL, converted_size, &params);
 
-      gst_video_frame_unmap (&converted_frame);
+      gst_video_frame_map (&input->converted_frame,
+          &(pad->conversion_info), input->converted_buf, GST_MAP_READWRITE);
+      convert[n_convert++] = i;
+    } else {
+      input->converted_frame = input->frame;
     }
   }
+
+  /* Convert all inputs that need it in parallel, then fill and blend the
+   * output with each thread working on its own horizontal stripes */
+  if (n_convert > 0) {
+    job.func = gst_videomixer2_convert_input;
+    job.n_items = n_convert;
+    job.convert = convert;
+    gst_videomixer2_run_job (mix, &job);
+  }
+
+  for (i = 0; i < n_inputs; i++) {
+    if (inputs[i].converted_buf)
+      gst_video_frame_unmap (&inputs[i].frame);
+  }
+
+  job.func = gst_videomixer2_blend_stripe;
+  job.n_items = job.n_stripes;
+  gst_videomixer2_run_job (mix, &job);
+
+  for (i = 0; i < job.n_stripes; i++) {
+    pixels_blended += job.stripes[i].pixels_blended;
+    pixels_filled += job.stripes[i].pixels_filled;
+    pixels_reused += job.stripes[i].pixels_reused;
+  }
+
+  GST_LOG_OBJECT (mix, "blended %" G_GUINT64_FORMAT " pixels, filled %"
+      G_GUINT64_FORMAT ", reused %" G_GUINT64_FORMAT ", %u of %u inputs "
+      "hidden", pixels_blended, pixels_filled, pixels_reused, n_hidden,
+      n_inputs);
+
+  GST_OBJECT_LOCK (mix);
+  mix->pixels_blended = pixels_blended;
+  mix->pixels_filled = pixels_filled;
+  mix->pixels_reused = pixels_reused;
+  mix->inputs_hidden = n_hidden;
+  GST_OBJECT_UNLOCK (mix);
+
+  if (!all_dirty)
+    gst_video_frame_unmap (&prevframe);
+
+  if (reuse)
+    gst_videomixer2_remember_previous (mix, background, &job);
+  else
+    gst_videomixer2_clear_previous (mix);
+
+  for (i = 0; i < n_inputs; i++) {
+    if (!inputs[i].needed)
+      continue;
+    gst_video_frame_unmap (&inputs[i].converted_frame);
+    if (inputs[i].converted_buf)
+      gst_buffer_unref (inputs[i].converted_buf);
+  }
+  g_free (inputs);
+  g_free (convert);
+  g_free (job.stripes);
+  g_free (job.blend);
+
   gst_video_frame_unmap (&outframe);
 
   return GST_FLOW_OK;
@@ -2086,6 +2669,8 @@ gst_videomixer2_finalize (GObject * o)
   GstVideoMixer2 *mix = GST_VIDEO_MIXER2 (o);
 
   gst_object_unref (mix->collect);
+  if (mix->pool)
+    g_thread_pool_free (mix->pool, FALSE, TRUE);
   g_mutex_clear (&mix->lock);
   g_mutex_clear (&mix->setcaps_lock);
 
@@ -2111,6 +2696,7 @@ gst_videomixer2_dispose (GObject * o)
     mix->pending_tags = NULL;
   }
 
+  gst_videomixer2_clear_previous (mix);
   gst_caps_replace (&mix->current_caps, NULL);
 
   G_OBJECT_CLASS (parent_class)->dispose (o);
@@ -2126,6 +2712,26 @@ gst_videomixer2_get_property (GObject * object,
     case PROP_BACKGROUND:
       g_value_set_enum (value, mix->background);
       break;
+    case PROP_N_THREADS:
+      GST_OBJECT_LOCK (mix);
+      g_value_set_uint (value, mix->n_threads);
+      GST_OBJECT_UNLOCK (mix);
+      break;
+    case PROP_REUSE_UNCHANGED:
+      GST_OBJECT_LOCK (mix);
+      g_value_set_boolean (value, mix->reuse_unchanged);
+      GST_OBJECT_UNLOCK (mix);
+      break;
+    case PROP_STATS:
+      GST_OBJECT_LOCK (mix);
+      g_value_take_boxed (value,
+          gst_structure_new ("application/x-videomixer-stats",
+              "pixels-blended", G_TYPE_UINT64, mix->pixels_blended,
+              "pixels-filled", G_TYPE_UINT64, mix->pixels_filled,
+              "pixels-reused", G_TYPE_UINT64, mix->pixels_reused,
+              "inputs-hidden", G_TYPE_UINT, mix->inputs_hidden, NULL));
+      GST_OBJECT_UNLOCK (mix);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -2142,6 +2748,16 @@ gst_videomixer2_set_property (GObject * object,
     case PROP_BACKGROUND:
       mix->background = g_value_get_enum (value);
       break;
+    case PROP_N_THREADS:
+      GST_OBJECT_LOCK (mix);
+      mix->n_threads = g_value_get_uint (value);
+      GST_OBJECT_UNLOCK (mix);
+      break;
+    case PROP_REUSE_UNCHANGED:
+      GST_OBJECT_LOCK (mix);
+      mix->reuse_unchanged = g_value_get_boolean (value);
+      GST_OBJECT_UNLOCK (mix);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -2218,6 +2834,54 @@ gst_videomixer2_class_init (GstVideoMixer2Class * klass)
           GST_TYPE_VIDEO_MIXER2_BACKGROUND,
           DEFAULT_BACKGROUND, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstVideoMixer2:n-threads:
+   *
+   * Maximum number of threads to use. Inputs that need conversion are
+   * converted in parallel, and the output frame is split into horizontal
+   * stripes that are blended in parallel. The output is the same as with a
+   * single thread. 0 uses one thread per CPU.
+   *
+   * Since: 1.18
+   */
+  g_object_class_install_property (gobject_class, PROP_N_THREADS,
+      g_param_spec_uint ("n-threads", "Threads",
+          "Maximum number of threads to use", 0, G_MAXUINT,
+          DEFAULT_N_THREADS, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstVideoMixer2:reuse-unchanged:
+   *
+   * Keep the previous output frame around and only redraw the horizontal
+   * stripes of the output that are touched by inputs whose buffer changed.
+   * Inputs count as unchanged if they get the same memory again, as with
+   * imagefreeze or other sources of static pictures. Moving an input or
+   * changing its alpha redraws the whole frame.
+   *
+   * Since: 1.18
+   */
+  g_object_class_install_property (gobject_class, PROP_REUSE_UNCHANGED,
+      g_param_spec_boolean ("reuse-unchanged", "Reuse unchanged",
+          "Only redraw the parts of the output whose inputs changed",
+          DEFAULT_REUSE_UNCHANGED,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstVideoMixer2:stats:
+   *
+   * Statistics about the last output frame: the number of pixels blended
+   * from inputs, filled with the background and copied from the previous
+   * frame with #GstVideoMixer2:reuse-unchanged, and the number of inputs
+   * that were not blended at all because they were hidden behind opaque
+   * inputs or outside of the frame.
+   *
+   * Since: 1.18
+   */
+  g_object_class_install_property (gobject_class, PROP_STATS,
+      g_param_spec_boxed ("stats", "Statistics",
+          "Statistics about the last output frame", GST_TYPE_STRUCTURE,
+          G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
   gstelement_class->request_new_pad =
       GST_DEBUG_FUNCPTR (gst_videomixer2_request_new_pad);
   gstelement_class->release_pad =
@@ -2257,6 +2921,8 @@ gst_videomixer2_init (GstVideoMixer2 * mix)
   gst_collect_pads_set_flush_function (mix->collect,
       (GstCollectPadsFlushFunction) gst_videomixer2_flush, mix);
   mix->background = DEFAULT_BACKGROUND;
+  mix->n_threads = DEFAULT_N_THREADS;
+  mix->reuse_unchanged = DEFAULT_REUSE_UNCHANGED;
   mix->current_caps = NULL;
   mix->pending_tags = NULL;
 
@@ -41,6 +41,7 @@ G_BEGIN_DECLS
 
 typedef struct _GstVideoMixer2 GstVideoMixer2;
 typedef struct _GstVideoMixer2Class GstVideoMixer2Class;
+typedef struct _GstVideoMixer2PrevInput GstVideoMixer2PrevInput;
 
 /**
  * GstVideoMixer2Background:
@@ -100,6 +101,24 @@ struct _GstVideoMixer2
 
   GstVideoMixer2Background background;
 
+  /* Threads used for converting and blending, protected by the object lock */
+  guint n_threads;
+  GThreadPool *pool;
+
+  /* Protected by the object lock, like the stats below */
+  gboolean reuse_unchanged;
+
+  /* Copy of the previous output frame and what it was made from */
+  GstBuffer *prev_outbuf;
+  GstVideoInfo prev_info;
+  GstVideoMixer2Background prev_background;
+  GstVideoMixer2PrevInput *prev_inputs;
+  guint n_prev_inputs;
+
+  /* Statistics about the last output frame */
+  guint64 pixels_blended, pixels_filled, pixels_reused;
+  guint inputs_hidden;
+
   /* Current downstream segment */
   GstSegment segment;
   GstClockTime ts_offset;
@@ -122,6 +141,14 @@ struct _GstVideoMixer2
   GstTagList *pending_tags;
 };
 
+struct _GstVideoMixer2PrevInput
+{
+  GstBuffer *buffer;
+  gint xpos, ypos;
+  gint width, height;
+  gdouble alpha;
+};
+
 struct _GstVideoMixer2Class
 {
   GstElementClass parent_class;
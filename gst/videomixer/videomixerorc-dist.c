@@ -96,6 +96,7 @@ typedef union
 #include <orc/orc.h>
 #endif
 void video_mixer_orc_splat_u32 (guint32 * ORC_RESTRICT d1, int p1, int n);
+void video_mixer_orc_splat_u16 (guint16 * ORC_RESTRICT d1, int p1, int n);
 void video_mixer_orc_memcpy_u32 (guint32 * ORC_RESTRICT d1,
     const guint32 * ORC_RESTRICT s1, int n);
 void video_mixer_orc_blend_u8 (guint8 * ORC_RESTRICT d1, int d1_stride,
@@ -254,6 +255,106 @@ video_mixer_orc_splat_u32 (guint32 * ORC_RESTRICT d1, int p1, int n)
 #endif
 
 
+/* video_mixer_orc_splat_u16 */
+#ifdef DISABLE_ORC
+void
+video_mixer_orc_splat_u16 (guint16 * ORC_RESTRICT d1, int p1, int n)
+{
+  int i;
+  orc_union16 *ORC_RESTRICT ptr0;
+  orc_int16 var32;
+  orc_int16 var33;
+
+  ptr0 = (orc_union16 *) d1;
+
+  /* 0: loadpw */
+  var32 = p1;
+
+  for (i = 0; i < n; i++) {
+    /* 1: copyw */
+    var33 = var32;
+    /* 2: storew */
+    ptr0[i].i = var33;
+  }
+
+}
+
+#else
+static void
+_backup_video_mixer_orc_splat_u16 (OrcExecutor * ORC_RESTRICT ex)
+{
+  int i;
+  int n = ex->n;
+  orc_union16 *ORC_RESTRICT ptr0;
+  orc_int16 var32;
+  orc_int16 var33;
+
+  ptr0 = (orc_union16 *) ex->arrays[0];
+
+  /* 0: loadpw */
+  var32 = ex->params[24];
+
+  for (i = 0; i < n; i++) {
+    /* 1: copyw */
+    var33 = var32;
+    /* 2: storew */
+    ptr0[i].i = var33;
+  }
+
+}
+
+void
+video_mixer_orc_splat_u16 (guint16 * ORC_RESTRICT d1, int p1, int n)
+{
+  OrcExecutor _ex, *ex = &_ex;
+  static volatile int p_inited = 0;
+  static OrcCode *c = 0;
+  void (*func) (OrcExecutor *);
+
+  if (!p_inited) {
+    orc_once_mutex_lock ();
+    if (!p_inited) {
+      OrcProgram *p;
+
+#if 1
+      static const orc_uint8 bc[] = {
+        1, 9, 25, 118, 105, 100, 101, 111, 95, 109, 105, 120, 101, 114, 95, 111,
+        114, 99, 95, 115, 112, 108, 97, 116, 95, 117, 49, 54, 11, 2, 2, 16,
+        2, 79, 0, 24, 2, 0,
+      };
+      p = orc_program_new_from_static_bytecode (bc);
+      orc_program_set_backup_function (p, _backup_video_mixer_orc_splat_u16);
+#else
+      p = orc_program_new ();
+      orc_program_set_name (p, "video_mixer_orc_splat_u16");
+      orc_program_set_backup_function (p, _backup_video_mixer_orc_splat_u16);
+      orc_program_add_destination (p, 2, "d1");
+      orc_program_add_parameter (p, 2, "p1");
+
+      orc_program_append_2 (p, "copyw", 0, ORC_VAR_D1, ORC_VAR_P1, ORC_VAR_D1,
+          ORC_VAR_D1);
+#endif
+
+      orc_program_compile (p);
+      c = orc_program_take_code (p);
+      orc_program_free (p);
+    }
+    p_inited = TRUE;
+    orc_once_mutex_unlock ();
+  }
+  ex->arrays[ORC_VAR_A2] = c;
+  ex->program = 0;
+
+  ex->n = n;
+  ex->arrays[ORC_VAR_D1] = d1;
+  ex->params[ORC_VAR_P1] = p1;
+
+  func = c->exec;
+  func (ex);
+}
+#endif
+
+
 /* video_mixer_orc_memcpy_u32 */
 #ifdef DISABLE_ORC
 void
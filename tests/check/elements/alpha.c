@@ -19,8 +19,10 @@
  */
 
 #include <gst/check/gstcheck.h>
+#include <gst/check/gstharness.h>
 #include <gst/video/video.h>
 
+#include "nthreads.h"
 
 GstPad *srcpad, *sinkpad;
 
@@ -248,6 +250,121 @@ GST_START_TEST (test_alpha)
 
 GST_END_TEST;
 
+/* Chroma keys a test pattern frame in the format @user_data on a custom
+ * color */
+static GList *
+key_frame (guint n_threads, gpointer user_data)
+{
+  const gchar *format = user_data;
+  GstHarness *h;
+  GstBuffer *buf;
+  gchar *launch;
+
+  h = gst_harness_new ("alpha");
+  gst_util_set_object_arg (G_OBJECT (h->element), "method", "custom");
+  g_object_set (h->element, "target-r", 40, "target-g", 200, "target-b", 60,
+      "angle", 40.0f, "n-threads", n_threads, NULL);
+  gst_harness_set_sink_caps_str (h,
+      "video/x-raw,format=AYUV,width=160,height=122,framerate=25/1");
+
+  launch = g_strdup_printf ("videotestsrc pattern=smpte "
+      "! video/x-raw,format=%s,width=160,height=122,framerate=25/1", format);
+  gst_harness_add_src_parse (h, launch, TRUE);
+  g_free (launch);
+
+  fail_unless_equals_int (gst_harness_push_from_src (h), GST_FLOW_OK);
+  buf = gst_harness_pull (h);
+  fail_unless (buf != NULL);
+
+  gst_harness_teardown (h);
+
+  return g_list_prepend (NULL, buf);
+}
+
+/* Processing bands in parallel must not change the output */
+GST_START_TEST (test_n_threads)
+{
+  const gchar *formats[] = { "AYUV", "I420", "Y41B", "YUY2", "RGB", "ARGB" };
+  guint i;
+
+  for (i = 0; i < G_N_ELEMENTS (formats); i++) {
+    GList *out;
+
+    out = check_n_threads_output (key_frame, (gpointer) formats[i], 3,
+        formats[i]);
+    g_list_free_full (out, (GDestroyNotify) gst_buffer_unref);
+  }
+}
+
+GST_END_TEST;
+
+#define HALVES_WIDTH 160
+#define HALVES_HEIGHT 122
+
+/* Keys green on an RGBA frame whose left half is green and whose right half
+ * is white */
+static GList *
+key_halves (guint n_threads, gpointer user_data)
+{
+  GstHarness *h;
+  GstBuffer *buf;
+  GstMapInfo map;
+  gint x, y;
+
+  h = gst_harness_new ("alpha");
+  g_object_set (h->element, "method", 1, "n-threads", n_threads, NULL);
+  gst_harness_set_src_caps_str (h, "video/x-raw,format=RGBA,width=160,"
+      "height=122,framerate=25/1");
+  gst_harness_set_sink_caps_str (h, "video/x-raw,format=AYUV,width=160,"
+      "height=122,framerate=25/1");
+
+  buf = gst_buffer_new_and_alloc (HALVES_WIDTH * HALVES_HEIGHT * 4);
+  gst_buffer_map (buf, &map, GST_MAP_WRITE);
+  for (y = 0; y < HALVES_HEIGHT; y++) {
+    for (x = 0; x < HALVES_WIDTH; x++) {
+      guint8 *pixel = map.data + (y * HALVES_WIDTH + x) * 4;
+      guint8 rb = x < HALVES_WIDTH / 2 ? 0 : 255;
+
+      pixel[0] = rb;
+      pixel[1] = 255;
+      pixel[2] = rb;
+      pixel[3] = 255;
+    }
+  }
+  gst_buffer_unmap (buf, &map);
+
+  fail_unless_equals_int (gst_harness_push (h, buf), GST_FLOW_OK);
+  buf = gst_harness_pull (h);
+  fail_unless (buf != NULL);
+
+  gst_harness_teardown (h);
+
+  return g_list_prepend (NULL, buf);
+}
+
+/* Every band must key the pixels that lie in it */
+GST_START_TEST (test_n_threads_values)
+{
+  GstMapInfo map;
+  GList *out;
+  gint x, y;
+
+  out = check_n_threads_output (key_halves, NULL, 3, "halves");
+
+  gst_buffer_map (out->data, &map, GST_MAP_READ);
+  fail_unless_equals_int (map.size, HALVES_WIDTH * HALVES_HEIGHT * 4);
+  for (y = 0; y < HALVES_HEIGHT; y++) {
+    for (x = 0; x < HALVES_WIDTH; x++) {
+      fail_unless_equals_int (map.data[(y * HALVES_WIDTH + x) * 4],
+          x < HALVES_WIDTH / 2 ? 0 : 255);
+    }
+  }
+  gst_buffer_unmap (out->data, &map);
+
+  g_list_free_full (out, (GDestroyNotify) gst_buffer_unref);
+}
+
+GST_END_TEST;
 
 static Suite *
 alpha_suite (void)
@@ -258,6 +375,8 @@ alpha_suite (void)
   suite_add_tcase (s, tc_chain);
   tcase_add_test (tc_chain, test_alpha);
   tcase_add_test (tc_chain, test_chromakeying);
+  tcase_add_test (tc_chain, test_n_threads);
+  tcase_add_test (tc_chain, test_n_threads_values);
 
   return s;
 }
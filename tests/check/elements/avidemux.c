@@ -0,0 +1,80 @@
+/* GStreamer
+ *
+ * unit test for avidemux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <gst/check/gstcheck.h>
+
+#include "../../gst/avi/gstavidemux.h"
+
+static void
+check_entry (guint64 offset, guint32 size, guint64 total, gboolean keyframe)
+{
+  GstAviIndexEntry entry;
+
+  gst_avi_index_entry_set (&entry, offset, size, total, keyframe);
+
+  fail_unless_equals_uint64 (ENTRY_OFFSET (&entry), offset);
+  fail_unless_equals_uint64 (ENTRY_SIZE (&entry), size);
+  fail_unless_equals_uint64 (ENTRY_TOTAL (&entry), total);
+  fail_unless_equals_int (ENTRY_IS_KEYFRAME (&entry), keyframe);
+}
+
+GST_START_TEST (test_index_entry_packing)
+{
+  fail_unless_equals_int (sizeof (GstAviIndexEntry), 16);
+
+  check_entry (0, 0, 0, FALSE);
+  check_entry (0, 0, 0, TRUE);
+
+  /* The size keeps all 32 bits, independent of the keyframe flag */
+  check_entry (8, G_MAXUINT32, 0, FALSE);
+  check_entry (8, G_MAXUINT32, 0, TRUE);
+
+  /* Values crossing the split between the low and high parts */
+  check_entry (G_MAXUINT32, 100, G_MAXUINT32, TRUE);
+  check_entry (G_GUINT64_CONSTANT (1) << 32, 100,
+      G_GUINT64_CONSTANT (1) << 32, FALSE);
+  check_entry (G_GUINT64_CONSTANT (0x123456789abc), 0x80000000,
+      G_GUINT64_CONSTANT (0x23456789abcd), TRUE);
+
+  /* The largest values that can be stored, the upper bit of the total is
+   * taken by the keyframe flag */
+  check_entry (ENTRY_MAX_OFFSET, G_MAXUINT32, ENTRY_MAX_TOTAL, FALSE);
+  check_entry (ENTRY_MAX_OFFSET, G_MAXUINT32, ENTRY_MAX_TOTAL, TRUE);
+  fail_unless_equals_uint64 (ENTRY_MAX_OFFSET,
+      G_GUINT64_CONSTANT (0xffffffffffff));
+  fail_unless_equals_uint64 (ENTRY_MAX_TOTAL,
+      G_GUINT64_CONSTANT (0x7fffffffffff));
+}
+
+GST_END_TEST;
+
+static Suite *
+avidemux_suite (void)
+{
+  Suite *s = suite_create ("avidemux");
+  TCase *tc_chain = tcase_create ("general");
+
+  suite_add_tcase (s, tc_chain);
+  tcase_add_test (tc_chain, test_index_entry_packing);
+
+  return s;
+}
+
+GST_CHECK_MAIN (avidemux);
@@ -23,8 +23,11 @@
 
 #include <stdio.h>
 #include <gst/check/gstcheck.h>
+#include <gst/check/gstharness.h>
 #include <gst/video/video.h>
 
+#include "nthreads.h"
+
 static gboolean
 gst_caps_is_interlaced (GstCaps * caps)
 {
@@ -1016,6 +1019,362 @@ GST_START_TEST (test_fields_auto_expected_caps)
 
 GST_END_TEST;
 
+/* Allocates a frame of random samples that are valid for the format's
+ * depth and shift */
+static GstBuffer *
+random_frame (const GstVideoInfo * info, GRand * rand)
+{
+  GstBuffer *buf;
+  GstMapInfo map;
+  guint depth = GST_VIDEO_INFO_COMP_DEPTH (info, 0);
+  guint shift = GST_VIDEO_FORMAT_INFO_SHIFT (info->finfo, 0);
+  gsize j;
+
+  buf = gst_buffer_new_allocate (NULL, GST_VIDEO_INFO_SIZE (info), NULL);
+  gst_buffer_map (buf, &map, GST_MAP_WRITE);
+  if (depth > 8) {
+    for (j = 0; j + 1 < map.size; j += 2)
+      GST_WRITE_UINT16_LE (map.data + j, g_rand_int_range (rand, 0,
+              1 << depth) << shift);
+  } else {
+    for (j = 0; j < map.size; j++)
+      map.data[j] = g_rand_int (rand) & 0xff;
+  }
+  gst_buffer_unmap (buf, &map);
+
+  return buf;
+}
+
+/* Deinterlaces a few frames of random data and returns the output */
+static GList *
+deinterlace_random_frames (const gchar * format, const gchar * method,
+    guint n_threads)
+{
+  GstHarness *h;
+  GstVideoInfo info;
+  GstCaps *caps;
+  GstBuffer *buf;
+  GList *out = NULL;
+  GRand *rand;
+  guint i;
+
+  h = gst_harness_new ("deinterlace");
+  gst_util_set_object_arg (G_OBJECT (h->element), "method", method);
+  g_object_set (h->element, "n-threads", n_threads, NULL);
+
+  caps = gst_caps_new_simple ("video/x-raw",
+      "format", G_TYPE_STRING, format,
+      "width", G_TYPE_INT, 320, "height", G_TYPE_INT, 240,
+      "framerate", GST_TYPE_FRACTION, 30, 1,
+      "interlace-mode", G_TYPE_STRING, "interleaved", NULL);
+  fail_unless (gst_video_info_from_caps (&info, caps));
+  gst_harness_set_src_caps (h, caps);
+
+  rand = g_rand_new_with_seed (42);
+  for (i = 0; i < 6; i++) {
+    buf = random_frame (&info, rand);
+
+    GST_BUFFER_PTS (buf) = i * GST_SECOND / 30;
+    GST_BUFFER_DURATION (buf) = GST_SECOND / 30;
+    fail_unless_equals_int (gst_harness_push (h, buf), GST_FLOW_OK);
+  }
+  g_rand_free (rand);
+
+  fail_unless (gst_harness_push_event (h, gst_event_new_eos ()));
+  while ((buf = gst_harness_try_pull (h)))
+    out = g_list_append (out, buf);
+
+  gst_harness_teardown (h);
+
+  return out;
+}
+
+typedef struct
+{
+  const gchar *format;
+  const gchar *method;
+} DeinterlaceRun;
+
+static GList *
+deinterlace_run (guint n_threads, gpointer user_data)
+{
+  DeinterlaceRun *run = user_data;
+
+  return deinterlace_random_frames (run->format, run->method, n_threads);
+}
+
+/* Splitting frames into bands must not change the output */
+static void
+check_n_threads (const gchar * format, const gchar * method)
+{
+  DeinterlaceRun run = { format, method };
+  gchar *what = g_strdup_printf ("%s %s", format, method);
+  GList *out;
+
+  out = check_n_threads_output (deinterlace_run, &run, 4, what);
+  g_list_free_full (out, (GDestroyNotify) gst_buffer_unref);
+  g_free (what);
+}
+
+GST_START_TEST (test_n_threads)
+{
+  const gchar *formats[] = { "I420", "YUY2", "NV12" };
+  const gchar *methods[] = { "linear", "greedyl", "yadif" };
+  guint f, m;
+
+  for (f = 0; f < G_N_ELEMENTS (formats); f++) {
+    for (m = 0; m < G_N_ELEMENTS (methods); m++)
+      check_n_threads (formats[f], methods[m]);
+  }
+}
+
+GST_END_TEST;
+
+/* Deinterlaces the same random frame a few times with @method */
+static GList *
+deinterlace_still_frame (const GstVideoInfo * info, GstBuffer * in,
+    const gchar * method)
+{
+  GstHarness *h;
+  GstBuffer *buf;
+  GList *out = NULL;
+  guint i;
+
+  h = gst_harness_new ("deinterlace");
+  gst_util_set_object_arg (G_OBJECT (h->element), "method", method);
+  gst_harness_set_src_caps (h, gst_video_info_to_caps (info));
+
+  for (i = 0; i < 4; i++) {
+    buf = gst_buffer_copy (in);
+    GST_BUFFER_PTS (buf) = i * GST_SECOND / 30;
+    GST_BUFFER_DURATION (buf) = GST_SECOND / 30;
+    fail_unless_equals_int (gst_harness_push (h, buf), GST_FLOW_OK);
+  }
+
+  fail_unless (gst_harness_push_event (h, gst_event_new_eos ()));
+  while ((buf = gst_harness_try_pull (h)))
+    out = g_list_append (out, buf);
+
+  gst_harness_teardown (h);
+
+  return out;
+}
+
+static guint16
+sample (const GstVideoFrame * frame, gint comp, gint x, gint y)
+{
+  const guint8 *data = GST_VIDEO_FRAME_COMP_DATA (frame, comp);
+
+  return GST_READ_UINT16_LE (data + y * GST_VIDEO_FRAME_COMP_STRIDE (frame,
+          comp) + x * GST_VIDEO_FRAME_COMP_PSTRIDE (frame, comp));
+}
+
+/* Checks the lines of one deinterlaced field. Lines of the field are
+ * copied. With @linear the other lines are the average of the lines above
+ * and below, otherwise they are the other field's lines, which are the
+ * same as the input as all frames are the same */
+static void
+check_field (GstVideoFrame * in, GstVideoFrame * out, gboolean top,
+    gboolean linear)
+{
+  gint c, x, y;
+
+  for (c = 0; c < GST_VIDEO_FRAME_N_COMPONENTS (in); c++) {
+    gint width = GST_VIDEO_FRAME_COMP_WIDTH (in, c);
+    gint height = GST_VIDEO_FRAME_COMP_HEIGHT (in, c);
+
+    for (y = 0; y < height; y++) {
+      gboolean copied = (y & 1) == (top ? 0 : 1);
+
+      /* the first and last interpolated lines only have one neighbour */
+      if (linear && !copied && (y == 0 || y == height - 1))
+        continue;
+
+      for (x = 0; x < width; x++) {
+        guint expected;
+
+        if (copied || !linear)
+          expected = sample (in, c, x, y);
+        else
+          expected = (sample (in, c, x, y - 1) + sample (in, c, x,
+                  y + 1) + 1) >> 1;
+
+        fail_unless_equals_int (sample (out, c, x, y), expected);
+      }
+    }
+  }
+}
+
+static void
+check_high_bit_depth_values (const gchar * format)
+{
+  GstVideoInfo info;
+  GstVideoFrame in_frame, out_frame;
+  GstBuffer *in;
+  GList *out, *l;
+  GRand *rand;
+  guint n_top = 0, n_bottom = 0;
+
+  gst_video_info_set_interlaced_format (&info,
+      gst_video_format_from_string (format),
+      GST_VIDEO_INTERLACE_MODE_INTERLEAVED, 320, 240);
+  GST_VIDEO_INFO_FPS_N (&info) = 30;
+  GST_VIDEO_INFO_FPS_D (&info) = 1;
+
+  rand = g_rand_new_with_seed (42);
+  in = random_frame (&info, rand);
+  g_rand_free (rand);
+  fail_unless (gst_video_frame_map (&in_frame, &info, in, GST_MAP_READ));
+
+  out = deinterlace_still_frame (&info, in, "linear");
+  fail_unless (out != NULL);
+  for (l = out; l; l = l->next) {
+    gboolean top;
+
+    fail_unless (gst_video_frame_map (&out_frame, &info, l->data,
+            GST_MAP_READ));
+    /* line 0 is only copied as is for the top field */
+    top = sample (&out_frame, 0, 0, 0) == sample (&in_frame, 0, 0, 0) &&
+        sample (&out_frame, 0, 1, 0) == sample (&in_frame, 0, 1, 0);
+    if (top)
+      n_top++;
+    else
+      n_bottom++;
+    check_field (&in_frame, &out_frame, top, TRUE);
+    gst_video_frame_unmap (&out_frame);
+  }
+  g_list_free_full (out, (GDestroyNotify) gst_buffer_unref);
+  /* every frame gives one output frame per field */
+  fail_unless (n_top > 0 && n_bottom > 0);
+
+  out = deinterlace_still_frame (&info, in, "weave");
+  fail_unless (out != NULL);
+  /* the last field has no next field to weave with */
+  for (l = out; l && l->next; l = l->next) {
+    fail_unless (gst_video_frame_map (&out_frame, &info, l->data,
+            GST_MAP_READ));
+    check_field (&in_frame, &out_frame, TRUE, FALSE);
+    gst_video_frame_unmap (&out_frame);
+  }
+  g_list_free_full (out, (GDestroyNotify) gst_buffer_unref);
+
+  gst_video_frame_unmap (&in_frame);
+  gst_buffer_unref (in);
+}
+
+GST_START_TEST (test_high_bit_depth)
+{
+  const gchar *formats[] = { "I420_10LE", "I422_10LE", "Y444_12LE",
+    "P010_10LE"
+  };
+  const gchar *methods[] = { "linear", "weave", "yadif" };
+  guint f, m;
+
+  for (f = 0; f < G_N_ELEMENTS (formats); f++) {
+    for (m = 0; m < G_N_ELEMENTS (methods); m++)
+      check_n_threads (formats[f], methods[m]);
+  }
+
+  check_high_bit_depth_values ("I420_10LE");
+  check_high_bit_depth_values ("Y444_12LE");
+  check_high_bit_depth_values ("P010_10LE");
+}
+
+GST_END_TEST;
+
+/* Progressive frames of a mixed stream are pushed out without copying */
+GST_START_TEST (test_mixed_progressive_no_copy)
+{
+  GstHarness *h;
+  GstBuffer *in, *out;
+  GstMemory *in_mem;
+  guint i;
+
+  h = gst_harness_new ("deinterlace");
+  gst_harness_set_src_caps_str (h, "video/x-raw, format=I420, width=64, "
+      "height=64, framerate=30/1, interlace-mode=mixed");
+
+  for (i = 0; i < 3; i++) {
+    in = gst_buffer_new_allocate (NULL, 64 * 64 * 3 / 2, NULL);
+    gst_buffer_memset (in, 0, 0x80, 64 * 64 * 3 / 2);
+    GST_BUFFER_PTS (in) = i * GST_SECOND / 30;
+    GST_BUFFER_DURATION (in) = GST_SECOND / 30;
+    in_mem = gst_buffer_peek_memory (in, 0);
+
+    fail_unless_equals_int (gst_harness_push (h, in), GST_FLOW_OK);
+    out = gst_harness_pull (h);
+    fail_unless (out != NULL);
+    fail_unless_equals_int (gst_buffer_n_memory (out), 1);
+    fail_unless (gst_buffer_peek_memory (out, 0) == in_mem);
+    gst_buffer_unref (out);
+  }
+
+  gst_harness_teardown (h);
+}
+
+GST_END_TEST;
+
+/* Progressive frames of a pattern-locked 2:3 telecine stream are pushed out
+ * without copying, with the timestamps of the 24p content */
+GST_START_TEST (test_telecine_locked_no_copy)
+{
+  GstHarness *h;
+  GstBuffer *in, *out;
+  GstMemory *in_mem[20];
+  GstCaps *caps;
+  GstStructure *s;
+  GstClockTime pts = 0;
+  gint fps_n, fps_d;
+  guint i;
+
+  h = gst_harness_new ("deinterlace");
+  /* active locking */
+  g_object_set (h->element, "locking", 2, NULL);
+  gst_harness_set_src_caps_str (h, "video/x-raw, format=I420, width=64, "
+      "height=64, framerate=30/1, interlace-mode=mixed");
+
+  /* 2:3-RFF: every second frame repeats its first field */
+  for (i = 0; i < G_N_ELEMENTS (in_mem); i++) {
+    guint n_fields = (i % 2) ? 3 : 2;
+
+    in = gst_buffer_new_allocate (NULL, 64 * 64 * 3 / 2, NULL);
+    gst_buffer_memset (in, 0, 0x80, 64 * 64 * 3 / 2);
+    GST_BUFFER_FLAG_SET (in, GST_VIDEO_BUFFER_FLAG_TFF);
+    if (n_fields == 3)
+      GST_BUFFER_FLAG_SET (in, GST_VIDEO_BUFFER_FLAG_RFF);
+    GST_BUFFER_PTS (in) = pts;
+    GST_BUFFER_DURATION (in) = n_fields * GST_SECOND / 60;
+    pts += GST_BUFFER_DURATION (in);
+    in_mem[i] = gst_memory_ref (gst_buffer_peek_memory (in, 0));
+
+    fail_unless_equals_int (gst_harness_push (h, in), GST_FLOW_OK);
+  }
+  fail_unless (gst_harness_push_event (h, gst_event_new_eos ()));
+
+  /* locked onto the pattern, so the output has the content's framerate */
+  caps = gst_pad_get_current_caps (h->sinkpad);
+  fail_unless (caps != NULL);
+  s = gst_caps_get_structure (caps, 0);
+  fail_unless (gst_structure_get_fraction (s, "framerate", &fps_n, &fps_d));
+  fail_unless_equals_int (fps_n, 24);
+  fail_unless_equals_int (fps_d, 1);
+  gst_caps_unref (caps);
+
+  for (i = 0; i < G_N_ELEMENTS (in_mem); i++) {
+    out = gst_harness_try_pull (h);
+    fail_unless (out != NULL, "only %u of %u frames pushed", i,
+        (guint) G_N_ELEMENTS (in_mem));
+    fail_unless_equals_int (gst_buffer_n_memory (out), 1);
+    fail_unless (gst_buffer_peek_memory (out, 0) == in_mem[i]);
+    gst_buffer_unref (out);
+    gst_memory_unref (in_mem[i]);
+  }
+  fail_unless (gst_harness_try_pull (h) == NULL);
+
+  gst_harness_teardown (h);
+}
+
+GST_END_TEST;
 
 
 static Suite *
@@ -1045,6 +1404,10 @@ deinterlace_suite (void)
   tcase_add_test (tc_chain, test_mode_auto_expected_caps);
   tcase_add_test (tc_chain, test_mode_auto_strict_expected_caps);
   tcase_add_test (tc_chain, test_fields_auto_expected_caps);
+  tcase_add_test (tc_chain, test_n_threads);
+  tcase_add_test (tc_chain, test_high_bit_depth);
+  tcase_add_test (tc_chain, test_mixed_progressive_no_copy);
+  tcase_add_test (tc_chain, test_telecine_locked_no_copy);
 
   return s;
 }
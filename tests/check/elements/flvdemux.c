@@ -21,6 +21,7 @@
 
 #include <gst/check/gstcheck.h>
 #include <gst/check/gstharness.h>
+#include <glib/gstdio.h>
 
 #include <gst/gst.h>
 #include <gst/tag/tag.h>
@@ -651,6 +652,254 @@ GST_START_TEST (test_h264)
 
 GST_END_TEST;
 
+GST_START_TEST (test_seek_index_property)
+{
+  GstElement *demux;
+  GBytes *bytes, *out;
+  guint8 data[8 + 2 * 20];
+  const guint8 *out_data;
+  gsize size, i;
+  gboolean found[2] = { FALSE, FALSE };
+
+  demux = gst_element_factory_make ("flvdemux", NULL);
+  fail_unless (demux != NULL);
+
+  GST_WRITE_UINT32_LE (data, GST_MAKE_FOURCC ('F', 'L', 'V', 'I'));
+  GST_WRITE_UINT32_BE (data + 4, 1);
+  GST_WRITE_UINT64_BE (data + 8, 0);
+  GST_WRITE_UINT64_BE (data + 16, 13);
+  GST_WRITE_UINT32_BE (data + 24, 1);
+  GST_WRITE_UINT64_BE (data + 28, 10 * GST_SECOND);
+  GST_WRITE_UINT64_BE (data + 36, 123456);
+  GST_WRITE_UINT32_BE (data + 44, 1);
+
+  /* imported once the index is created */
+  bytes = g_bytes_new_static (data, sizeof (data));
+  g_object_set (demux, "seek-index", bytes, NULL);
+  g_bytes_unref (bytes);
+
+  fail_unless (gst_element_set_state (demux, GST_STATE_PAUSED) !=
+      GST_STATE_CHANGE_FAILURE);
+
+  g_object_get (demux, "seek-index", &out, NULL);
+  out_data = g_bytes_get_data (out, &size);
+  fail_unless_equals_int (size, sizeof (data));
+  for (i = 8; i < size; i += 20) {
+    guint64 pos = GST_READ_UINT64_BE (out_data + i + 8);
+
+    fail_unless_equals_int (GST_READ_UINT32_BE (out_data + i + 16), 1);
+    if (pos == 13) {
+      fail_unless_equals_uint64 (GST_READ_UINT64_BE (out_data + i), 0);
+      found[0] = TRUE;
+    } else if (pos == 123456) {
+      fail_unless_equals_uint64 (GST_READ_UINT64_BE (out_data + i),
+          10 * GST_SECOND);
+      found[1] = TRUE;
+    }
+  }
+  fail_unless (found[0] && found[1]);
+  g_bytes_unref (out);
+
+  gst_element_set_state (demux, GST_STATE_NULL);
+  gst_object_unref (demux);
+}
+
+GST_END_TEST;
+
+/* audio only, so that every tag is a seek point, and streamable so that
+ * flvmux doesn't write a keyframes index into the metadata */
+static gchar *
+write_audio_file (void)
+{
+  GstElement *pipeline;
+  GstMessage *msg;
+  gchar *location, *desc;
+
+  location = g_strdup_printf ("%s/%s-%d", g_get_tmp_dir (), "flvdemuxtest",
+      g_random_int ());
+  desc = g_strdup_printf ("audiotestsrc num-buffers=300 samplesperbuffer=2205 "
+      "! audio/x-raw,format=S16LE,rate=22050,channels=1 "
+      "! flvmux streamable=true ! filesink location=\"%s\"", location);
+  pipeline = gst_parse_launch (desc, NULL);
+  fail_unless (pipeline != NULL);
+  g_free (desc);
+
+  fail_unless (gst_element_set_state (pipeline, GST_STATE_PLAYING) !=
+      GST_STATE_CHANGE_FAILURE);
+  msg = gst_bus_timed_pop_filtered (GST_ELEMENT_BUS (pipeline),
+      GST_CLOCK_TIME_NONE, GST_MESSAGE_EOS | GST_MESSAGE_ERROR);
+  fail_unless_equals_int (GST_MESSAGE_TYPE (msg), GST_MESSAGE_EOS);
+  gst_message_unref (msg);
+
+  gst_element_set_state (pipeline, GST_STATE_NULL);
+  gst_object_unref (pipeline);
+
+  return location;
+}
+
+static GBytes *
+read_seek_index (const gchar * location)
+{
+  GstElement *pipeline, *demux;
+  GstMessage *msg;
+  GBytes *bytes;
+  gchar *desc;
+
+  desc = g_strdup_printf ("filesrc location=\"%s\" ! flvdemux name=demux "
+      "! fakesink", location);
+  pipeline = gst_parse_launch (desc, NULL);
+  fail_unless (pipeline != NULL);
+  g_free (desc);
+
+  fail_unless (gst_element_set_state (pipeline, GST_STATE_PLAYING) !=
+      GST_STATE_CHANGE_FAILURE);
+  msg = gst_bus_timed_pop_filtered (GST_ELEMENT_BUS (pipeline),
+      GST_CLOCK_TIME_NONE, GST_MESSAGE_EOS | GST_MESSAGE_ERROR);
+  fail_unless_equals_int (GST_MESSAGE_TYPE (msg), GST_MESSAGE_EOS);
+  gst_message_unref (msg);
+
+  demux = gst_bin_get_by_name (GST_BIN (pipeline), "demux");
+  g_object_get (demux, "seek-index", &bytes, NULL);
+  gst_object_unref (demux);
+
+  gst_element_set_state (pipeline, GST_STATE_NULL);
+  gst_object_unref (pipeline);
+
+  return bytes;
+}
+
+typedef struct
+{
+  GMutex lock;
+  GCond cond;
+  gboolean seeked;
+  gboolean have_segment;
+  gboolean done;
+  GstSegment segment;
+} SeekData;
+
+static GstPadProbeReturn
+seek_data_probe (GstPad * pad, GstPadProbeInfo * info, SeekData * data)
+{
+  g_mutex_lock (&data->lock);
+  if (data->seeked && !data->done) {
+    if (GST_IS_EVENT (info->data)) {
+      GstEvent *event = GST_PAD_PROBE_INFO_EVENT (info);
+
+      if (GST_EVENT_TYPE (event) == GST_EVENT_SEGMENT) {
+        gst_event_copy_segment (event, &data->segment);
+        data->have_segment = TRUE;
+      }
+    } else if (data->have_segment) {
+      data->done = TRUE;
+      g_cond_signal (&data->cond);
+    }
+  }
+  g_mutex_unlock (&data->lock);
+
+  return GST_PAD_PROBE_OK;
+}
+
+/* key unit seek to @target in push mode with @index imported before
+ * starting or while paused, returns the start of the resulting segment */
+static GstClockTime
+seek_push_with_index (const gchar * location, GBytes * index,
+    gboolean while_paused, GstClockTime target)
+{
+  GstElement *pipeline, *demux, *sink;
+  GstPad *pad;
+  SeekData data;
+  gchar *desc;
+
+  desc = g_strdup_printf ("filesrc location=\"%s\" ! queue "
+      "! flvdemux name=demux ! fakesink name=sink", location);
+  pipeline = gst_parse_launch (desc, NULL);
+  fail_unless (pipeline != NULL);
+  g_free (desc);
+
+  demux = gst_bin_get_by_name (GST_BIN (pipeline), "demux");
+  sink = gst_bin_get_by_name (GST_BIN (pipeline), "sink");
+  pad = gst_element_get_static_pad (sink, "sink");
+
+  memset (&data, 0, sizeof (data));
+  g_mutex_init (&data.lock);
+  g_cond_init (&data.cond);
+  gst_pad_add_probe (pad, GST_PAD_PROBE_TYPE_BUFFER |
+      GST_PAD_PROBE_TYPE_EVENT_DOWNSTREAM,
+      (GstPadProbeCallback) seek_data_probe, &data, NULL);
+
+  if (!while_paused)
+    g_object_set (demux, "seek-index", index, NULL);
+
+  fail_unless (gst_element_set_state (pipeline, GST_STATE_PAUSED) !=
+      GST_STATE_CHANGE_FAILURE);
+  fail_unless_equals_int (gst_element_get_state (pipeline, NULL, NULL,
+          GST_CLOCK_TIME_NONE), GST_STATE_CHANGE_SUCCESS);
+
+  /* only imported by the streaming thread once it is unblocked */
+  if (while_paused)
+    g_object_set (demux, "seek-index", index, NULL);
+
+  g_mutex_lock (&data.lock);
+  data.seeked = TRUE;
+  g_mutex_unlock (&data.lock);
+
+  fail_unless (gst_element_seek_simple (pipeline, GST_FORMAT_TIME,
+          GST_SEEK_FLAG_FLUSH | GST_SEEK_FLAG_KEY_UNIT, target));
+
+  g_mutex_lock (&data.lock);
+  while (!data.done)
+    g_cond_wait (&data.cond, &data.lock);
+  g_mutex_unlock (&data.lock);
+
+  gst_element_set_state (pipeline, GST_STATE_NULL);
+
+  g_mutex_clear (&data.lock);
+  g_cond_clear (&data.cond);
+  gst_object_unref (pad);
+  gst_object_unref (sink);
+  gst_object_unref (demux);
+  gst_object_unref (pipeline);
+
+  return data.segment.start;
+}
+
+GST_START_TEST (test_seek_index_push)
+{
+  const GstClockTime target = 25 * GST_SECOND + 50 * GST_MSECOND;
+  GstClockTime keyframe = 0;
+  GBytes *index;
+  const guint8 *data;
+  gchar *location;
+  gsize size, i;
+
+  location = write_audio_file ();
+  index = read_seek_index (location);
+
+  /* the entry a key unit seek should snap to */
+  data = g_bytes_get_data (index, &size);
+  fail_unless (size > 8);
+  for (i = 8; i + 20 <= size; i += 20) {
+    guint64 time = GST_READ_UINT64_BE (data + i);
+
+    if ((GST_READ_UINT32_BE (data + i + 16) & 1) && time <= target
+        && time > keyframe)
+      keyframe = time;
+  }
+  fail_unless (keyframe > 24 * GST_SECOND && keyframe <= target);
+
+  fail_unless_equals_uint64 (seek_push_with_index (location, index, FALSE,
+          target), keyframe);
+  fail_unless_equals_uint64 (seek_push_with_index (location, index, TRUE,
+          target), keyframe);
+
+  g_bytes_unref (index);
+  g_unlink (location);
+  g_free (location);
+}
+
+GST_END_TEST;
+
 
 static Suite *
 flvdemux_suite (void)
@@ -666,6 +915,8 @@ flvdemux_suite (void)
   tcase_add_test (tc_chain, test_aac);
   tcase_add_test (tc_chain, test_h264);
   tcase_add_test (tc_chain, test_aac_not_support_rate_channels);
+  tcase_add_test (tc_chain, test_seek_index_property);
+  tcase_add_test (tc_chain, test_seek_index_push);
 
   return s;
 }
@@ -359,6 +359,50 @@ GST_START_TEST (test_speex_streamable)
 
 GST_END_TEST;
 
+GST_START_TEST (test_tag_bytes)
+{
+  GstHarness *h = gst_harness_new_with_padnames ("flvmux", "audio", "src");
+  const GstClockTime duration = 20 * GST_MSECOND;
+  /* tag header, speex codec byte, payload and previous tag size */
+  guint8 expected[11 + 1 + sizeof (speex_buf) + 4] = {
+    0x08, 0x00, 0x00, 1 + sizeof (speex_buf), 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0xb2
+  };
+  GstBuffer *buf;
+  gint i;
+
+  memcpy (expected + 12, speex_buf, sizeof (speex_buf));
+  GST_WRITE_UINT32_BE (expected + 12 + sizeof (speex_buf), 12 +
+      sizeof (speex_buf));
+
+  gst_harness_set_src_caps (h, gst_caps_new_simple ("audio/x-speex",
+          "rate", G_TYPE_INT, 16000, "channels", G_TYPE_INT, 1, NULL));
+  g_object_set (h->element, "streamable", 1, NULL);
+
+  for (i = 0; i < 2; i++)
+    gst_harness_push (h, create_buffer (speex_buf, sizeof (speex_buf),
+            i * duration, duration));
+
+  /* FLV header and metadata */
+  gst_buffer_unref (gst_harness_pull (h));
+  gst_buffer_unref (gst_harness_pull (h));
+
+  for (i = 0; i < 2; i++) {
+    /* the timestamp of the second tag is 20ms */
+    expected[6] = i * 20;
+
+    buf = gst_harness_pull (h);
+    fail_unless_equals_int (gst_buffer_get_size (buf), sizeof (expected));
+    fail_unless_equals_int (gst_buffer_memcmp (buf, 0, expected,
+            sizeof (expected)), 0);
+    gst_buffer_unref (buf);
+  }
+
+  gst_harness_teardown (h);
+}
+
+GST_END_TEST;
+
 static void
 check_buf_type_timestamp (GstBuffer * buf, gint packet_type, gint timestamp)
 {
@@ -1161,6 +1205,7 @@ flvmux_suite (void)
   tcase_add_loop_test (tc_chain, test_index_writing, 0, loop);
 
   tcase_add_test (tc_chain, test_speex_streamable);
+  tcase_add_test (tc_chain, test_tag_bytes);
   tcase_add_test (tc_chain, test_increasing_timestamp_when_pts_none);
   tcase_add_test (tc_chain, test_video_caps_late);
   tcase_add_test (tc_chain, test_audio_caps_change_streamable);
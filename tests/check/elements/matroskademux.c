@@ -17,6 +17,8 @@
  * Boston, MA 02110-1301, USA.
  */
 
+#include <glib/gstdio.h>
+
 #include <gst/check/gstcheck.h>
 #include <gst/check/gstharness.h>
 
@@ -307,6 +309,200 @@ GST_START_TEST (test_toc_demux)
 
 GST_END_TEST;
 
+GST_START_TEST (test_cluster_index_property)
+{
+  GstElement *demux;
+  GBytes *bytes, *out;
+  guint8 data[8 + 2 * 20];
+  gsize size;
+  const guint8 *out_data;
+
+  demux = gst_element_factory_make ("matroskademux", NULL);
+  fail_unless (demux != NULL);
+
+  /* empty index is just the header */
+  g_object_get (demux, "cluster-index", &out, NULL);
+  fail_unless (out != NULL);
+  fail_unless_equals_int (g_bytes_get_size (out), 8);
+  g_bytes_unref (out);
+
+  /* invalid data is ignored */
+  bytes = g_bytes_new_static ("garbage!", 8);
+  g_object_set (demux, "cluster-index", bytes, NULL);
+  g_bytes_unref (bytes);
+  g_object_get (demux, "cluster-index", &out, NULL);
+  fail_unless_equals_int (g_bytes_get_size (out), 8);
+  g_bytes_unref (out);
+
+  /* entries are sorted by offset when set */
+  GST_WRITE_UINT32_LE (data, GST_MAKE_FOURCC ('M', 'K', 'C', 'I'));
+  GST_WRITE_UINT32_BE (data + 4, 1);
+  GST_WRITE_UINT64_BE (data + 8, 2000);
+  GST_WRITE_UINT64_BE (data + 16, 2 * GST_SECOND);
+  GST_WRITE_UINT32_BE (data + 24, 0);
+  GST_WRITE_UINT64_BE (data + 28, 1000);
+  GST_WRITE_UINT64_BE (data + 36, 1 * GST_SECOND);
+  GST_WRITE_UINT32_BE (data + 44, 1);
+
+  bytes = g_bytes_new_static (data, sizeof (data));
+  g_object_set (demux, "cluster-index", bytes, NULL);
+  g_bytes_unref (bytes);
+
+  g_object_get (demux, "cluster-index", &out, NULL);
+  out_data = g_bytes_get_data (out, &size);
+  fail_unless_equals_int (size, sizeof (data));
+  fail_unless_equals_uint64 (GST_READ_UINT64_BE (out_data + 8), 1000);
+  fail_unless_equals_uint64 (GST_READ_UINT64_BE (out_data + 16), GST_SECOND);
+  fail_unless_equals_int (GST_READ_UINT32_BE (out_data + 24), 1);
+  fail_unless_equals_uint64 (GST_READ_UINT64_BE (out_data + 28), 2000);
+  fail_unless_equals_int (GST_READ_UINT32_BE (out_data + 44), 0);
+  g_bytes_unref (out);
+
+  gst_object_unref (demux);
+}
+
+GST_END_TEST;
+
+/* Writes 10 seconds of raw video at 10 fps without Cues, with every frame
+ * in its own cluster, and returns the file name */
+static gchar *
+write_cues_less_file (void)
+{
+  GstElement *pipeline;
+  GstMessage *msg;
+  gchar *location, *desc;
+
+  location = g_strdup_printf ("%s/%s-%d", g_get_tmp_dir (), "mkvdemuxtest",
+      g_random_int ());
+  desc = g_strdup_printf ("videotestsrc num-buffers=100 "
+      "! video/x-raw,format=GRAY8,width=160,height=120,framerate=10/1 "
+      "! matroskamux streamable=true min-cluster-duration=0 "
+      "! filesink location=%s", location);
+  pipeline = gst_parse_launch (desc, NULL);
+  fail_unless (pipeline != NULL);
+  g_free (desc);
+
+  fail_unless (gst_element_set_state (pipeline,
+          GST_STATE_PLAYING) != GST_STATE_CHANGE_FAILURE);
+  msg = gst_bus_timed_pop_filtered (GST_ELEMENT_BUS (pipeline),
+      GST_CLOCK_TIME_NONE, GST_MESSAGE_EOS | GST_MESSAGE_ERROR);
+  fail_unless (GST_MESSAGE_TYPE (msg) == GST_MESSAGE_EOS);
+  gst_message_unref (msg);
+  gst_element_set_state (pipeline, GST_STATE_NULL);
+  gst_object_unref (pipeline);
+
+  return location;
+}
+
+static GstPadProbeReturn
+count_pulls (GstPad * pad, GstPadProbeInfo * info, gpointer user_data)
+{
+  g_atomic_int_inc ((gint *) user_data);
+
+  return GST_PAD_PROBE_OK;
+}
+
+static void
+store_preroll_pts (GstElement * sink, GstBuffer * buf, GstPad * pad,
+    gpointer user_data)
+{
+  *(GstClockTime *) user_data = GST_BUFFER_PTS (buf);
+}
+
+/* Seeks to 4 seconds in @location, with @index set as cluster index if not
+ * NULL. Returns the number of buffers pulled by the demuxer for the seek and
+ * the timestamp of the first buffer after it in @landed. If @index_out is
+ * not NULL, plays the file to the end and returns the cluster index
+ * collected on the way */
+static gint
+seek_cues_less_file (const gchar * location, GBytes * index,
+    GstClockTime * landed, GBytes ** index_out)
+{
+  GstElement *pipeline, *demux, *sink;
+  GstPad *sinkpad;
+  GstMessage *msg;
+  gchar *desc;
+  gint pulls = 0, seek_pulls;
+
+  desc = g_strdup_printf ("filesrc location=%s ! matroskademux name=demux "
+      "! fakesink name=sink sync=false signal-handoffs=true", location);
+  pipeline = gst_parse_launch (desc, NULL);
+  fail_unless (pipeline != NULL);
+  g_free (desc);
+
+  demux = gst_bin_get_by_name (GST_BIN (pipeline), "demux");
+  sink = gst_bin_get_by_name (GST_BIN (pipeline), "sink");
+  if (index)
+    g_object_set (demux, "cluster-index", index, NULL);
+
+  fail_unless (gst_element_set_state (pipeline,
+          GST_STATE_PAUSED) != GST_STATE_CHANGE_FAILURE);
+  fail_unless_equals_int (gst_element_get_state (pipeline, NULL, NULL,
+          GST_CLOCK_TIME_NONE), GST_STATE_CHANGE_SUCCESS);
+
+  sinkpad = gst_element_get_static_pad (demux, "sink");
+  gst_pad_add_probe (sinkpad, GST_PAD_PROBE_TYPE_PULL |
+      GST_PAD_PROBE_TYPE_BUFFER, count_pulls, &pulls, NULL);
+  *landed = GST_CLOCK_TIME_NONE;
+  g_signal_connect (sink, "preroll-handoff", G_CALLBACK (store_preroll_pts),
+      landed);
+
+  fail_unless (gst_element_seek_simple (pipeline, GST_FORMAT_TIME,
+          GST_SEEK_FLAG_FLUSH, 4 * GST_SECOND));
+  fail_unless_equals_int (gst_element_get_state (pipeline, NULL, NULL,
+          GST_CLOCK_TIME_NONE), GST_STATE_CHANGE_SUCCESS);
+  seek_pulls = g_atomic_int_get (&pulls);
+  g_signal_handlers_disconnect_by_func (sink, store_preroll_pts, landed);
+
+  if (index_out) {
+    fail_unless (gst_element_set_state (pipeline,
+            GST_STATE_PLAYING) != GST_STATE_CHANGE_FAILURE);
+    msg = gst_bus_timed_pop_filtered (GST_ELEMENT_BUS (pipeline),
+        GST_CLOCK_TIME_NONE, GST_MESSAGE_EOS | GST_MESSAGE_ERROR);
+    fail_unless (GST_MESSAGE_TYPE (msg) == GST_MESSAGE_EOS);
+    gst_message_unref (msg);
+    g_object_get (demux, "cluster-index", index_out, NULL);
+  }
+
+  gst_element_set_state (pipeline, GST_STATE_NULL);
+  gst_object_unref (sinkpad);
+  gst_object_unref (sink);
+  gst_object_unref (demux);
+  gst_object_unref (pipeline);
+
+  return seek_pulls;
+}
+
+/* A seek in a file without Cues lands on the right frame, and needs less
+ * reading when the cluster index is known in advance */
+GST_START_TEST (test_cluster_index_seek)
+{
+  GBytes *index;
+  GstClockTime landed;
+  gchar *location;
+  gint fresh_pulls, indexed_pulls;
+
+  location = write_cues_less_file ();
+
+  fresh_pulls = seek_cues_less_file (location, NULL, &landed, &index);
+  fail_unless_equals_uint64 (landed, 4 * GST_SECOND);
+
+  /* The clusters were collected while playing to the end */
+  fail_unless (g_bytes_get_size (index) >= 8 + 50 * 20);
+
+  indexed_pulls = seek_cues_less_file (location, index, &landed, NULL);
+  fail_unless_equals_uint64 (landed, 4 * GST_SECOND);
+  GST_INFO ("seek pulled %d buffers without index, %d with index",
+      fresh_pulls, indexed_pulls);
+  fail_unless (indexed_pulls < fresh_pulls);
+
+  g_bytes_unref (index);
+  g_unlink (location);
+  g_free (location);
+}
+
+GST_END_TEST;
+
 static Suite *
 matroskademux_suite (void)
 {
@@ -316,6 +512,8 @@ matroskademux_suite (void)
   suite_add_tcase (s, tc_chain);
   tcase_add_test (tc_chain, test_sub_terminator);
   tcase_add_test (tc_chain, test_toc_demux);
+  tcase_add_test (tc_chain, test_cluster_index_property);
+  tcase_add_test (tc_chain, test_cluster_index_seek);
 
   return s;
 }
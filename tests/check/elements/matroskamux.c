@@ -351,6 +351,54 @@ GST_START_TEST (test_timecodescale)
 
 GST_END_TEST;
 
+static guint
+push_and_count_clusters (GstHarness * h, guint num_buffers)
+{
+  GstBuffer *inbuffer, *outbuffer;
+  guint8 cluster_id[] = { 0x1f, 0x43, 0xb6, 0x75 };
+  guint i, n_clusters = 0;
+
+  for (i = 0; i < num_buffers; i++) {
+    inbuffer = gst_harness_create_buffer (h, 100);
+    gst_buffer_memset (inbuffer, 0, 0x42, 100);
+    GST_BUFFER_TIMESTAMP (inbuffer) = i * 10 * GST_MSECOND;
+    fail_unless_equals_int (GST_FLOW_OK, gst_harness_push (h, inbuffer));
+
+    /* the block must be pushed downstream right away */
+    fail_unless (gst_harness_buffers_in_queue (h) > 0);
+
+    while ((outbuffer = gst_harness_try_pull (h))) {
+      if (gst_buffer_get_size (outbuffer) >= sizeof (cluster_id) &&
+          gst_buffer_memcmp (outbuffer, 0, cluster_id,
+              sizeof (cluster_id)) == 0)
+        n_clusters++;
+      gst_buffer_unref (outbuffer);
+    }
+  }
+
+  return n_clusters;
+}
+
+GST_START_TEST (test_max_cluster_size)
+{
+  GstHarness *h;
+
+  /* all buffers fit within min-cluster-duration: a single cluster */
+  h = setup_matroskamux_harness (AC3_CAPS_STRING);
+  g_object_set (h->element, "streamable", TRUE, NULL);
+  fail_unless_equals_int (push_and_count_clusters (h, 10), 1);
+  gst_harness_teardown (h);
+
+  /* a new cluster every three blocks or so */
+  h = setup_matroskamux_harness (AC3_CAPS_STRING);
+  g_object_set (h->element, "streamable", TRUE, "max-cluster-size",
+      (guint64) 250, NULL);
+  fail_unless (push_and_count_clusters (h, 10) >= 3);
+  gst_harness_teardown (h);
+}
+
+GST_END_TEST;
+
 /* Create a new chapter */
 static GstTocEntry *
 new_chapter (const guint chapter_nb, const gint64 start, const gint64 stop)
@@ -1012,6 +1060,7 @@ matroskamux_suite (void)
   tcase_add_loop_test (tc_chain, test_timecodescale,
       0, G_N_ELEMENTS (timecodescales));
 
+  tcase_add_test (tc_chain, test_max_cluster_size);
   tcase_add_test (tc_chain, test_toc_with_edition);
   tcase_add_test (tc_chain, test_toc_without_edition);
   return s;
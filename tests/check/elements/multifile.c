@@ -270,6 +270,150 @@ GST_START_TEST (test_multifilesink_key_unit)
 
 GST_END_TEST;
 
+GST_START_TEST (test_multifilesink_buffer_list)
+{
+  GstElement *mfs;
+  const gchar *tmpdir;
+  gchar *my_tmpdir;
+  gchar *template;
+  gchar *mfs_pattern;
+  gchar *filename;
+  gchar *contents;
+  gsize length;
+  GstBufferList *list;
+  GstBuffer *buf;
+  GstPad *sink;
+  GstSegment segment;
+  const gchar *parts[] = { "foo", "bar", "baz", "qux" };
+  guint i;
+
+  tmpdir = g_get_tmp_dir ();
+  template = g_build_filename (tmpdir, "multifile-test-XXXXXX", NULL);
+  my_tmpdir = g_mkdtemp (template);
+  fail_if (my_tmpdir == NULL);
+
+  mfs = gst_element_factory_make ("multifilesink", NULL);
+  fail_if (mfs == NULL);
+  mfs_pattern = g_build_filename (my_tmpdir, "%05d", NULL);
+  g_object_set (G_OBJECT (mfs), "location", mfs_pattern, "next-file", 3, NULL);
+  fail_if (gst_element_set_state (mfs,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_FAILURE);
+
+  sink = gst_element_get_static_pad (mfs, "sink");
+
+  gst_pad_send_event (sink, gst_event_new_stream_start ("test"));
+  gst_segment_init (&segment, GST_FORMAT_TIME);
+  gst_pad_send_event (sink, gst_event_new_segment (&segment));
+
+  /* Two buffers made up of two memories each, which all need to end up
+   * in the file in order */
+  list = gst_buffer_list_new ();
+  for (i = 0; i < G_N_ELEMENTS (parts); i += 2) {
+    buf = gst_buffer_new ();
+    gst_buffer_append_memory (buf,
+        gst_memory_new_wrapped (GST_MEMORY_FLAG_READONLY, (gpointer) parts[i],
+            3, 0, 3, NULL, NULL));
+    gst_buffer_append_memory (buf,
+        gst_memory_new_wrapped (GST_MEMORY_FLAG_READONLY,
+            (gpointer) parts[i + 1], 3, 0, 3, NULL, NULL));
+    gst_buffer_list_add (list, buf);
+  }
+  fail_unless_equals_int (gst_pad_chain_list (sink, list), GST_FLOW_OK);
+
+  gst_pad_send_event (sink, gst_event_new_eos ());
+
+  fail_if (gst_element_set_state (mfs,
+          GST_STATE_NULL) == GST_STATE_CHANGE_FAILURE);
+
+  filename = g_strdup_printf (mfs_pattern, 0);
+  fail_unless (g_file_get_contents (filename, &contents, &length, NULL));
+  fail_unless_equals_int (length, 12);
+  fail_unless (memcmp (contents, "foobarbazqux", 12) == 0);
+  g_free (contents);
+  fail_if (g_remove (filename) != 0);
+  g_free (filename);
+  fail_if (g_remove (my_tmpdir) != 0);
+
+  g_free (mfs_pattern);
+  g_free (my_tmpdir);
+  gst_object_unref (sink);
+  gst_object_unref (mfs);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_multifilesink_write_behind)
+{
+  GstElement *mfs;
+  const gchar *tmpdir;
+  gchar *my_tmpdir;
+  gchar *template;
+  gchar *mfs_pattern;
+  gchar *filename;
+  gchar *contents;
+  gsize length;
+  GstPad *sink;
+  GstSegment segment;
+  guint64 level;
+  guint i;
+
+  tmpdir = g_get_tmp_dir ();
+  template = g_build_filename (tmpdir, "multifile-test-XXXXXX", NULL);
+  my_tmpdir = g_mkdtemp (template);
+  fail_if (my_tmpdir == NULL);
+
+  mfs = gst_element_factory_make ("multifilesink", NULL);
+  fail_if (mfs == NULL);
+  mfs_pattern = g_build_filename (my_tmpdir, "%05d", NULL);
+  /* max-size mode with a small write-behind queue, so pushing has to wait
+   * for the background writer every few buffers */
+  g_object_set (G_OBJECT (mfs), "location", mfs_pattern, "next-file", 4,
+      "write-behind-size", (guint64) 32, NULL);
+  fail_if (gst_element_set_state (mfs,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_FAILURE);
+
+  sink = gst_element_get_static_pad (mfs, "sink");
+
+  gst_pad_send_event (sink, gst_event_new_stream_start ("test"));
+  gst_segment_init (&segment, GST_FORMAT_TIME);
+  gst_pad_send_event (sink, gst_event_new_segment (&segment));
+
+  for (i = 0; i < 100; i++) {
+    GstBuffer *buf = gst_buffer_new_allocate (NULL, 8, NULL);
+
+    gst_buffer_memset (buf, 0, '0' + i % 10, 8);
+    fail_unless_equals_int (gst_pad_chain (sink, buf), GST_FLOW_OK);
+
+    g_object_get (mfs, "write-behind-level", &level, NULL);
+    fail_unless (level <= 32);
+  }
+
+  gst_pad_send_event (sink, gst_event_new_eos ());
+
+  fail_if (gst_element_set_state (mfs,
+          GST_STATE_NULL) == GST_STATE_CHANGE_FAILURE);
+
+  g_object_get (mfs, "write-behind-level", &level, NULL);
+  fail_unless_equals_uint64 (level, 0);
+
+  filename = g_strdup_printf (mfs_pattern, 0);
+  fail_unless (g_file_get_contents (filename, &contents, &length, NULL));
+  fail_unless_equals_int (length, 800);
+  for (i = 0; i < 800; i++)
+    fail_unless_equals_int (contents[i], '0' + (i / 8) % 10);
+  g_free (contents);
+  fail_if (g_remove (filename) != 0);
+  g_free (filename);
+  fail_if (g_remove (my_tmpdir) != 0);
+
+  g_free (mfs_pattern);
+  g_free (my_tmpdir);
+  gst_object_unref (sink);
+  gst_object_unref (mfs);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_multifilesrc)
 {
   GstElement *pipeline;
@@ -376,6 +520,83 @@ GST_START_TEST (test_multifilesrc_stop_index)
 
 GST_END_TEST;
 
+/* files read ahead in the background still need to come out in order */
+GST_START_TEST (test_multifilesrc_read_ahead)
+{
+  GstElement *src;
+  GstEvent *event;
+  GstPad *sinkpad;
+  const gchar *tmpdir;
+  gchar *my_tmpdir;
+  gchar *template;
+  gchar *mfs_pattern;
+  GList *l;
+  gint i;
+
+  tmpdir = g_get_tmp_dir ();
+  template = g_build_filename (tmpdir, "multifile-test-XXXXXX", NULL);
+  my_tmpdir = g_mkdtemp (template);
+  fail_if (my_tmpdir == NULL);
+  mfs_pattern = g_build_filename (my_tmpdir, "%05d", NULL);
+
+  for (i = 0; i < 20; i++) {
+    gchar *fn = g_strdup_printf (mfs_pattern, i);
+    gchar *contents = g_strdup_printf ("file %d", i);
+
+    fail_unless (g_file_set_contents (fn, contents, -1, NULL));
+    g_free (contents);
+    g_free (fn);
+  }
+
+  src = gst_check_setup_element ("multifilesrc");
+  fail_unless (src != NULL);
+  g_object_set (src, "location", mfs_pattern, "read-ahead", 4, NULL);
+
+  sinkpad = gst_check_setup_sink_pad_by_name (src, &sinktemplate, "src");
+  fail_unless (sinkpad != NULL);
+  gst_pad_set_active (sinkpad, TRUE);
+
+  gst_element_set_state (src, GST_STATE_PLAYING);
+
+  gst_element_get_state (src, NULL, NULL, -1);
+
+  /* busy-loop for EOS */
+  do {
+    g_usleep (G_USEC_PER_SEC / 10);
+    event = gst_pad_get_sticky_event (sinkpad, GST_EVENT_EOS, 0);
+  } while (event == NULL);
+  gst_event_unref (event);
+
+  fail_unless_equals_int (g_list_length (buffers), 20);
+  for (l = buffers, i = 0; l; l = l->next, i++) {
+    gchar *expected = g_strdup_printf ("file %d", i);
+
+    fail_unless (gst_buffer_memcmp (l->data, 0, expected,
+            strlen (expected)) == 0);
+    fail_unless_equals_int (gst_buffer_get_size (l->data), strlen (expected));
+    g_free (expected);
+  }
+
+  gst_element_set_state (src, GST_STATE_NULL);
+
+  gst_check_drop_buffers ();
+  gst_check_teardown_pad_by_name (src, "src");
+  gst_check_teardown_element (src);
+
+  for (i = 0; i < 20; i++) {
+    gchar *fn = g_strdup_printf (mfs_pattern, i);
+
+    fail_if (g_remove (fn) != 0);
+    g_free (fn);
+  }
+  fail_if (g_remove (my_tmpdir) != 0);
+
+  g_free (mfs_pattern);
+  g_free (my_tmpdir);
+}
+
+GST_END_TEST;
+
 
 static Suite *
 multifile_suite (void)
@@ -388,8 +609,11 @@ multifile_suite (void)
   tcase_add_test (tc_chain, test_multifilesink_key_frame);
   tcase_add_test (tc_chain, test_multifilesink_max_files);
   tcase_add_test (tc_chain, test_multifilesink_key_unit);
+  tcase_add_test (tc_chain, test_multifilesink_buffer_list);
+  tcase_add_test (tc_chain, test_multifilesink_write_behind);
   tcase_add_test (tc_chain, test_multifilesrc);
   tcase_add_test (tc_chain, test_multifilesrc_stop_index);
+  tcase_add_test (tc_chain, test_multifilesrc_read_ahead);
 
   return s;
 }
@@ -0,0 +1,66 @@
+/* GStreamer
+ *
+ * helpers for testing elements that process frames on multiple threads
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <gst/check/gstcheck.h>
+#include "elements/nthreads.h"
+
+void
+assert_buffers_equal (GstBuffer * buf1, GstBuffer * buf2, const gchar * what)
+{
+  GstMapInfo map;
+
+  gst_buffer_map (buf1, &map, GST_MAP_READ);
+  fail_unless_equals_int (gst_buffer_get_size (buf2), map.size);
+  fail_unless (gst_buffer_memcmp (buf2, 0, map.data, map.size) == 0,
+      "different output for %s", what);
+  gst_buffer_unmap (buf1, &map);
+}
+
+void
+assert_buffer_lists_equal (GList * list1, GList * list2, const gchar * what)
+{
+  GList *l1, *l2;
+
+  fail_unless_equals_int (g_list_length (list1), g_list_length (list2));
+
+  for (l1 = list1, l2 = list2; l1; l1 = l1->next, l2 = l2->next)
+    assert_buffers_equal (l1->data, l2->data, what);
+}
+
+/* Runs @func with one and with @n_threads threads and checks that both
+ * give the same output. Returns the output of the single threaded run,
+ * which the caller can check further and must free */
+GList *
+check_n_threads_output (NThreadsRunFunc func, gpointer user_data,
+    guint n_threads, const gchar * what)
+{
+  GList *single, *multi;
+
+  single = func (1, user_data);
+  multi = func (n_threads, user_data);
+
+  GST_INFO ("%s: %u buffers", what, g_list_length (single));
+  fail_unless (single != NULL, "no output for %s", what);
+  assert_buffer_lists_equal (single, multi, what);
+
+  g_list_free_full (multi, (GDestroyNotify) gst_buffer_unref);
+
+  return single;
+}
@@ -0,0 +1,33 @@
+/* GStreamer
+ *
+ * helpers for testing elements that process frames on multiple threads
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <gst/check/gstcheck.h>
+
+/* Returns the list of output buffers of a run with @n_threads */
+typedef GList * (*NThreadsRunFunc) (guint n_threads, gpointer user_data);
+
+void assert_buffers_equal (GstBuffer * buf1, GstBuffer * buf2,
+    const gchar * what);
+
+void assert_buffer_lists_equal (GList * list1, GList * list2,
+    const gchar * what);
+
+GList * check_n_threads_output (NThreadsRunFunc func, gpointer user_data,
+    guint n_threads, const gchar * what);
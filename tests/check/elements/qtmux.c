@@ -1635,6 +1635,199 @@ GST_START_TEST (test_muxing_initial_gap)
 
 GST_END_TEST;
 
+#define FOURCC_moov GST_MAKE_FOURCC ('m', 'o', 'o', 'v')
+#define FOURCC_mdat GST_MAKE_FOURCC ('m', 'd', 'a', 't')
+
+#define FOURCC_moof GST_MAKE_FOURCC ('m', 'o', 'o', 'f')
+
+/* Runs a short raw video recording through qtmux into a file and returns
+ * the fourccs of the top-level atoms in the order they appear */
+static GList *
+run_atom_order_test (const gchar * format, const gchar * mux_props)
+{
+  GstElement *pipeline;
+  GstMessage *msg;
+  gchar *location, *desc, *data;
+  gsize len, pos;
+  GList *atoms = NULL;
+
+  location = g_strdup_printf ("%s/%s-%d", g_get_tmp_dir (), "qtmuxtest",
+      g_random_int ());
+  desc = g_strdup_printf ("videotestsrc num-buffers=30 ! "
+      "video/x-raw,format=%s,width=64,height=48,framerate=30/1 ! "
+      "qtmux %s ! filesink location=%s", format, mux_props, location);
+  pipeline = gst_parse_launch (desc, NULL);
+  fail_unless (pipeline != NULL);
+  g_free (desc);
+
+  fail_unless (gst_element_set_state (pipeline,
+          GST_STATE_PLAYING) != GST_STATE_CHANGE_FAILURE);
+  msg = gst_bus_timed_pop_filtered (GST_ELEMENT_BUS (pipeline),
+      GST_CLOCK_TIME_NONE, GST_MESSAGE_EOS | GST_MESSAGE_ERROR);
+  fail_unless (GST_MESSAGE_TYPE (msg) == GST_MESSAGE_EOS);
+  gst_message_unref (msg);
+  gst_element_set_state (pipeline, GST_STATE_NULL);
+  gst_object_unref (pipeline);
+
+  fail_unless (g_file_get_contents (location, &data, &len, NULL));
+  for (pos = 0; pos + 8 <= len;) {
+    guint64 size = GST_READ_UINT32_BE (data + pos);
+    guint32 fourcc = GST_READ_UINT32_LE (data + pos + 4);
+
+    if (size == 1) {
+      fail_unless (pos + 16 <= len);
+      size = GST_READ_UINT64_BE (data + pos + 8);
+    }
+    fail_unless (size >= 8);
+    atoms = g_list_append (atoms, GUINT_TO_POINTER (fourcc));
+    pos += size;
+  }
+  fail_unless_equals_int (pos, len);
+
+  g_free (data);
+  g_unlink (location);
+  g_free (location);
+
+  return atoms;
+}
+
+GST_START_TEST (test_faststart_reserved)
+{
+  GList *atoms, *moov, *mdat;
+
+  /* Enough space reserved: moov written in place in front of the mdat */
+  atoms = run_atom_order_test ("RGB",
+      "faststart=true reserved-max-duration=10000000000");
+  moov = g_list_find (atoms, GUINT_TO_POINTER (FOURCC_moov));
+  mdat = g_list_find (atoms, GUINT_TO_POINTER (FOURCC_mdat));
+  fail_unless (moov != NULL);
+  fail_unless (mdat != NULL);
+  fail_unless (g_list_position (atoms, moov) < g_list_position (atoms, mdat));
+  g_list_free (atoms);
+
+  /* Not enough space reserved: moov ends up after the mdat instead */
+  atoms = run_atom_order_test ("RGB", "faststart=true "
+      "reserved-max-duration=1 reserved-bytes-per-sec=0");
+  moov = g_list_find (atoms, GUINT_TO_POINTER (FOURCC_moov));
+  mdat = g_list_find (atoms, GUINT_TO_POINTER (FOURCC_mdat));
+  fail_unless (moov != NULL);
+  fail_unless (mdat != NULL);
+  fail_unless (g_list_position (atoms, moov) > g_list_position (atoms, mdat));
+  g_list_free (atoms);
+}
+
+GST_END_TEST;
+
+static GstPadProbeReturn
+record_remaining (GstPad * pad, GstPadProbeInfo * info, gpointer user_data)
+{
+  GstElement *mux = g_object_get_data (G_OBJECT (pad), "mux");
+  GArray *remaining = user_data;
+  guint64 value;
+
+  g_object_get (mux, "reserved-duration-remaining", &value, NULL);
+  g_array_append_val (remaining, value);
+
+  return GST_PAD_PROBE_OK;
+}
+
+/* The remaining reserved duration counts down while muxing in faststart mode
+ * with reserved space, as in robust muxing mode */
+GST_START_TEST (test_faststart_reserved_remaining)
+{
+  GstElement *pipeline, *mux, *src;
+  GstPad *srcpad;
+  GstMessage *msg;
+  GArray *remaining;
+  gchar *location, *desc;
+  guint i;
+
+  location = g_strdup_printf ("%s/%s-%d", g_get_tmp_dir (), "qtmuxtest",
+      g_random_int ());
+  desc = g_strdup_printf ("videotestsrc name=src num-buffers=60 ! "
+      "video/x-raw,format=RGB,width=64,height=48,framerate=30/1 ! "
+      "qtmux name=mux faststart=true reserved-max-duration=10000000000 ! "
+      "filesink location=%s", location);
+  pipeline = gst_parse_launch (desc, NULL);
+  fail_unless (pipeline != NULL);
+  g_free (desc);
+
+  mux = gst_bin_get_by_name (GST_BIN (pipeline), "mux");
+  src = gst_bin_get_by_name (GST_BIN (pipeline), "src");
+  srcpad = gst_element_get_static_pad (src, "src");
+  remaining = g_array_new (FALSE, FALSE, sizeof (guint64));
+  g_object_set_data (G_OBJECT (srcpad), "mux", mux);
+  gst_pad_add_probe (srcpad, GST_PAD_PROBE_TYPE_BUFFER, record_remaining,
+      remaining, NULL);
+
+  fail_unless (gst_element_set_state (pipeline,
+          GST_STATE_PLAYING) != GST_STATE_CHANGE_FAILURE);
+  msg = gst_bus_timed_pop_filtered (GST_ELEMENT_BUS (pipeline),
+      GST_CLOCK_TIME_NONE, GST_MESSAGE_EOS | GST_MESSAGE_ERROR);
+  fail_unless (GST_MESSAGE_TYPE (msg) == GST_MESSAGE_EOS);
+  gst_message_unref (msg);
+  gst_element_set_state (pipeline, GST_STATE_NULL);
+
+  fail_unless_equals_int (remaining->len, 60);
+  for (i = 1; i < remaining->len; i++)
+    fail_unless (g_array_index (remaining, guint64, i) <=
+        g_array_index (remaining, guint64, i - 1));
+  /* Almost two seconds were muxed before the last buffer */
+  fail_unless (g_array_index (remaining, guint64, 0) -
+      g_array_index (remaining, guint64, remaining->len - 1) >=
+      (guint64) 1500 * GST_MSECOND);
+
+  g_array_unref (remaining);
+  gst_object_unref (srcpad);
+  gst_object_unref (src);
+  gst_object_unref (mux);
+  gst_object_unref (pipeline);
+  g_unlink (location);
+  g_free (location);
+}
+
+GST_END_TEST;
+
+static guint
+count_atoms (GList * atoms, guint32 fourcc)
+{
+  guint n = 0;
+
+  for (; atoms; atoms = atoms->next) {
+    if (GPOINTER_TO_UINT (atoms->data) == fourcc)
+      n++;
+  }
+
+  return n;
+}
+
+GST_START_TEST (test_fragment_chunks)
+{
+  GList *atoms;
+  guint n_fragments, n_chunks;
+
+  /* 1s of video in 500ms fragments, without and with 100ms chunks.
+   * Raw video samples are all sync samples, and for UYVY qtmux doesn't
+   * start a new fragment at every one of them, so fragments and chunks
+   * are only cut by duration */
+  atoms = run_atom_order_test ("UYVY", "fragment-duration=500");
+  n_fragments = count_atoms (atoms, FOURCC_moof);
+  fail_unless_equals_int (count_atoms (atoms, FOURCC_mdat), n_fragments);
+  g_list_free (atoms);
+
+  atoms = run_atom_order_test ("UYVY",
+      "fragment-duration=500 chunk-duration=100");
+  n_chunks = count_atoms (atoms, FOURCC_moof);
+  fail_unless_equals_int (count_atoms (atoms, FOURCC_mdat), n_chunks);
+  g_list_free (atoms);
+
+  GST_DEBUG ("%u fragments, %u chunks", n_fragments, n_chunks);
+  fail_unless (n_fragments >= 2);
+  fail_unless (n_chunks > 2 * n_fragments);
+}
+
+GST_END_TEST;
+
 static Suite *
 qtmux_suite (void)
 {
@@ -1678,6 +1871,10 @@ qtmux_suite (void)
   tcase_add_test (tc_chain, test_muxing_dts_outside_segment);
   tcase_add_test (tc_chain, test_muxing_initial_gap);
 
+  tcase_add_test (tc_chain, test_faststart_reserved);
+  tcase_add_test (tc_chain, test_faststart_reserved_remaining);
+  tcase_add_test (tc_chain, test_fragment_chunks);
+
   return s;
 }
 
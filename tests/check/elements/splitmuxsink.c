@@ -422,41 +422,148 @@ GST_START_TEST (test_splitmuxsink_multivid)
 
 GST_END_TEST;
 
-GST_START_TEST (test_splitmuxsink_async)
+/* Which sinks were created, which were used for each fragment, and the
+ * threads involved, to tell prepared sinks from ones created at the split */
+typedef struct
+{
+  GMutex lock;
+  GPtrArray *added;
+  GPtrArray *added_threads;
+  GPtrArray *opened;
+  GPtrArray *location_threads;
+} FragmentSinks;
+
+static void
+fragment_sink_added (GstElement * splitmux, GstElement * sink,
+    FragmentSinks * sinks)
+{
+  g_mutex_lock (&sinks->lock);
+  g_ptr_array_add (sinks->added, gst_object_ref (sink));
+  g_ptr_array_add (sinks->added_threads, g_thread_self ());
+  g_mutex_unlock (&sinks->lock);
+}
+
+static gchar *
+fragment_format_location (GstElement * splitmux, guint fragment_id,
+    GstSample * first_sample, FragmentSinks * sinks)
+{
+  g_mutex_lock (&sinks->lock);
+  g_ptr_array_add (sinks->location_threads, g_thread_self ());
+  g_mutex_unlock (&sinks->lock);
+
+  return NULL;
+}
+
+static GstBusSyncReply
+fragment_opened_cb (GstBus * bus, GstMessage * msg, FragmentSinks * sinks)
+{
+  const GstStructure *s;
+
+  if (GST_MESSAGE_TYPE (msg) != GST_MESSAGE_ELEMENT)
+    return GST_BUS_PASS;
+
+  s = gst_message_get_structure (msg);
+  if (gst_structure_has_name (s, "splitmuxsink-fragment-opened")) {
+    GstElement *sink = NULL;
+
+    gst_structure_get (s, "sink", GST_TYPE_ELEMENT, &sink, NULL);
+    fail_unless (sink != NULL);
+    g_mutex_lock (&sinks->lock);
+    g_ptr_array_add (sinks->opened, sink);
+    g_mutex_unlock (&sinks->lock);
+  }
+
+  return GST_BUS_PASS;
+}
+
+static void
+run_splitmuxsink_async (gboolean prepare_next)
 {
   GstMessage *msg;
   GstElement *pipeline;
   GstElement *sink;
   GstPad *splitmux_sink_pad;
   GstPad *enc_src_pad;
+  GstBus *bus;
   gchar *dest_pattern;
-  guint count;
+  guint count, i;
   gchar *in_pattern;
+  gchar *desc;
+  FragmentSinks sinks;
 
-  pipeline =
-      gst_parse_launch
-      ("videotestsrc num-buffers=15 ! video/x-raw,width=80,height=64,framerate=5/1 ! videoconvert !"
+  /* live sources leave the prepared elements a whole fragment of time to
+   * be created in the background */
+  desc = g_strdup_printf
+      ("videotestsrc num-buffers=15 is-live=%d ! video/x-raw,width=80,height=64,framerate=5/1 ! videoconvert !"
       " queue ! theoraenc keyframe-force=5 ! splitmuxsink name=splitsink "
       " max-size-time=1000000000 async-finalize=true "
-      " muxer-factory=matroskamux audiotestsrc num-buffers=15 samplesperbuffer=9600 ! "
-      " audio/x-raw,rate=48000 ! splitsink.audio_%u", NULL);
+      " muxer-factory=matroskamux audiotestsrc num-buffers=15 samplesperbuffer=9600 is-live=%d ! "
+      " audio/x-raw,rate=48000 ! splitsink.audio_%%u", prepare_next,
+      prepare_next);
+  pipeline = gst_parse_launch (desc, NULL);
+  g_free (desc);
   fail_if (pipeline == NULL);
   sink = gst_bin_get_by_name (GST_BIN (pipeline), "splitsink");
   fail_if (sink == NULL);
   g_signal_connect (sink, "format-location-full",
       (GCallback) check_format_location, NULL);
   dest_pattern = g_build_filename (tmpdir, "matroska%05d.mkv", NULL);
-  g_object_set (G_OBJECT (sink), "location", dest_pattern, NULL);
+  g_object_set (G_OBJECT (sink), "location", dest_pattern,
+      "prepare-next-fragment", prepare_next, NULL);
   g_free (dest_pattern);
+
+  g_mutex_init (&sinks.lock);
+  sinks.added = g_ptr_array_new_with_free_func (gst_object_unref);
+  sinks.added_threads = g_ptr_array_new ();
+  sinks.opened = g_ptr_array_new_with_free_func (gst_object_unref);
+  sinks.location_threads = g_ptr_array_new ();
+  g_signal_connect (sink, "sink-added", (GCallback) fragment_sink_added,
+      &sinks);
+  g_signal_connect (sink, "format-location-full",
+      (GCallback) fragment_format_location, &sinks);
   g_object_unref (sink);
 
+  bus = gst_element_get_bus (pipeline);
+  gst_bus_set_sync_handler (bus, (GstBusSyncHandler) fragment_opened_cb,
+      &sinks, NULL);
+
   msg = run_pipeline (pipeline);
 
+  gst_bus_set_sync_handler (bus, NULL, NULL, NULL);
+  gst_object_unref (bus);
+
   if (GST_MESSAGE_TYPE (msg) == GST_MESSAGE_ERROR)
     dump_error (msg);
   fail_unless (GST_MESSAGE_TYPE (msg) == GST_MESSAGE_EOS);
   gst_message_unref (msg);
 
+  /* With prepare-next-fragment, every fragment after the first must be
+   * written by the sink that was prepared for it in the background, not by
+   * one created at the split */
+  fail_unless_equals_int (sinks.opened->len, 3);
+  fail_unless_equals_int (sinks.location_threads->len, 3);
+  fail_unless (sinks.added->len >= 3);
+  fail_unless (g_ptr_array_index (sinks.opened, 0) ==
+      g_ptr_array_index (sinks.added, 0));
+  for (i = 1; i < sinks.opened->len; i++) {
+    GstElement *used = g_ptr_array_index (sinks.opened, i);
+    GstElement *created = g_ptr_array_index (sinks.added, i);
+    gboolean at_split = g_ptr_array_index (sinks.added_threads, i) ==
+        g_ptr_array_index (sinks.location_threads, i);
+
+    fail_unless (used == created, "fragment %u used %s instead of %s", i,
+        GST_OBJECT_NAME (used), GST_OBJECT_NAME (created));
+    fail_unless (at_split == !prepare_next,
+        "sink %s for fragment %u was %s at the split", GST_OBJECT_NAME (used),
+        i, at_split ? "created" : "not created");
+  }
+
+  g_ptr_array_unref (sinks.added);
+  g_ptr_array_unref (sinks.added_threads);
+  g_ptr_array_unref (sinks.opened);
+  g_ptr_array_unref (sinks.location_threads);
+  g_mutex_clear (&sinks.lock);
+
   /* unlink manually and release request pad to ensure that we *can* do that
    * - https://bugzilla.gnome.org/show_bug.cgi?id=753622 */
   sink = gst_bin_get_by_name (GST_BIN (pipeline), "splitsink");
@@ -484,6 +591,18 @@ GST_START_TEST (test_splitmuxsink_async)
   g_free (in_pattern);
 }
 
+GST_START_TEST (test_splitmuxsink_async)
+{
+  run_splitmuxsink_async (FALSE);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_splitmuxsink_async_prepare_next)
+{
+  run_splitmuxsink_async (TRUE);
+}
+
 GST_END_TEST;
 
 /* For verifying bug https://bugzilla.gnome.org/show_bug.cgi?id=762893 */
@@ -747,6 +866,7 @@ splitmuxsink_suite (void)
           tempdir_cleanup);
 
       tcase_add_test (tc_chain, test_splitmuxsink_async);
+      tcase_add_test (tc_chain, test_splitmuxsink_async_prepare_next);
     } else {
       GST_INFO ("Skipping tests, missing plugins: matroska and/or vorbis");
     }
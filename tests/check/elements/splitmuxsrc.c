@@ -331,6 +331,159 @@ GST_START_TEST (test_splitmuxsrc_format_location)
 
 GST_END_TEST;
 
+GST_START_TEST (test_splitmuxsrc_num_open_fragments)
+{
+  GstMessage *msg;
+  GstElement *pipeline;
+  GstElement *src;
+  GError *error = NULL;
+  guint num_open;
+
+  pipeline = gst_parse_launch ("splitmuxsrc name=splitsrc "
+      "num-open-fragments=1 ! decodebin ! fakesink", &error);
+  g_assert_no_error (error);
+  fail_if (pipeline == NULL);
+
+  src = gst_bin_get_by_name (GST_BIN (pipeline), "splitsrc");
+  g_object_get (src, "num-open-fragments", &num_open, NULL);
+  fail_unless_equals_int (num_open, 1);
+  g_signal_connect (src, "format-location",
+      (GCallback) src_format_location_cb, NULL);
+  g_object_unref (src);
+
+  /* All parts need to be reopened one after the other to get to EOS */
+  msg = run_pipeline (pipeline);
+
+  if (GST_MESSAGE_TYPE (msg) == GST_MESSAGE_ERROR)
+    dump_error (msg);
+  fail_unless (GST_MESSAGE_TYPE (msg) == GST_MESSAGE_EOS);
+  gst_message_unref (msg);
+  gst_object_unref (pipeline);
+}
+
+GST_END_TEST;
+
+#ifdef __linux__
+/* Count the test files that are currently open, one per prepared part.
+ * If @name is given, it must be one of them */
+static guint
+count_open_parts (const gchar * name, gboolean * found)
+{
+  GDir *d;
+  const gchar *f;
+  guint ret = 0;
+
+  *found = FALSE;
+
+  d = g_dir_open ("/proc/self/fd", 0, NULL);
+  fail_if (d == NULL);
+
+  while ((f = g_dir_read_name (d)) != NULL) {
+    gchar *fname = g_build_filename ("/proc/self/fd", f, NULL);
+    gchar *target = g_file_read_link (fname, NULL);
+
+    if (target != NULL) {
+      gchar *basename = g_path_get_basename (target);
+
+      if (g_str_has_prefix (basename, "splitvideo")) {
+        ret++;
+        if (name && g_str_equal (basename, name))
+          *found = TRUE;
+      }
+      g_free (basename);
+    }
+    g_free (target);
+    g_free (fname);
+  }
+  g_dir_close (d);
+
+  return ret;
+}
+
+/* Parts are closed asynchronously, wait for that to settle */
+static void
+check_open_parts (guint max_open, const gchar * name)
+{
+  gboolean found = FALSE;
+  guint n_open = 0;
+  gint i;
+
+  for (i = 0; i < 500; i++) {
+    n_open = count_open_parts (name, &found);
+    if (n_open <= max_open && (name == NULL || found))
+      break;
+    g_usleep (10 * 1000);
+  }
+
+  fail_unless (n_open <= max_open, "%u parts open, expected at most %u",
+      n_open, max_open);
+  if (name)
+    fail_unless (found, "%s is not open", name);
+}
+
+static void
+seek_and_check_open_parts (GstElement * pipeline, GstClockTime position,
+    const gchar * name)
+{
+  fail_unless (gst_element_seek_simple (pipeline, GST_FORMAT_TIME,
+          GST_SEEK_FLAG_FLUSH | GST_SEEK_FLAG_ACCURATE, position));
+  fail_unless_equals_int (gst_element_get_state (pipeline, NULL, NULL,
+          GST_CLOCK_TIME_NONE), GST_STATE_CHANGE_SUCCESS);
+  check_open_parts (1, name);
+}
+
+GST_START_TEST (test_splitmuxsrc_num_open_fragments_seek)
+{
+  GstElement *pipeline;
+  GstElement *src;
+  GstBus *bus;
+  GstMessage *msg;
+  GError *error = NULL;
+
+  pipeline = gst_parse_launch ("splitmuxsrc name=splitsrc "
+      "num-open-fragments=1 ! decodebin ! fakesink sync=true", &error);
+  g_assert_no_error (error);
+  fail_if (pipeline == NULL);
+
+  src = gst_bin_get_by_name (GST_BIN (pipeline), "splitsrc");
+  g_signal_connect (src, "format-location",
+      (GCallback) src_format_location_cb, NULL);
+  g_object_unref (src);
+
+  gst_element_set_state (pipeline, GST_STATE_PAUSED);
+  fail_unless_equals_int (gst_element_get_state (pipeline, NULL, NULL,
+          GST_CLOCK_TIME_NONE), GST_STATE_CHANGE_SUCCESS);
+  check_open_parts (1, "splitvideo00.ogg");
+
+  /* Seeking into parts that were closed reopens them and closes the
+   * previous one */
+  seek_and_check_open_parts (pipeline, 2500 * GST_MSECOND,
+      "splitvideo02.ogg");
+  seek_and_check_open_parts (pipeline, 500 * GST_MSECOND, "splitvideo00.ogg");
+
+  /* Play to the end, moving through all parts */
+  bus = gst_element_get_bus (pipeline);
+  gst_element_set_state (pipeline, GST_STATE_PLAYING);
+  while (TRUE) {
+    msg = gst_bus_timed_pop_filtered (bus, 100 * GST_MSECOND,
+        GST_MESSAGE_EOS | GST_MESSAGE_ERROR);
+    if (msg)
+      break;
+    check_open_parts (1, NULL);
+  }
+  gst_element_set_state (pipeline, GST_STATE_NULL);
+
+  if (GST_MESSAGE_TYPE (msg) == GST_MESSAGE_ERROR)
+    dump_error (msg);
+  fail_unless (GST_MESSAGE_TYPE (msg) == GST_MESSAGE_EOS);
+  gst_message_unref (msg);
+  gst_object_unref (bus);
+  gst_object_unref (pipeline);
+}
+
+GST_END_TEST;
+#endif
+
 static gchar *
 check_format_location (GstElement * object,
     guint fragment_id, GstSample * first_sample)
@@ -707,6 +860,10 @@ splitmuxsrc_suite (void)
 
     tcase_add_test (tc_chain, test_splitmuxsrc);
     tcase_add_test (tc_chain, test_splitmuxsrc_format_location);
+    tcase_add_test (tc_chain, test_splitmuxsrc_num_open_fragments);
+#ifdef __linux__
+    tcase_add_test (tc_chain, test_splitmuxsrc_num_open_fragments_seek);
+#endif
 
     if (have_matroska && have_vorbis) {
       tcase_add_checked_fixture (tc_chain_complex, tempdir_setup,
@@ -24,6 +24,8 @@
 #endif
 
 #include <gst/check/gstcheck.h>
+#include <gst/check/gstharness.h>
+#include <gst/video/video.h>
 
 typedef struct _GstVideoBoxTestContext
 {
@@ -206,6 +208,152 @@ GST_START_TEST (test_caps_transform)
 
 GST_END_TEST;
 
+/* Crops 8 pixels left and right and 10 lines at the top and bottom of an
+ * I420 64x48 frame and returns the output buffer and, in @input, the
+ * buffer that was pushed */
+static GstBuffer *
+crop_frame (gboolean downstream_crop_meta, GstBuffer ** input)
+{
+  GstHarness *h;
+  GstBuffer *in, *out;
+  GstVideoInfo info;
+
+  h = gst_harness_new ("videobox");
+  g_object_set (h->element, "left", 8, "right", 8, "top", 10, "bottom", 10,
+      NULL);
+  if (downstream_crop_meta) {
+    gst_harness_add_propose_allocation_meta (h, GST_VIDEO_META_API_TYPE,
+        NULL);
+    gst_harness_add_propose_allocation_meta (h, GST_VIDEO_CROP_META_API_TYPE,
+        NULL);
+  }
+  gst_harness_set_caps_str (h,
+      "video/x-raw,format=I420,width=64,height=48,framerate=25/1",
+      "video/x-raw,format=I420,width=48,height=28,framerate=25/1");
+
+  gst_video_info_set_format (&info, GST_VIDEO_FORMAT_I420, 64, 48);
+  in = gst_harness_create_buffer (h, GST_VIDEO_INFO_SIZE (&info));
+  gst_buffer_memset (in, 0, 0x80, GST_VIDEO_INFO_SIZE (&info));
+  *input = gst_buffer_ref (in);
+
+  fail_unless_equals_int (gst_harness_push (h, in), GST_FLOW_OK);
+  out = gst_harness_pull (h);
+  fail_unless (out != NULL);
+
+  gst_harness_teardown (h);
+
+  return out;
+}
+
+GST_START_TEST (test_crop_meta)
+{
+  GstBuffer *in, *out;
+  GstVideoCropMeta *crop_meta;
+  GstVideoMeta *video_meta;
+
+  /* Downstream handles crop meta, so the pixels are not touched */
+  out = crop_frame (TRUE, &in);
+  fail_unless (gst_buffer_peek_memory (out, 0) ==
+      gst_buffer_peek_memory (in, 0));
+
+  video_meta = gst_buffer_get_video_meta (out);
+  fail_unless (video_meta != NULL);
+  fail_unless_equals_int (video_meta->width, 64);
+  fail_unless_equals_int (video_meta->height, 48);
+
+  crop_meta = gst_buffer_get_video_crop_meta (out);
+  fail_unless (crop_meta != NULL);
+  fail_unless_equals_int (crop_meta->x, 8);
+  fail_unless_equals_int (crop_meta->y, 10);
+  fail_unless_equals_int (crop_meta->width, 48);
+  fail_unless_equals_int (crop_meta->height, 28);
+
+  gst_buffer_unref (in);
+  gst_buffer_unref (out);
+
+  /* Otherwise the cropped frame is copied */
+  out = crop_frame (FALSE, &in);
+  fail_unless (gst_buffer_get_video_crop_meta (out) == NULL);
+  fail_unless (gst_buffer_peek_memory (out, 0) !=
+      gst_buffer_peek_memory (in, 0));
+
+  gst_buffer_unref (in);
+  gst_buffer_unref (out);
+}
+
+GST_END_TEST;
+
+/* Pushes a grey I420 64x48 frame and returns the output buffer */
+static GstBuffer *
+push_grey_frame (GstHarness * h)
+{
+  GstVideoInfo info;
+  GstBuffer *in, *out;
+
+  gst_video_info_set_format (&info, GST_VIDEO_FORMAT_I420, 64, 48);
+  in = gst_harness_create_buffer (h, GST_VIDEO_INFO_SIZE (&info));
+  gst_buffer_memset (in, 0, 0x80, GST_VIDEO_INFO_SIZE (&info));
+
+  fail_unless_equals_int (gst_harness_push (h, in), GST_FLOW_OK);
+  out = gst_harness_pull (h);
+  fail_unless (out != NULL);
+
+  return out;
+}
+
+/* Adding a border while running must leave the crop meta mode again */
+GST_START_TEST (test_crop_meta_to_border)
+{
+  GstHarness *h;
+  GstBuffer *out;
+  GstCaps *caps;
+  GstVideoInfo info;
+  GstVideoFrame frame;
+  GstVideoCropMeta *crop_meta;
+  gint x, y;
+
+  h = gst_harness_new ("videobox");
+  g_object_set (h->element, "left", 8, NULL);
+  gst_harness_add_propose_allocation_meta (h, GST_VIDEO_META_API_TYPE, NULL);
+  gst_harness_add_propose_allocation_meta (h, GST_VIDEO_CROP_META_API_TYPE,
+      NULL);
+  gst_harness_set_src_caps_str (h,
+      "video/x-raw,format=I420,width=64,height=48,framerate=25/1");
+
+  out = push_grey_frame (h);
+  crop_meta = gst_buffer_get_video_crop_meta (out);
+  fail_unless (crop_meta != NULL);
+  fail_unless_equals_int (crop_meta->x, 8);
+  fail_unless_equals_int (crop_meta->width, 56);
+  fail_unless_equals_int (crop_meta->height, 48);
+  gst_buffer_unref (out);
+
+  g_object_set (h->element, "left", -8, NULL);
+  out = push_grey_frame (h);
+  fail_unless (gst_buffer_get_video_crop_meta (out) == NULL);
+
+  caps = gst_pad_get_current_caps (h->sinkpad);
+  fail_unless (gst_video_info_from_caps (&info, caps));
+  gst_caps_unref (caps);
+  fail_unless_equals_int (GST_VIDEO_INFO_WIDTH (&info), 72);
+  fail_unless_equals_int (GST_VIDEO_INFO_HEIGHT (&info), 48);
+
+  /* A black border on the left of the grey frame */
+  fail_unless (gst_video_frame_map (&frame, &info, out, GST_MAP_READ));
+  for (y = 0; y < 48; y++) {
+    const guint8 *line = (const guint8 *) GST_VIDEO_FRAME_COMP_DATA (&frame,
+        0) + y * GST_VIDEO_FRAME_COMP_STRIDE (&frame, 0);
+
+    for (x = 0; x < 72; x++)
+      fail_unless_equals_int (line[x], x < 8 ? 16 : 0x80);
+  }
+  gst_video_frame_unmap (&frame);
+  gst_buffer_unref (out);
+
+  gst_harness_teardown (h);
+}
+
+GST_END_TEST;
 
 static Suite *
 videobox_suite (void)
@@ -215,6 +363,8 @@ videobox_suite (void)
 
   suite_add_tcase (s, tc_chain);
   tcase_add_test (tc_chain, test_caps_transform);
+  tcase_add_test (tc_chain, test_crop_meta);
+  tcase_add_test (tc_chain, test_crop_meta_to_border);
 
   return s;
 }
@@ -21,9 +21,13 @@
  */
 
 #include <stdarg.h>
+#include <stdlib.h>
 
 #include <gst/video/video.h>
 #include <gst/check/gstcheck.h>
+#include <gst/check/gstharness.h>
+
+#include "nthreads.h"
 
 gboolean have_eos = FALSE;
 
@@ -239,6 +243,194 @@ GST_START_TEST (test_videoflip)
 
 GST_END_TEST;
 
+/* Runs a test pattern frame in @format through the @flips bin. The size
+ * avoids line padding so that whole buffers can be compared */
+static GstBuffer *
+flip_frame (const gchar * format, const gchar * flips)
+{
+  GstHarness *h;
+  GstBuffer *buf;
+  gchar *launch;
+
+  h = gst_harness_new_parse (flips);
+  launch = g_strdup_printf ("videotestsrc pattern=smpte "
+      "! video/x-raw,format=%s,width=96,height=152,framerate=25/1", format);
+  gst_harness_add_src_parse (h, launch, TRUE);
+  g_free (launch);
+
+  fail_unless_equals_int (gst_harness_push_from_src (h), GST_FLOW_OK);
+  buf = gst_harness_pull (h);
+  fail_unless (buf != NULL);
+
+  gst_harness_teardown (h);
+
+  return buf;
+}
+
+/* The transposing methods, combined, must give the same result as the
+ * direct methods */
+GST_START_TEST (test_videoflip_transpose)
+{
+  const gchar *formats[] = { "I420", "Y444", "NV12", "GRAY8", "GRAY16_LE",
+    "RGB", "BGRx", "AYUV"
+  };
+  const struct
+  {
+    const gchar *flips;
+    const gchar *expected;
+  } combinations[] = {
+    {"videoflip method=clockwise n-threads=3 "
+          "! videoflip method=clockwise n-threads=3",
+        "videoflip method=rotate-180"},
+    {"videoflip method=counterclockwise "
+          "! videoflip method=counterclockwise n-threads=3",
+        "videoflip method=rotate-180"},
+    {"videoflip method=clockwise n-threads=3 "
+          "! videoflip method=counterclockwise",
+        "videoflip method=none"},
+    {"videoflip method=upper-right-diagonal n-threads=3 "
+          "! videoflip method=upper-right-diagonal n-threads=0",
+        "videoflip method=none"},
+    {"videoflip method=upper-left-diagonal n-threads=3 "
+          "! videoflip method=clockwise",
+        "videoflip method=horizontal-flip"},
+  };
+  guint i, j;
+
+  for (i = 0; i < G_N_ELEMENTS (formats); i++) {
+    for (j = 0; j < G_N_ELEMENTS (combinations); j++) {
+      GstBuffer *flipped, *expected;
+      gchar *what;
+
+      flipped = flip_frame (formats[i], combinations[j].flips);
+      expected = flip_frame (formats[i], combinations[j].expected);
+
+      what = g_strdup_printf ("%s: '%s' vs '%s'", formats[i],
+          combinations[j].flips, combinations[j].expected);
+      assert_buffers_equal (expected, flipped, what);
+      g_free (what);
+
+      gst_buffer_unref (flipped);
+      gst_buffer_unref (expected);
+    }
+  }
+}
+
+GST_END_TEST;
+
+static gint
+compare_u8 (gconstpointer a, gconstpointer b)
+{
+  return *(const guint8 *) a - *(const guint8 *) b;
+}
+
+/* Straightforward median of the pixel at @x, @y as videomedian computes it */
+static guint8
+median_ref (const guint8 * data, gint stride, gint width, gint height,
+    gint x, gint y, gint filtersize, gint radius)
+{
+  guint8 p[(2 * 3 + 1) * (2 * 3 + 1)];
+  gint i, j, n = 0;
+
+  if (radius > 0) {
+    for (j = -radius; j <= radius; j++) {
+      for (i = -radius; i <= radius; i++)
+        p[n++] = data[CLAMP (y + j, 0, height - 1) * stride +
+            CLAMP (x + i, 0, width - 1)];
+    }
+  } else if (x == 0 || y == 0 || x == width - 1 || y == height - 1) {
+    return data[y * stride + x];
+  } else {
+    for (j = -1; j <= 1; j++) {
+      for (i = -1; i <= 1; i++) {
+        if (filtersize == 9 || i == 0 || j == 0)
+          p[n++] = data[(y + j) * stride + x + i];
+      }
+    }
+  }
+
+  qsort (p, n, 1, compare_u8);
+
+  return p[n / 2];
+}
+
+static void
+check_median (gint filtersize, guint radius, guint n_threads)
+{
+  GstHarness *h;
+  GstVideoInfo info;
+  GstVideoFrame in_frame, out_frame;
+  GstBuffer *inbuf, *outbuf, *again;
+  GstMapInfo map;
+  GRand *rand;
+  gint c, x, y;
+  gsize i;
+
+  h = gst_harness_new ("videomedian");
+  gst_util_set_object_arg (G_OBJECT (h->element), "filtersize",
+      filtersize == 5 ? "5" : "9");
+  g_object_set (h->element, "lum-only", FALSE, "radius", radius,
+      "n-threads", n_threads, NULL);
+  gst_harness_set_src_caps_str (h,
+      "video/x-raw,format=I420,width=67,height=70,framerate=25/1");
+
+  gst_video_info_set_format (&info, GST_VIDEO_FORMAT_I420, 67, 70);
+  inbuf = gst_buffer_new_and_alloc (GST_VIDEO_INFO_SIZE (&info));
+  rand = g_rand_new_with_seed (filtersize + radius);
+  gst_buffer_map (inbuf, &map, GST_MAP_WRITE);
+  for (i = 0; i < map.size; i++)
+    map.data[i] = g_rand_int (rand);
+  gst_buffer_unmap (inbuf, &map);
+  g_rand_free (rand);
+
+  outbuf = gst_harness_push_and_pull (h, gst_buffer_ref (inbuf));
+  fail_unless (outbuf != NULL);
+
+  gst_video_frame_map (&in_frame, &info, inbuf, GST_MAP_READ);
+  gst_video_frame_map (&out_frame, &info, outbuf, GST_MAP_READ);
+  for (c = 0; c < 3; c++) {
+    const guint8 *in = GST_VIDEO_FRAME_COMP_DATA (&in_frame, c);
+    const guint8 *out = GST_VIDEO_FRAME_COMP_DATA (&out_frame, c);
+    gint in_stride = GST_VIDEO_FRAME_COMP_STRIDE (&in_frame, c);
+    gint out_stride = GST_VIDEO_FRAME_COMP_STRIDE (&out_frame, c);
+    gint width = GST_VIDEO_FRAME_COMP_WIDTH (&in_frame, c);
+    gint height = GST_VIDEO_FRAME_COMP_HEIGHT (&in_frame, c);
+
+    for (y = 0; y < height; y++) {
+      for (x = 0; x < width; x++) {
+        fail_unless_equals_int (out[y * out_stride + x],
+            median_ref (in, in_stride, width, height, x, y, filtersize,
+                radius));
+      }
+    }
+  }
+  gst_video_frame_unmap (&in_frame);
+  gst_video_frame_unmap (&out_frame);
+
+  /* State kept between frames must not leak into the next one */
+  again = gst_harness_push_and_pull (h, gst_buffer_ref (inbuf));
+  fail_unless (again != NULL);
+  assert_buffers_equal (outbuf, again, "second frame");
+
+  gst_buffer_unref (inbuf);
+  gst_buffer_unref (outbuf);
+  gst_buffer_unref (again);
+  gst_harness_teardown (h);
+}
+
+GST_START_TEST (test_videomedian)
+{
+  check_median (5, 0, 1);
+  check_median (5, 0, 3);
+  check_median (9, 0, 1);
+  check_median (9, 0, 3);
+  check_median (9, 1, 1);
+  check_median (5, 3, 1);
+  check_median (5, 3, 3);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_gamma)
 {
   check_filter ("gamma", 2, NULL);
@@ -257,7 +449,9 @@ videofilter_suite (void)
   suite_add_tcase (s, tc_chain);
   tcase_add_test (tc_chain, test_videobalance);
   tcase_add_test (tc_chain, test_videoflip);
+  tcase_add_test (tc_chain, test_videoflip_transpose);
   tcase_add_test (tc_chain, test_gamma);
+  tcase_add_test (tc_chain, test_videomedian);
 
   return s;
 }
@@ -32,6 +32,9 @@
 #include <gst/check/gstcheck.h>
 #include <gst/check/gstconsistencychecker.h>
 #include <gst/base/gstbasesrc.h>
+#include <gst/video/video.h>
+
+#include "nthreads.h"
 
 #define VIDEO_CAPS_STRING               \
     "video/x-raw, "                 \
@@ -1026,6 +1029,328 @@ GST_START_TEST (test_flush_start_flush_stop)
 GST_END_TEST;
 #endif
 
+static void
+handoff_buffer_cb (GstElement * fakesink, GstBuffer * buffer, GstPad * pad,
+    GList ** buffers)
+{
+  *buffers = g_list_append (*buffers, gst_buffer_ref (buffer));
+}
+
+/* Runs the pipeline described by @desc to EOS and returns the buffers
+ * received by its fakesink "sink". If @stats is not NULL, it is set to the
+ * "stats" of the videomixer "mix" at EOS */
+static GList *
+run_mix (const gchar * desc, GstStructure ** stats)
+{
+  GstElement *pipeline, *sink;
+  GstBus *bus;
+  GstMessage *msg;
+  GList *buffers = NULL;
+
+  pipeline = gst_parse_launch (desc, NULL);
+  fail_unless (pipeline != NULL);
+
+  sink = gst_bin_get_by_name (GST_BIN (pipeline), "sink");
+  g_signal_connect (sink, "handoff", G_CALLBACK (handoff_buffer_cb), &buffers);
+  gst_object_unref (sink);
+
+  fail_unless (gst_element_set_state (pipeline, GST_STATE_PLAYING) !=
+      GST_STATE_CHANGE_FAILURE);
+
+  bus = gst_element_get_bus (pipeline);
+  msg = gst_bus_timed_pop_filtered (bus, GST_CLOCK_TIME_NONE,
+      GST_MESSAGE_EOS | GST_MESSAGE_ERROR);
+  fail_unless_equals_int (GST_MESSAGE_TYPE (msg), GST_MESSAGE_EOS);
+  gst_message_unref (msg);
+  gst_object_unref (bus);
+
+  if (stats) {
+    GstElement *mix = gst_bin_get_by_name (GST_BIN (pipeline), "mix");
+
+    g_object_get (mix, "stats", stats, NULL);
+    gst_object_unref (mix);
+  }
+
+  gst_element_set_state (pipeline, GST_STATE_NULL);
+  gst_object_unref (pipeline);
+
+  return buffers;
+}
+
+/* Mixes @n_inputs overlapping tiles, half of which need converting, and
+ * returns the output buffers */
+static GList *
+mix_tiles (guint n_threads, gpointer user_data)
+{
+  guint n_inputs = GPOINTER_TO_UINT (user_data);
+  GString *desc;
+  GList *buffers;
+  guint i;
+
+  desc = g_string_new (NULL);
+  g_string_append_printf (desc, "videomixer name=mix n-threads=%u ",
+      n_threads);
+  for (i = 0; i < n_inputs; i++)
+    g_string_append_printf (desc, "sink_%u::xpos=%d sink_%u::ypos=%d "
+        "sink_%u::alpha=0.7 ", i, (gint) (i % 4) * 83 - 11, i,
+        (gint) (i / 4) * 61 - 7, i);
+  g_string_append (desc, "! video/x-raw,format=I420,width=320,height=240 ! "
+      "fakesink name=sink signal-handoffs=true ");
+  for (i = 0; i < n_inputs; i++)
+    g_string_append_printf (desc, "videotestsrc num-buffers=3 pattern=%u ! "
+        "video/x-raw,format=%s,width=97,height=75,framerate=25/1 ! mix. ",
+        i % 12, i % 2 ? "AYUV" : "I420");
+
+  buffers = run_mix (desc->str, NULL);
+  g_string_free (desc, TRUE);
+
+  return buffers;
+}
+
+/* Parallel conversion and blending must not change the output */
+GST_START_TEST (test_n_threads)
+{
+  const guint n_inputs[] = { 4, 9, 16 };
+  guint i;
+
+  for (i = 0; i < G_N_ELEMENTS (n_inputs); i++) {
+    GList *out;
+
+    out = check_n_threads_output (mix_tiles,
+        GUINT_TO_POINTER (n_inputs[i]), 4, "tiles");
+    fail_unless_equals_int (g_list_length (out), 3);
+    g_list_free_full (out, (GDestroyNotify) gst_buffer_unref);
+  }
+}
+
+GST_END_TEST;
+
+static guint8
+get_comp (GstVideoFrame * frame, guint comp, gint x, gint y)
+{
+  const guint8 *data = GST_VIDEO_FRAME_COMP_DATA (frame, comp);
+
+  return data[y * GST_VIDEO_FRAME_COMP_STRIDE (frame, comp) +
+      x * GST_VIDEO_FRAME_COMP_PSTRIDE (frame, comp)];
+}
+
+/* Mixes two opaque white rectangles on black, one of which needs converting
+ * from AYUV */
+static GList *
+mix_rectangles (guint n_threads, gpointer user_data)
+{
+  GList *buffers;
+  gchar *desc;
+
+  desc = g_strdup_printf ("videomixer name=mix background=black "
+      "n-threads=%u sink_0::xpos=36 sink_0::ypos=90 "
+      "sink_1::xpos=180 sink_1::ypos=150 "
+      "! video/x-raw,format=I420,width=320,height=240 "
+      "! fakesink name=sink signal-handoffs=true "
+      "videotestsrc num-buffers=1 pattern=white "
+      "! video/x-raw,format=I420,width=100,height=60,framerate=25/1 ! mix. "
+      "videotestsrc num-buffers=1 pattern=white "
+      "! video/x-raw,format=AYUV,width=100,height=60,framerate=25/1 ! mix. ",
+      n_threads);
+  buffers = run_mix (desc, NULL);
+  g_free (desc);
+
+  return buffers;
+}
+
+/* The bands mixed on different threads must end up in the right place */
+GST_START_TEST (test_n_threads_values)
+{
+  GstVideoInfo info;
+  GstVideoFrame frame;
+  GList *out;
+  gint x, y;
+
+  out = check_n_threads_output (mix_rectangles, NULL, 4, "rectangles");
+  fail_unless_equals_int (g_list_length (out), 1);
+
+  gst_video_info_set_format (&info, GST_VIDEO_FORMAT_I420, 320, 240);
+  fail_unless (gst_video_frame_map (&frame, &info, out->data, GST_MAP_READ));
+  for (y = 0; y < 240; y++) {
+    for (x = 0; x < 320; x++) {
+      gboolean inside = (x >= 36 && x < 136 && y >= 90 && y < 150) ||
+          (x >= 180 && x < 280 && y >= 150 && y < 210);
+
+      fail_unless_equals_int (get_comp (&frame, 0, x, y), inside ? 235 : 16);
+    }
+  }
+  for (y = 0; y < 120; y++) {
+    for (x = 0; x < 160; x++) {
+      fail_unless_equals_int (get_comp (&frame, 1, x, y), 128);
+      fail_unless_equals_int (get_comp (&frame, 2, x, y), 128);
+    }
+  }
+  gst_video_frame_unmap (&frame);
+
+  g_list_free_full (out, (GDestroyNotify) gst_buffer_unref);
+}
+
+GST_END_TEST;
+
+/* An opaque input covering the whole frame hides everything below it */
+GST_START_TEST (test_hidden_inputs)
+{
+  GstStructure *stats;
+  GList *buffers;
+  guint64 blended, filled;
+  guint hidden;
+
+  buffers = run_mix ("videomixer name=mix "
+      "! video/x-raw,format=I420,width=320,height=240 "
+      "! fakesink name=sink signal-handoffs=true "
+      "videotestsrc num-buffers=3 pattern=ball "
+      "! video/x-raw,format=I420,width=160,height=120,framerate=25/1 ! mix. "
+      "videotestsrc num-buffers=3 "
+      "! video/x-raw,format=I420,width=320,height=240,framerate=25/1 ! mix. ",
+      &stats);
+  fail_unless_equals_int (g_list_length (buffers), 3);
+
+  fail_unless (gst_structure_get (stats, "pixels-blended", G_TYPE_UINT64,
+          &blended, "pixels-filled", G_TYPE_UINT64, &filled, "inputs-hidden",
+          G_TYPE_UINT, &hidden, NULL));
+  fail_unless_equals_uint64 (blended, 320 * 240);
+  fail_unless_equals_uint64 (filled, 0);
+  fail_unless_equals_int (hidden, 1);
+
+  gst_structure_free (stats);
+  g_list_free_full (buffers, (GDestroyNotify) gst_buffer_unref);
+}
+
+GST_END_TEST;
+
+/* Mixes a moving ball above a still image, which is either redrawn for every
+ * frame or copied from the previous output */
+static GList *
+mix_still (gboolean reuse, GstStructure ** stats)
+{
+  gchar *desc;
+  GList *buffers;
+
+  desc = g_strdup_printf ("videomixer name=mix reuse-unchanged=%d "
+      "sink_1::ypos=64 "
+      "! video/x-raw,format=I420,width=320,height=240 "
+      "! fakesink name=sink signal-handoffs=true "
+      "videotestsrc num-buffers=5 pattern=ball "
+      "! video/x-raw,format=I420,width=320,height=64,framerate=25/1 ! mix. "
+      "videotestsrc num-buffers=1 pattern=smpte ! imagefreeze num-buffers=5 "
+      "! video/x-raw,format=I420,width=320,height=176,framerate=25/1 ! mix. ",
+      reuse);
+  buffers = run_mix (desc, stats);
+  g_free (desc);
+
+  return buffers;
+}
+
+GST_START_TEST (test_reuse_unchanged)
+{
+  GstStructure *stats;
+  GList *redrawn, *reused;
+  guint64 pixels_reused;
+
+  redrawn = mix_still (FALSE, NULL);
+  reused = mix_still (TRUE, &stats);
+
+  fail_unless_equals_int (g_list_length (redrawn), 5);
+  assert_buffer_lists_equal (redrawn, reused, "reused stripes");
+
+  /* Only the stripe with the ball is redrawn */
+  fail_unless (gst_structure_get_uint64 (stats, "pixels-reused",
+          &pixels_reused));
+  fail_unless (pixels_reused > 0);
+  fail_unless (pixels_reused <= 320 * 176);
+
+  gst_structure_free (stats);
+  g_list_free_full (redrawn, (GDestroyNotify) gst_buffer_unref);
+  g_list_free_full (reused, (GDestroyNotify) gst_buffer_unref);
+}
+
+GST_END_TEST;
+
+/* Checks that @frame only contains the @background with the given name */
+static void
+check_background (GstVideoFrame * frame, const gchar * background)
+{
+  static const guint8 tab[] = { 80, 160, 80, 160 };
+  const GstVideoFormatInfo *finfo = frame->info.finfo;
+  gboolean rgb = GST_VIDEO_FORMAT_INFO_IS_RGB (finfo);
+  guint comp;
+  gint x, y;
+
+  for (comp = 0; comp < GST_VIDEO_FORMAT_INFO_N_COMPONENTS (finfo); comp++) {
+    for (y = 0; y < GST_VIDEO_FRAME_COMP_HEIGHT (frame, comp); y++) {
+      for (x = 0; x < GST_VIDEO_FRAME_COMP_WIDTH (frame, comp); x++) {
+        guint8 value = get_comp (frame, comp, x, y), expected;
+
+        if (comp == GST_VIDEO_COMP_A) {
+          expected = 255;
+        } else if (!rgb && comp != GST_VIDEO_COMP_Y) {
+          expected = 128;
+        } else if (g_str_equal (background, "checker")) {
+          /* The packed 4:2:2 checker is counted in macropixels */
+          gint cx = GST_VIDEO_FORMAT_INFO_IS_YUV (finfo)
+              && GST_VIDEO_FORMAT_INFO_PSTRIDE (finfo, 0) == 2 ? x / 2 : x;
+
+          expected = tab[((y & 0x8) >> 3) + ((cx & 0x8) >> 3)];
+        } else if (g_str_equal (background, "black")) {
+          expected = rgb ? 0 : 16;
+        } else {
+          expected = rgb ? 255 : 240;
+        }
+
+        fail_unless_equals_int (value, expected);
+      }
+    }
+  }
+}
+
+/* The background fills must give the same result for every output format,
+ * whichever of their lines are drawn and which are copied */
+GST_START_TEST (test_background_fill)
+{
+  const gchar *formats[] = { "AYUV", "BGRA", "ARGB", "RGBA", "ABGR", "Y444",
+    "Y42B", "YUY2", "UYVY", "YVYU", "I420", "YV12", "NV12", "NV21", "Y41B",
+    "RGB", "BGR", "xRGB", "xBGR", "RGBx", "BGRx"
+  };
+  const gchar *backgrounds[] = { "checker", "black", "white" };
+  guint i, j;
+
+  for (i = 0; i < G_N_ELEMENTS (formats); i++) {
+    for (j = 0; j < G_N_ELEMENTS (backgrounds); j++) {
+      GstVideoInfo info;
+      GstVideoFrame frame;
+      GList *buffers;
+      gchar *desc;
+
+      /* A fully transparent input leaves only the background */
+      desc = g_strdup_printf ("videomixer name=mix background=%s "
+          "sink_0::alpha=0 ! video/x-raw,format=%s,width=44,height=35 "
+          "! fakesink name=sink signal-handoffs=true "
+          "videotestsrc num-buffers=1 "
+          "! video/x-raw,format=AYUV,width=16,height=16 ! mix. ",
+          backgrounds[j], formats[i]);
+      buffers = run_mix (desc, NULL);
+      g_free (desc);
+
+      fail_unless_equals_int (g_list_length (buffers), 1);
+      gst_video_info_set_format (&info,
+          gst_video_format_from_string (formats[i]), 44, 35);
+      fail_unless (gst_video_frame_map (&frame, &info, buffers->data,
+              GST_MAP_READ));
+      check_background (&frame, backgrounds[j]);
+      gst_video_frame_unmap (&frame);
+
+      g_list_free_full (buffers, (GDestroyNotify) gst_buffer_unref);
+    }
+  }
+}
+
+GST_END_TEST;
+
 static Suite *
 videomixer_suite (void)
 {
@@ -1043,6 +1368,11 @@ videomixer_suite (void)
   tcase_add_test (tc_chain, test_duration_is_max);
   tcase_add_test (tc_chain, test_duration_unknown_overrides);
   tcase_add_test (tc_chain, test_loop);
+  tcase_add_test (tc_chain, test_n_threads);
+  tcase_add_test (tc_chain, test_n_threads_values);
+  tcase_add_test (tc_chain, test_hidden_inputs);
+  tcase_add_test (tc_chain, test_reuse_unchanged);
+  tcase_add_test (tc_chain, test_background_fill);
   /* This test is racy and occasionally fails in interesting ways
    * just like the corresponding adder test does/did, see
    * https://bugzilla.gnome.org/show_bug.cgi?id=708891